@@ -0,0 +1,100 @@
+/**
+ * @file impulse_kernel_bench.cc
+ *
+ * @copyright 2018 3081 Staff, All rights reserved.
+ *
+ * Sensing cost: every light sensor of every robot against every light, one
+ * sensor at a time through Sensor::ReceiveInfo() versus all at once through
+ * ComputeImpulses(). Arguments are robots, lights.
+ */
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <benchmark/benchmark.h>
+#include <random>
+#include <vector>
+
+#include "src/impulse_kernel.h"
+#include "src/light.h"
+#include "src/sensor.h"
+
+/*******************************************************************************
+ * Non-Member Functions
+ ******************************************************************************/
+// Each robot has a left and a right light sensor.
+static const int kSensorsPerRobot = 2;
+
+static void RandomPoints(size_t n, unsigned seed, std::vector<double> *x,
+                         std::vector<double> *y) {
+  std::mt19937 rng(seed);
+  std::uniform_real_distribution<double> dist_x(0.0, 1024.0);
+  std::uniform_real_distribution<double> dist_y(0.0, 768.0);
+  x->resize(n);
+  y->resize(n);
+  for (size_t i = 0; i < n; ++i) {
+    (*x)[i] = dist_x(rng);
+    (*y)[i] = dist_y(rng);
+  }
+}
+
+static void BM_ReceiveInfoPerSensor(benchmark::State &state) {
+  size_t n_sensors = state.range(0) * kSensorsPerRobot;
+  size_t n_lights = state.range(1);
+  std::vector<double> sensor_x, sensor_y, light_x, light_y;
+  RandomPoints(n_sensors, 1, &sensor_x, &sensor_y);
+  RandomPoints(n_lights, 2, &light_x, &light_y);
+
+  std::vector<csci3081::ArenaEntity *> lights;
+  for (size_t i = 0; i < n_lights; ++i) {
+    lights.push_back(new csci3081::Light());
+    lights.back()->set_position(light_x[i], light_y[i]);
+  }
+  std::vector<csci3081::Sensor> sensors(
+    n_sensors, csci3081::Sensor(LEFT, csci3081::kLight));
+  for (size_t s = 0; s < n_sensors; ++s) {
+    sensors[s].set_pose({sensor_x[s], sensor_y[s]});
+  }
+
+  for (auto _ : state) {
+    for (auto &sensor : sensors) {
+      sensor.ReceiveInfo(lights);
+    }
+    benchmark::DoNotOptimize(sensors.back().get_impulse());
+  }
+  state.SetItemsProcessed(state.iterations() * n_sensors * n_lights);
+  for (auto &light : lights) {
+    delete light;
+  }
+}
+
+static void BM_ComputeImpulses(benchmark::State &state,
+                               csci3081::ImpulseKernelIsa isa) {
+  size_t n_sensors = state.range(0) * kSensorsPerRobot;
+  size_t n_lights = state.range(1);
+  std::vector<double> sensor_x, sensor_y, light_x, light_y;
+  RandomPoints(n_sensors, 1, &sensor_x, &sensor_y);
+  RandomPoints(n_lights, 2, &light_x, &light_y);
+  std::vector<double> intensity(n_lights, 1200.0);
+  std::vector<double> impulse(n_sensors);
+
+  for (auto _ : state) {
+    csci3081::ComputeImpulses(sensor_x.data(), sensor_y.data(), n_sensors,
+                              light_x.data(), light_y.data(),
+                              intensity.data(), n_lights, impulse.data(),
+                              isa);
+    benchmark::DoNotOptimize(impulse.data());
+  }
+  state.SetItemsProcessed(state.iterations() * n_sensors * n_lights);
+  state.SetLabel(
+    csci3081::ResolveImpulseKernel(isa) == isa ? "" : "unsupported, fell back");
+}
+
+BENCHMARK(BM_ReceiveInfoPerSensor)
+  ->Args({1000, 100})->Args({100, 1000})->Args({10000, 100});
+BENCHMARK_CAPTURE(BM_ComputeImpulses, scalar, csci3081::kScalarKernel)
+  ->Args({1000, 100})->Args({100, 1000})->Args({10000, 100});
+BENCHMARK_CAPTURE(BM_ComputeImpulses, sse2, csci3081::kSse2Kernel)
+  ->Args({1000, 100})->Args({100, 1000})->Args({10000, 100});
+BENCHMARK_CAPTURE(BM_ComputeImpulses, avx2, csci3081::kAvx2Kernel)
+  ->Args({1000, 100})->Args({100, 1000})->Args({10000, 100});
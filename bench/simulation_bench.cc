@@ -0,0 +1,203 @@
+/**
+ * @file simulation_bench.cc
+ *
+ * @copyright 2018 3081 Staff, All rights reserved.
+ *
+ * Cost of the simulation's hot paths, from single calls (sensing, pose and
+ * velocity updates, collision tests) up to a full Arena timestep. Every
+ * Arena is built from a fixed seed, so runs of the same build are
+ * comparable. The argument is the # of entities (or robots) involved.
+ */
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <benchmark/benchmark.h>
+#include <utility>
+#include <vector>
+
+#include "src/arena.h"
+#include "src/arena_params.h"
+#include "src/entity_store.h"
+#include "src/light.h"
+#include "src/motion_behavior_differential.h"
+#include "src/motion_handler.h"
+#include "src/robot.h"
+#include "src/sensor.h"
+
+/*******************************************************************************
+ * Non-Member Functions
+ ******************************************************************************/
+static const uint64_t kSeed = 3081;
+
+// An Arena with `n_robots` robots and one light and one food per ten robots.
+static csci3081::arena_params SeededParams(size_t n_robots) {
+  csci3081::arena_params params;
+  params.n_robots = n_robots;
+  params.n_lights = n_robots / 10 + 1;
+  params.n_foods = n_robots / 10 + 1;
+  params.seed = kSeed;
+  return params;
+}
+
+static void BM_SensorReceiveInfo(benchmark::State &state) {
+  csci3081::arena_params params = SeededParams(0);
+  params.n_lights = state.range(0);
+  csci3081::Arena arena(&params);
+  csci3081::Sensor sensor(LEFT, csci3081::kLight);
+  sensor.set_pose({512.0, 384.0});
+  for (auto _ : state) {
+    sensor.ReceiveInfo(arena.get_entities());
+    benchmark::DoNotOptimize(sensor.get_impulse());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void BM_SensorCalcPose(benchmark::State &state) {
+  csci3081::arena_params params = SeededParams(state.range(0));
+  csci3081::Arena arena(&params);
+  int64_t n_sensors = 0;
+  for (auto &robot : arena.get_robots()) {
+    n_sensors += robot->get_sensors().size();
+  }
+  for (auto _ : state) {
+    for (auto &robot : arena.get_robots()) {
+      for (auto &sensor : robot->get_sensors()) {
+        benchmark::DoNotOptimize(
+          sensor->CalcPose(robot->get_pose(), robot->get_radius()));
+      }
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * n_sensors);
+}
+
+static void BM_MotionBehaviorUpdatePose(benchmark::State &state) {
+  csci3081::arena_params params = SeededParams(0);
+  params.n_lights = state.range(0);
+  csci3081::Arena arena(&params);
+  std::vector<csci3081::MotionBehaviorDifferential> behaviors;
+  for (auto &ent : arena.get_mobile_entities()) {
+    behaviors.emplace_back(ent);
+  }
+  csci3081::WheelVelocity vel(4.0, 5.0);
+  for (auto _ : state) {
+    for (auto &behavior : behaviors) {
+      behavior.UpdatePose(1, vel);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void BM_MotionHandlerHandleImpulse(benchmark::State &state) {
+  csci3081::arena_params params = SeededParams(0);
+  params.n_lights = state.range(0);
+  csci3081::Arena arena(&params);
+  std::vector<csci3081::MotionHandler> handlers;
+  for (auto &ent : arena.get_mobile_entities()) {
+    handlers.emplace_back(ent);
+  }
+  double impulse = 0.0;
+  for (auto _ : state) {
+    for (auto &handler : handlers) {
+      handler.HandleImpulse(impulse, EXPLORATION, LEFT);
+      handler.HandleImpulse(impulse, FEAR, RIGHT);
+    }
+    impulse = (impulse < 10.0) ? impulse + 0.5 : 0.0;
+    benchmark::DoNotOptimize(handlers.back().get_velocity());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0) * 2);
+}
+
+// Every robot against every entity: the brute-force narrow phase.
+static void BM_ArenaIsColliding(benchmark::State &state) {
+  csci3081::arena_params params = SeededParams(state.range(0));
+  csci3081::Arena arena(&params);
+  int64_t n_tests = 0;
+  for (auto _ : state) {
+    int n_colliding = 0;
+    for (auto &robot : arena.get_robots()) {
+      for (auto &ent : arena.get_entities()) {
+        if (robot != ent && arena.IsColliding(robot, ent)) {
+          ++n_colliding;
+        }
+      }
+    }
+    benchmark::DoNotOptimize(n_colliding);
+    n_tests += arena.get_robots().size() * arena.get_entities().size();
+  }
+  state.SetItemsProcessed(n_tests);
+}
+
+// Each robot is put back on top of its neighbour before being pushed off it,
+// so every call does the full adjustment. The reset is part of the time.
+static void BM_ArenaAdjustEntityOverlap(benchmark::State &state) {
+  csci3081::arena_params params = SeededParams(state.range(0));
+  csci3081::Arena arena(&params);
+  const std::vector<csci3081::Robot *> &robots = arena.get_robots();
+  std::vector<std::pair<csci3081::Robot *, csci3081::Pose>> overlaps;
+  for (size_t i = 0; i + 1 < robots.size(); i += 2) {
+    csci3081::Pose pose = robots[i + 1]->get_pose();
+    pose.x += 1.0;
+    overlaps.emplace_back(robots[i], pose);
+  }
+  for (auto _ : state) {
+    for (size_t k = 0; k < overlaps.size(); ++k) {
+      overlaps[k].first->set_pose(overlaps[k].second);
+      arena.AdjustEntityOverlap(overlaps[k].first, robots[2 * k + 1]);
+    }
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * overlaps.size());
+}
+
+// Left alone the robots get hungry, then starve and end the game, so what a
+// step does would depend on how many the framework runs. Every
+// kStepsPerArena steps, well before the first robot gets hungry, the Arena
+// is rebuilt from the seed outside the timed region.
+static const int kStepsPerArena = 200;
+
+static void BM_ArenaUpdateEntitiesTimestep(benchmark::State &state) {
+  csci3081::arena_params params = SeededParams(state.range(0));
+  csci3081::Arena *arena = new csci3081::Arena(&params);
+  int steps = 0;
+  for (auto _ : state) {
+    if (steps == kStepsPerArena) {
+      state.PauseTiming();
+      delete arena;
+      arena = new csci3081::Arena(&params);
+      steps = 0;
+      state.ResumeTiming();
+    }
+    arena->UpdateEntitiesTimestep();
+    ++steps;
+  }
+  state.SetItemsProcessed(state.iterations() * arena->get_entities().size());
+  delete arena;
+}
+
+// The Arena refreshes its EntityStore from the entities twice per step: the
+// lights and foods before sensing, the robots and lights before collisions.
+static void BM_EntityStoreGather(benchmark::State &state) {
+  csci3081::arena_params params = SeededParams(state.range(0));
+  csci3081::Arena arena(&params);
+  const std::vector<csci3081::ArenaEntity *> &entities = arena.get_entities();
+  csci3081::EntityStore store;
+  store.Build(entities);
+  for (auto _ : state) {
+    store.Gather(entities, {store.lights().begin, store.foods().end});
+    store.Gather(entities, store.mobiles());
+    benchmark::DoNotOptimize(store.x());
+  }
+  state.SetItemsProcessed(state.iterations() * entities.size());
+}
+
+BENCHMARK(BM_SensorReceiveInfo)->Arg(10)->Arg(100)->Arg(1000);
+BENCHMARK(BM_SensorCalcPose)->Arg(100)->Arg(1000)->Arg(10000);
+BENCHMARK(BM_MotionBehaviorUpdatePose)->Arg(100)->Arg(1000)->Arg(10000);
+BENCHMARK(BM_MotionHandlerHandleImpulse)->Arg(100)->Arg(1000)->Arg(10000);
+BENCHMARK(BM_ArenaIsColliding)->Arg(10)->Arg(100)->Arg(1000);
+BENCHMARK(BM_ArenaAdjustEntityOverlap)->Arg(100)->Arg(1000)->Arg(10000);
+BENCHMARK(BM_ArenaUpdateEntitiesTimestep)
+  ->Arg(10)->Arg(100)->Arg(1000)->Arg(10000)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_EntityStoreGather)
+  ->Arg(10)->Arg(100)->Arg(1000)->Arg(10000)->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,69 @@
+/**
+ * @file alloc_counter.cc
+ *
+ * @copyright 2018 3081 Staff, All rights reserved.
+ */
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#include "src/alloc_counter.h"
+
+/*******************************************************************************
+ * Static Variables
+ ******************************************************************************/
+#ifdef ARENA_ALLOC_COUNTING
+static std::atomic<uint64_t> g_n_allocations(0);
+static std::atomic<uint64_t> g_n_bytes(0);
+
+/*******************************************************************************
+ * Replacement Allocation Functions
+ ******************************************************************************/
+static void *CountedAlloc(size_t size) {
+  g_n_allocations.fetch_add(1, std::memory_order_relaxed);
+  g_n_bytes.fetch_add(size, std::memory_order_relaxed);
+  void *ptr = std::malloc(size != 0 ? size : 1);
+  if (ptr == nullptr) {
+    throw std::bad_alloc();
+  }
+  return ptr;
+}
+
+void *operator new(size_t size) { return CountedAlloc(size); }
+void *operator new[](size_t size) { return CountedAlloc(size); }
+void operator delete(void *ptr) noexcept { std::free(ptr); }
+void operator delete[](void *ptr) noexcept { std::free(ptr); }
+void operator delete(void *ptr, size_t) noexcept { std::free(ptr); }
+void operator delete[](void *ptr, size_t) noexcept { std::free(ptr); }
+#endif  // ARENA_ALLOC_COUNTING
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+NAMESPACE_BEGIN(csci3081);
+
+/*******************************************************************************
+ * Non-Member Functions
+ ******************************************************************************/
+bool AllocCountingEnabled() {
+#ifdef ARENA_ALLOC_COUNTING
+  return true;
+#else
+  return false;
+#endif
+}
+
+alloc_stats GetAllocStats() {
+  alloc_stats stats;
+#ifdef ARENA_ALLOC_COUNTING
+  stats.n_allocations = g_n_allocations.load(std::memory_order_relaxed);
+  stats.n_bytes = g_n_bytes.load(std::memory_order_relaxed);
+#endif
+  return stats;
+}
+
+NAMESPACE_END(csci3081);
@@ -0,0 +1,54 @@
+/**
+ * @file alloc_counter.h
+ *
+ * @copyright 2018 3081 Staff, All rights reserved.
+ */
+
+#ifndef SRC_ALLOC_COUNTER_H_
+#define SRC_ALLOC_COUNTER_H_
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <cstdint>
+
+#include "src/common.h"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+NAMESPACE_BEGIN(csci3081);
+
+/*******************************************************************************
+ * Structure Definitions
+ ******************************************************************************/
+/**
+ * @brief Heap allocations made through operator new since the program
+ * started, on any thread.
+ */
+struct alloc_stats {
+  uint64_t n_allocations{0};
+  uint64_t n_bytes{0};
+};
+
+/*******************************************************************************
+ * Non-Member Functions
+ ******************************************************************************/
+/**
+ * @brief Whether allocations are being counted.
+ *
+ * Counting is a debugging aid: it is compiled in only when the project is
+ * built with -DARENA_ALLOC_COUNTING, which replaces the global operator
+ * new/delete. Otherwise GetAllocStats() always returns zeros.
+ */
+bool AllocCountingEnabled();
+
+/**
+ * @brief The allocations counted so far. Take the difference of two calls to
+ * measure a section of code.
+ */
+alloc_stats GetAllocStats();
+
+NAMESPACE_END(csci3081);
+
+#endif  // SRC_ALLOC_COUNTER_H_
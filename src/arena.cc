@@ -8,6 +8,8 @@
  * Includes
  ******************************************************************************/
 #include <algorithm>
+#include <cmath>
+#include <ctime>
 #include <iostream>
 
 #include "src/arena.h"
@@ -21,61 +23,150 @@ NAMESPACE_BEGIN(csci3081);
 /*******************************************************************************
  * Constructors/Destructor
  ******************************************************************************/
-Arena::Arena(const struct arena_params *const params)
+Arena::Arena(const struct arena_params *const params,
+             const std::atomic<bool> *cancel, const entity_state *states)
     : x_dim_(params->x_dim),
       y_dim_(params->y_dim),
-      factory_(new EntityFactory),
+      factory_(new EntityFactory(&rng_)),
       params_(),
+      broad_phase_(BroadPhase::Create(params->broad_phase)),
+      thread_pool_(new ThreadPool(params->n_threads)),
+      collision_pairs_(),
       sensors_(),
+      n_light_sensors_(0),
+      sensor_x_(),
+      sensor_y_(),
+      sensor_impulse_(),
       robots_(),
       entities_(),
+      store_(),
       mobile_entities_(),
+      clock_(),
+      profiler_(),
+      rng_(params->seed != 0 ? params->seed
+                             : static_cast<uint64_t>(time(nullptr))),
+      light_cutoff_(),
+      food_cutoff_(),
+      commands_(COMMAND_QUEUE_CAPACITY),
+      cancel_build_(cancel),
       game_status_(),
       f_e_ratio_() {
   set_params(*params);
-  AddRobots(kRobot, params->n_robots);
-  AddEntity(kFood, params->n_foods);
-  AddEntity(kLight, params->n_lights);
+  factory_->set_arena_size(static_cast<int>(x_dim_), static_cast<int>(y_dim_));
+  if (states != nullptr) {
+    LoadEntities(states, params->n_robots, params->n_lights,
+                 params->n_foods);
+  } else {
+    AddEntities(params->n_robots, params->n_lights, params->n_foods);
+  }
+  light_cutoff_.type = kLight;
+  food_cutoff_.type = kFood;
   set_game_status(PLAYING);
+  cancel_build_ = nullptr;
 }
 
 Arena::~Arena() {
   for (auto &ent : entities_) {
     delete ent;
   } /* for(ent..) */
+  delete factory_;
+  delete broad_phase_;
+  delete thread_pool_;
 }
 
 /*******************************************************************************
  * Member Functions
  ******************************************************************************/
 void Arena::AddRobots(EntityType type, int quantity) {
-  for (int i = 0; i < quantity; i++) {
-    entities_.push_back(factory_->CreateEntity(type));
+  CreateEntities(type, static_cast<size_t>(std::max(quantity, 0)));
+  PartitionEntities();
+}
+
+void Arena::AddEntity(EntityType type, int quantity) {
+  CreateEntities(type, static_cast<size_t>(std::max(quantity, 0)));
+  PartitionEntities();
+}
+
+void Arena::AddEntities(size_t n_robots, size_t n_lights, size_t n_foods) {
+  entities_.reserve(entities_.size() + n_robots + n_lights + n_foods);
+  robots_.reserve(robots_.size() + n_robots);
+  mobile_entities_.reserve(mobile_entities_.size() + n_robots + n_lights);
+  // Foods before lights, so that a seed places entities as it always has.
+  CreateEntities(kRobot, n_robots);
+  CreateEntities(kFood, n_foods);
+  CreateEntities(kLight, n_lights);
+  PartitionEntities();
+}
+
+void Arena::CreateEntities(EntityType type, size_t quantity) {
+  for (size_t i = 0; i < quantity && !BuildCancelled(); i++) {
+    InsertEntity(factory_->CreateEntity(type));
   }
-  for (auto &ent : entities_) {
-    if (ent->get_type() == kRobot) {
-      robots_.push_back(static_cast<Robot*> (ent));
-      mobile_entities_.push_back(static_cast<Robot*> (ent));
-    }
+}
+
+void Arena::LoadEntities(const entity_state *states, size_t n_robots,
+                         size_t n_lights, size_t n_foods) {
+  size_t n = n_robots + n_lights + n_foods;
+  entities_.reserve(n);
+  robots_.reserve(n_robots);
+  mobile_entities_.reserve(n_robots + n_lights);
+  for (size_t i = 0; i < n; i++) {
+    InsertEntity(factory_->LoadEntity(states[i]));
   }
+  PartitionEntities();
 }
 
-void Arena::AddEntity(EntityType type, int quantity) {
-  for (int i = 0; i < quantity; i++) {
-    entities_.push_back(factory_->CreateEntity(type));
+void Arena::InsertEntity(ArenaEntity *ent) {
+  ent->set_clock(&clock_);
+  entities_.push_back(ent);
+  if (ent->get_type() == kRobot) {
+    robots_.push_back(static_cast<Robot*> (ent));
+    mobile_entities_.push_back(static_cast<Robot*> (ent));
+  } else if (ent->get_type() == kLight) {
+    mobile_entities_.push_back(static_cast<Light*> (ent));
   }
-  for (auto &ent : entities_) {
-    if (ent->get_type() == kLight) {
-      mobile_entities_.push_back(static_cast<Light*> (ent));
+}
+
+void Arena::PartitionEntities() {
+  // Two stable partitions rather than a sort keep this linear.
+  auto lights_begin = std::stable_partition(
+    entities_.begin(), entities_.end(),
+    [](const ArenaEntity *ent) { return ent->get_type() == kRobot; });
+  std::stable_partition(
+    lights_begin, entities_.end(),
+    [](const ArenaEntity *ent) { return ent->get_type() == kLight; });
+  store_.Build(entities_);
+  // Room for a few contacts per entity up front, so that a crowded step
+  // rarely has to grow the pair list.
+  collision_pairs_.reserve(4 * entities_.size());
+
+  // Group the sensors by what they sense, for the batched impulse kernel.
+  sensors_.clear();
+  sensors_.reserve(4 * robots_.size());
+  for (EntityType type : {kLight, kFood}) {
+    for (auto &robot : robots_) {
+      for (auto &sensor : robot->get_sensors()) {
+        if (sensor->get_receiver_type() == type) {
+          sensors_.push_back(sensor);
+        }
+      }
+    }
+    if (type == kLight) {
+      n_light_sensors_ = sensors_.size();
     }
   }
+  sensor_x_.resize(sensors_.size());
+  sensor_y_.resize(sensors_.size());
+  sensor_impulse_.resize(sensors_.size());
 }
 
 void Arena::Reset() {
+  clock_.Reset();
   for (auto ent : entities_) {
     ent->Reset();
   }
   set_game_status(PLAYING);
+  n_collisions_ = 0;
   /* for(ent..) */
 } /* reset() */
 
@@ -85,41 +176,122 @@ void Arena::AdvanceTime(double dt) {
   if (!(dt > 0)) {
     return;
   }
-  for (size_t i = 0; i < 1; ++i) {
-    UpdateEntitiesTimestep();
-  } /* for(i..) */
+  StepN(SimClock::ToTicks(dt));
 } /* AdvanceTime() */
 
+uint64_t Arena::StepN(uint64_t n_steps) {
+  uint64_t steps = 0;
+  while (steps < n_steps && get_game_status() != LOST) {
+    UpdateEntitiesTimestep();
+    ++steps;
+  }
+  return steps;
+} /* StepN() */
+
 void Arena::UpdateEntitiesTimestep() {
+  ScopedStepTimer step_timer(&profiler_);
+  {
+    ScopedPhaseTimer timer(&profiler_, kPhaseCommands);
+    ApplyCommands();
+    clock_.Advance();
+  }
+
   /*
    * First, update the position of all entities, according to their current
    * velocities.
    *
    */
-  for (auto &robot : robots_) {
-    if (robot->get_id() > static_cast<int>(robots_.size()*get_f_e_ratio())) {
-      robot->set_l_behavior(EXPLORATION);
-    } else {
-      robot->set_l_behavior(FEAR);
-    }
+  {
+    ScopedPhaseTimer timer(&profiler_, kPhaseBehavior);
+    int n_fear = static_cast<int>(robots_.size()*get_f_e_ratio());
+    thread_pool_->ParallelFor(robots_.size(),
+      [this, n_fear](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+          if (robots_[i]->get_id() > n_fear) {
+            robots_[i]->set_l_behavior(EXPLORATION);
+          } else {
+            robots_[i]->set_l_behavior(FEAR);
+          }
+        }
+      });
   }
 
-  for (auto &ent : entities_) {
-    if (ent->get_type() == kRobot && static_cast<Robot*> (ent)->is_starved()) {
-      set_game_status(LOST);
+  {
+    ScopedPhaseTimer timer(&profiler_, kPhaseStarvation);
+    for (auto &robot : robots_) {
+      if (robot->is_starved()) {
+        set_game_status(LOST);
+      }
     }
   }
 
-  for (auto ent : entities_) {
-    ent->TimestepUpdate(1);
+  // Each entity reads and writes only its own state here.
+  {
+    ScopedPhaseTimer timer(&profiler_, kPhaseTimestep);
+    thread_pool_->ParallelFor(entities_.size(),
+      [this](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+          entities_[i]->TimestepUpdate(1);
+        }
+      });
   }
 
-  for (auto &robot : robots_) {
-    for (auto &sensor : robot->get_sensors()) {
-      sensor->ReceiveInfo(entities_);
-    }
+  // The sensors only need the new positions of the lights and foods. Each
+  // sensor reads the store and writes only its own impulse.
+  {
+    ScopedPhaseTimer timer(&profiler_, kPhaseSensing);
+    GatherStore({store_.lights().begin, store_.foods().end});
+    UpdateSensingCutoffs();
+    SenseEmitters(light_cutoff_);
+    SenseEmitters(food_cutoff_);
   }
 
+  ScopedPhaseTimer timer(&profiler_, kPhaseCollisions);
+  collision_events_.clear();
+  if (broad_phase_ == nullptr) {
+    UpdateCollisionsBruteForce();
+  } else {
+    UpdateCollisionsBroadPhase();
+  }
+}  // UpdateEntitiesTimestep()
+
+void Arena::SaveState(arena_state *state) const {
+  state->x_dim = x_dim_;
+  state->y_dim = y_dim_;
+  state->sensing_error = params_.sensing_error;
+  state->n_robots = robots_.size();
+  state->n_lights = store_.lights().size();
+  state->n_foods = store_.foods().size();
+  state->seed = params_.seed;
+  state->ticks = clock_.get_ticks();
+  state->rng_state = rng_.get_state();
+  state->n_collisions = n_collisions_;
+  state->broad_phase = params_.broad_phase;
+  state->n_threads = get_n_threads();
+  state->game_status = game_status_;
+  state->f_e_ratio = f_e_ratio_;
+  state->paused = paused_;
+}
+
+void Arena::LoadState(const arena_state &state) {
+  BroadPhaseType broad_phase = static_cast<BroadPhaseType>(state.broad_phase);
+  if (broad_phase != params_.broad_phase) {
+    // The broad phase decides the order collisions are resolved in.
+    delete broad_phase_;
+    broad_phase_ = BroadPhase::Create(broad_phase);
+    params_.broad_phase = broad_phase;
+  }
+  params_.sensing_error = state.sensing_error;
+  params_.seed = state.seed;
+  clock_.set_ticks(state.ticks);
+  rng_.set_state(state.rng_state);
+  n_collisions_ = state.n_collisions;
+  game_status_ = state.game_status;
+  f_e_ratio_ = state.f_e_ratio;
+  paused_ = state.paused != 0;
+}
+
+void Arena::UpdateCollisionsBruteForce() {
   for (auto &ent1 : mobile_entities_) {
     EntityType wall = GetCollisionWall(ent1);
     if (ent1->get_type() == kLight) {
@@ -136,6 +308,7 @@ void Arena::UpdateEntitiesTimestep() {
           if (ent2->get_type() == kRobot) { continue; }
           if (ent2->get_type() == kFood) { continue; }
           AdjustEntityOverlap(ent1, ent2);
+          CountCollision(ent1, ent2);
           static_cast<Light*> (ent1)->
             HandleCollision(ent2->get_type(), ent2);
         }
@@ -149,6 +322,7 @@ void Arena::UpdateEntitiesTimestep() {
         if (ent2 == ent1) { continue; }
         if (ent2->get_type() == kLight) { continue; }
         if (IsColliding(ent1, ent2)) {
+          CountCollision(ent1, ent2);
           if (ent2->get_type() == kFood) {
             static_cast<Robot*> (ent1)->
               HandleCollision(ent2->get_type(), ent2);
@@ -161,8 +335,144 @@ void Arena::UpdateEntitiesTimestep() {
       }
     }
   }
-}  // UpdateEntitiesTimestep()
+}  // UpdateCollisionsBruteForce()
+
+void Arena::UpdateCollisionsBroadPhase() {
+  // A wall only moves the entity that hit it.
+  thread_pool_->ParallelFor(mobile_entities_.size(),
+    [this](size_t begin, size_t end) {
+      for (size_t i = begin; i < end; ++i) {
+        ArenaMobileEntity *ent = mobile_entities_[i];
+        EntityType wall = GetCollisionWall(ent);
+        if (kUndefined == wall) {
+          continue;
+        }
+        AdjustWallOverlap(ent, wall);
+        if (ent->get_type() == kLight) {
+          static_cast<Light*> (ent)->HandleCollision(wall);
+        } else {
+          static_cast<Robot*> (ent)->HandleCollision(wall);
+        }
+      }
+    });
+
+  // The broad phase has already dropped type pairs that never interact.
+  // Resolving one pair moves entities that later pairs test against, so
+  // the pairs are handled serially, in order.
+  GatherStore(store_.mobiles());
+  broad_phase_->FindPairs(store_, &collision_pairs_);
+  for (auto &pair : collision_pairs_) {
+    ArenaEntity *ent1 = entities_[pair.first];
+    ArenaEntity *ent2 = entities_[pair.second];
+    // At least one side reacts, and only mobile entities react.
+    if (!ent1->is_mobile()) {
+      std::swap(ent1, ent2);
+    }
+    if (!IsColliding(static_cast<ArenaMobileEntity*> (ent1), ent2)) {
+      continue;
+    }
+    if (BroadPhase::Reacts(ent1->get_type(), ent2->get_type())) {
+      ReactToCollision(ent1, ent2);
+    }
+    if (BroadPhase::Reacts(ent2->get_type(), ent1->get_type())) {
+      ReactToCollision(ent2, ent1);
+    }
+  }
+}  // UpdateCollisionsBroadPhase()
 
+void Arena::ReactToCollision(ArenaEntity * const self,
+  ArenaEntity * const other) {
+  auto *mobile = static_cast<ArenaMobileEntity*> (self);
+  CountCollision(self, other);
+  if (self->get_type() == kLight) {
+    AdjustEntityOverlap(mobile, other);
+    static_cast<Light*> (self)->HandleCollision(other->get_type(), other);
+  } else {
+    if (other->get_type() != kFood) {
+      AdjustEntityOverlap(mobile, other);
+    }
+    static_cast<Robot*> (self)->HandleCollision(other->get_type(), other);
+  }
+}
+
+void Arena::GatherStore(EntityRange range) {
+  thread_pool_->ParallelFor(range.size(),
+    [this, range](size_t begin, size_t end) {
+      store_.Gather(entities_, {range.begin + begin, range.begin + end});
+    });
+}
+
+void Arena::UpdateSensingCutoffs() {
+  // Nothing in the arena is further apart than its diagonal.
+  double diagonal = std::sqrt(x_dim_*x_dim_ + y_dim_*y_dim_);
+  for (SensingCutoff *cutoff : {&light_cutoff_, &food_cutoff_}) {
+    cutoff->active = false;
+    cutoff->radius = 0.0;
+    cutoff->error_bound = 0.0;
+    if (!(params_.sensing_error > 0)) {
+      continue;
+    }
+    EntityRange range = store_.range(cutoff->type);
+    double max_intensity = 0.0;
+    for (size_t i = range.begin; i < range.end; ++i) {
+      max_intensity = std::max(max_intensity, store_.intensity()[i]);
+    }
+    // Solve n * max_intensity / 1.08^radius = sensing_error for the radius.
+    double total = range.size() * max_intensity;
+    double radius = std::max(
+      std::log(total / params_.sensing_error) / std::log(1.08), 0.0);
+    if (!(radius < diagonal)) {
+      continue;
+    }
+    cutoff->active = true;
+    cutoff->radius = radius;
+    cutoff->error_bound = total / std::pow(1.08, radius);
+    cutoff->grid.Build(store_, range, radius);
+  }
+} /* UpdateSensingCutoffs() */
+
+void Arena::SenseEmitters(const SensingCutoff &cutoff) {
+  EntityRange sensors = (cutoff.type == kLight) ?
+    EntityRange{0, n_light_sensors_} :
+    EntityRange{n_light_sensors_, sensors_.size()};
+  EntityRange emitters = store_.range(cutoff.type);
+  thread_pool_->ParallelFor(sensors.size(),
+    [this, &cutoff, sensors, emitters](size_t begin, size_t end) {
+      begin += sensors.begin;
+      end += sensors.begin;
+      if (cutoff.active) {
+        for (size_t i = begin; i < end; ++i) {
+          sensors_[i]->ReceiveInfo(store_, cutoff.grid, cutoff.radius);
+        }
+        return;
+      }
+      for (size_t i = begin; i < end; ++i) {
+        sensor_x_[i] = sensors_[i]->get_pose().x;
+        sensor_y_[i] = sensors_[i]->get_pose().y;
+      }
+      ComputeImpulses(sensor_x_.data() + begin, sensor_y_.data() + begin,
+                      end - begin, store_.x() + emitters.begin,
+                      store_.y() + emitters.begin,
+                      store_.intensity() + emitters.begin, emitters.size(),
+                      sensor_impulse_.data() + begin);
+      for (size_t i = begin; i < end; ++i) {
+        sensors_[i]->set_impulse(sensor_impulse_[i]);
+      }
+    });
+} /* SenseEmitters() */
+
+double Arena::get_sensing_error_bound() const {
+  return std::max(light_cutoff_.error_bound, food_cutoff_.error_bound);
+}
+
+double Arena::get_sensing_cutoff(EntityType type) const {
+  if (type == kLight) {
+    return light_cutoff_.radius;
+  } else if (type == kFood) {
+    return food_cutoff_.radius;
+  }
+  return 0.0;
+}
 
 // Determine if the entity is colliding with a wall.
 // Always returns an entity type. If not collision, returns kUndefined.
@@ -263,4 +573,52 @@ void Arena::AcceptCommand(Communication com) {
   }
 } /* AcceptCommand */
 
+bool Arena::PostCommand(Communication com, double value) {
+  arena_command command;
+  command.type = com;
+  command.value = value;
+  return commands_.TryPush(command);
+}
+
+size_t Arena::ApplyCommands() {
+  size_t n_applied = 0;
+  bool set_intensity = false;
+  double intensity = 0.0;
+  bool set_food = false;
+  bool food = true;
+  arena_command command;
+  while (commands_.TryPop(&command)) {
+    ++n_applied;
+    switch (command.type) {
+    case(kSetFERatio): set_f_e_ratio(static_cast<float>(command.value));
+      break;
+    case(kSetLightIntensity):
+      set_intensity = true;
+      intensity = command.value;
+      break;
+    case(kYesFood):
+    case(kNoFood):
+      set_food = true;
+      food = (command.type == kYesFood);
+      break;
+    default: AcceptCommand(command.type);
+      break;
+    }
+  }
+
+  // The coalesced settings, one pass each.
+  if (set_intensity) {
+    EntityRange lights = store_.lights();
+    for (size_t i = lights.begin; i < lights.end; ++i) {
+      entities_[i]->set_intensity(intensity);
+    }
+  }
+  if (set_food) {
+    for (auto &robot : robots_) {
+      robot->food_exists_ = food;
+    }
+  }
+  return n_applied;
+} /* ApplyCommands() */
+
 NAMESPACE_END(csci3081);
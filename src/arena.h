@@ -10,21 +10,45 @@
 /*******************************************************************************
  * Includes
  ******************************************************************************/
+#include <atomic>
 #include <cmath>
 #include <iostream>
 #include <vector>
 
+#include "src/broad_phase.h"
 #include "src/common.h"
+#include "src/emitter_grid.h"
 #include "src/entity_factory.h"
+#include "src/entity_state.h"
+#include "src/entity_store.h"
+#include "src/impulse_kernel.h"
 #include "src/robot.h"
 #include "src/communication.h"
 #include "src/arena_params.h"
+#include "src/rng.h"
+#include "src/sim_clock.h"
+#include "src/spsc_queue.h"
+#include "src/step_profiler.h"
+#include "src/thread_pool.h"
 
 /*******************************************************************************
  * Namespaces
  ******************************************************************************/
 NAMESPACE_BEGIN(csci3081);
 
+/*******************************************************************************
+ * Structure Definitions
+ ******************************************************************************/
+/**
+ * @brief An entity reacting to a collision with another, by type and id.
+ */
+struct collision_event {
+  EntityType self_type;
+  int self_id;
+  EntityType other_type;
+  int other_id;
+};
+
 /*******************************************************************************
  * Class Definitions
  ******************************************************************************/
@@ -47,10 +71,18 @@ class Arena {
    *
    * @param params A arena_params passed down from main.cc for the
    * initialization of Arena and the entities therein.
+   * @param cancel If given and set while the Arena is being built (e.g. from
+   * another thread), entity creation stops early. The result is then
+   * incomplete and only fit to be deleted.
+   * @param states If given, the entities are loaded from these records
+   * instead of being placed at random: one per entity of `params`, robots
+   * first, then lights, then foods (see LoadCheckpoint()).
    *
    * Initialize all private variables and entities.
    */
-  explicit Arena(const struct arena_params *const params);
+  explicit Arena(const struct arena_params *const params,
+                 const std::atomic<bool> *cancel = nullptr,
+                 const entity_state *states = nullptr);
 
   /**
    * @brief Arena's destructor. `delete` all entities created.
@@ -58,21 +90,42 @@ class Arena {
   ~Arena();
 
   /**
-   * @brief Advance the simulation by the specified # of steps.
+   * @brief Advance the simulation by the specified amount of simulated time.
    *
-   * @param[in] dt The # of steps to increment by. This is
-   * practically unused because the arena state is advanced
-   * incrementally at a fixed rate.
+   * @param[in] dt The simulated seconds to advance by, rounded to the
+   * nearest whole # of timesteps.
    *
-   * If `dt == 0`, `return` immediately. Otherwise calls
-   * Arena::UpdateEntitiesTimestep() once.
+   * If `dt <= 0`, `return` immediately. Otherwise calls StepN().
    */
   void AdvanceTime(double dt);
 
+  /**
+   * @brief Run `n_steps` timesteps back to back, stopping early if the game
+   * is lost.
+   *
+   * @return The # of timesteps run.
+   */
+  uint64_t StepN(uint64_t n_steps);
+
+  /**
+   * @brief Create `quantity` more robots and add them to the Arena.
+   */
   void AddRobots(EntityType type, int quantity);
 
+  /**
+   * @brief Create `quantity` more entities of `type` and add them to the
+   * Arena.
+   */
   void AddEntity(EntityType type, int quantity);
 
+  /**
+   * @brief Create several kinds of entities at once, partitioning the
+   * Arena only once at the end. The constructor uses this.
+   *
+   * Runs in time linear in the total # of entities.
+   */
+  void AddEntities(size_t n_robots, size_t n_lights, size_t n_foods);
+
   /**
    * @brief Receive commands from the Controller
    *
@@ -81,17 +134,59 @@ class Arena {
    */
   void AcceptCommand(Communication com);
 
+  /**
+   * @brief Queue a command for the Arena to apply at its next step boundary
+   * (see ApplyCommands()).
+   *
+   * Never locks or blocks, so it is safe to call from GUI callbacks while
+   * another thread steps the Arena. Only one thread may post.
+   *
+   * @param[in] com The command.
+   * @param[in] value Its payload, for kSetFERatio and kSetLightIntensity.
+   *
+   * @return false if the queue is full, in which case the command is
+   * dropped.
+   */
+  bool PostCommand(Communication com, double value = 0.0);
+
+  /**
+   * @brief Apply every queued command as one batch.
+   *
+   * Commands are applied in order, except that only the last light
+   * intensity and the last food setting of the batch take effect, each in a
+   * single pass over the lights or robots. Called at the start of every
+   * timestep, and by a SimulationThread whenever it wakes, so that commands
+   * also take effect while paused. Must be called from the thread that
+   * steps the Arena.
+   *
+   * @return The # of commands applied.
+   */
+  size_t ApplyCommands();
+
   /**
    * @brief Reset all entities in Arena.
    */
   void Reset();
 
+  /**
+   * @brief Restart the Arena's random sequence. A following Reset() then
+   * places the entities the same way for the same seed.
+   */
+  void Reseed(uint64_t seed) { rng_.Seed(seed); }
+
   /**
    * @brief Get the robots in Arena.
    *
    * @return A vector of the robots.
    */
-  std::vector<class Robot *> get_robots() const { return robots_; }
+  const std::vector<class Robot *> &get_robots() const { return robots_; }
+
+  /**
+   * @brief Get the robots and lights: every entity that moves.
+   */
+  const std::vector<class ArenaMobileEntity *> &get_mobile_entities() const {
+    return mobile_entities_;
+  }
 
   /**
    * @brief Under certain circumstance, the compiler requires that the
@@ -150,18 +245,55 @@ class Arena {
   /**
    * @brief Update all entities for a single timestep.
    *
-   * First calls each entity's TimestepUpdate method to update their speed,
-   * heading angle, and position. Then check for collisions between entities
-   * or between an entity and a wall.
+   * Advances the simulation clock by one timestep, then calls each entity's
+   * TimestepUpdate method to update their speed, heading angle, and
+   * position. Then check for collisions between entities or between an
+   * entity and a wall.
+   *
+   * The phases are split across the Arena's ThreadPool. A phase that needs
+   * other entities' positions reads them from the EntityStore (the front
+   * buffer) while writing only to its own entities (the back buffer); the
+   * store is refreshed between phases. Collisions between entities are
+   * resolved one pair at a time, in order, so the result is identical for
+   * any thread count.
    */
   void UpdateEntitiesTimestep();
 
-  std::vector<class ArenaEntity *> get_entities() const { return entities_; }
+  /**
+   * @brief Get the broad phase used for entity-entity collisions.
+   *
+   * @return The broad phase, or nullptr when the reference brute-force loop
+   * is in use.
+   */
+  BroadPhase * get_broad_phase() { return broad_phase_; }
 
-  std::vector<class Sensor *> get_sensors() const { return sensors_; }
+  /**
+   * @brief The largest error that the sensing cut-off (arena_params::
+   * sensing_error) may have introduced into any sensor's impulse during the
+   * last timestep. 0 when every emitter was sensed.
+   */
+  double get_sensing_error_bound() const;
 
-  double get_x_dim() { return x_dim_; }
-  double get_y_dim() { return y_dim_; }
+  /**
+   * @brief The distance beyond which emitters of `type` (kLight or kFood)
+   * were ignored during the last timestep, or 0 if none were.
+   */
+  double get_sensing_cutoff(EntityType type) const;
+
+  /**
+   * @brief Get the structure-of-arrays copy of the entities' geometry. Index
+   * i of the store is entry i of get_entities().
+   */
+  const EntityStore &get_store() const { return store_; }
+
+  const std::vector<class ArenaEntity *> &get_entities() const {
+    return entities_;
+  }
+
+  const std::vector<class Sensor *> &get_sensors() const { return sensors_; }
+
+  double get_x_dim() const { return x_dim_; }
+  double get_y_dim() const { return y_dim_; }
 
   int get_game_status() const { return game_status_; }
   void set_game_status(int status) { game_status_ = status; }
@@ -171,10 +303,188 @@ class Arena {
 
   EntityFactory * get_factory() { return factory_; }
 
+  /**
+   * @brief The # of threads used to step the Arena, including the caller.
+   */
+  int get_n_threads() const { return thread_pool_->get_n_threads(); }
+
+  /**
+   * @brief Entity-entity collisions handled since construction or the last
+   * Reset(), counted once per entity that reacts. Walls are not counted.
+   */
+  uint64_t get_n_collisions() const { return n_collisions_; }
+
+  /**
+   * @brief Keep the collisions of each step, in the order they are handled,
+   * for get_collision_events(). Off by default.
+   */
+  void set_record_collisions(bool record) {
+    record_collisions_ = record;
+    collision_events_.clear();
+  }
+
+  /**
+   * @brief The collisions counted by get_n_collisions() in the last step,
+   * if set_record_collisions() is on.
+   */
+  const std::vector<collision_event> &get_collision_events() const {
+    return collision_events_;
+  }
+
+  /**
+   * @brief The simulated time of the Arena. Entity timers are measured
+   * against it rather than against the wall clock.
+   */
+  const SimClock &get_clock() const { return clock_; }
+
+  /**
+   * @brief What the recent steps cost, phase by phase, averaged over the
+   * last PROFILER_WINDOW steps. Must be called from the thread that steps
+   * the Arena (the SimulationThread copies it into each snapshot).
+   */
+  step_stats GetStepStats() const { return profiler_.GetStats(); }
+
+  /**
+   * @brief The time of every step since the Arena was built.
+   */
+  const LatencyHistogram &get_step_histogram() const {
+    return profiler_.get_histogram();
+  }
+
+  /**
+   * @brief Log the steps that take longer than `seconds`, with the time of
+   * each phase. 0 turns this off.
+   */
+  void set_step_budget(double seconds) { profiler_.set_budget(seconds); }
+
+  /**
+   * @brief Count hardware events (cycles, cache misses, ...) in each phase
+   * of every step from now on. Must be called from the thread that steps the
+   * Arena; only that thread is counted.
+   *
+   * @return false if the counters are unavailable. Stepping is unaffected.
+   */
+  bool EnableStepCounters() { return profiler_.EnableCounters(); }
+
+  step_counters GetStepCounters() const { return profiler_.GetCounters(); }
+
+  /**
+   * @brief Copy the Arena's own state (not its entities') into `state`,
+   * for a checkpoint.
+   */
+  void SaveState(arena_state *state) const;
+
+  /**
+   * @brief Put the Arena's own state back as SaveState() recorded it. The
+   * entity counts and dimensions must already match; see
+   * RestoreCheckpoint(). Must be called from the thread that steps the
+   * Arena.
+   */
+  void LoadState(const arena_state &state);
+
+  /**
+   * @brief The generator every random placement and size is drawn from.
+   */
+  const Rng &get_rng() const { return rng_; }
+
   float get_f_e_ratio() const { return f_e_ratio_; }
   void set_f_e_ratio(float value) { f_e_ratio_ = value; }
 
  private:
+  /**
+   * @brief Reorder the entities so each type is contiguous (robots, lights,
+   * then foods) and rebuild the EntityStore to match.
+   */
+  void PartitionEntities();
+
+  /**
+   * @brief Create entities and append them to entities_ and to the type
+   * lists they belong in, without partitioning.
+   */
+  void CreateEntities(EntityType type, size_t quantity);
+
+  /**
+   * @brief Create the entities loaded from `states`, in order, then
+   * partition them.
+   */
+  void LoadEntities(const entity_state *states, size_t n_robots,
+                    size_t n_lights, size_t n_foods);
+
+  /**
+   * @brief Append a new entity to entities_ and to the type lists it belongs
+   * in.
+   */
+  void InsertEntity(ArenaEntity *ent);
+
+  bool BuildCancelled() const {
+    return cancel_build_ != nullptr &&
+        cancel_build_->load(std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief The reference collision pass: every mobile entity is tested against
+   * every entity, interleaved with its wall test.
+   */
+  void UpdateCollisionsBruteForce();
+
+  /**
+   * @brief Collision pass driven by the broad phase. Walls are handled first,
+   * then each candidate pair is tested once and both sides react as needed.
+   */
+  void UpdateCollisionsBroadPhase();
+
+  /**
+   * @brief Let `self` react to touching `other`: move it out of the overlap
+   * (unless `other` is food, which is eaten rather than bumped into) and
+   * notify it of the collision.
+   */
+  void ReactToCollision(ArenaEntity * const self, ArenaEntity * const other);
+
+  /**
+   * @brief Count a collision that `self` reacts to.
+   */
+  void CountCollision(const ArenaEntity *self, const ArenaEntity *other) {
+    ++n_collisions_;
+    if (record_collisions_) {
+      collision_events_.push_back({self->get_type(), self->get_id(),
+                                   other->get_type(), other->get_id()});
+    }
+  }
+
+  /**
+   * @brief Copy the geometry of `entities_[range]` into the store, split
+   * across the threads.
+   */
+  void GatherStore(EntityRange range);
+
+  /**
+   * @brief Choose the cut-off radius for each emitter type from
+   * arena_params::sensing_error and index the emitters for range queries.
+   */
+  void UpdateSensingCutoffs();
+
+  /**
+   * @brief The far-field cut-off for sensors of one receiver type.
+   *
+   * An emitter at distance d adds intensity / 1.08^d, so skipping every
+   * emitter beyond `radius` loses at most n * max_intensity / 1.08^radius.
+   */
+  struct SensingCutoff {
+    EntityType type{kUndefined};
+    // Whether sensors of this type use the cut-off this timestep.
+    bool active{false};
+    double radius{0.0};
+    double error_bound{0.0};
+    EmitterGrid grid{};
+  };
+
+  /**
+   * @brief Compute the impulse of every sensor of `cutoff.type`: through the
+   * cut-off grid when it is active, otherwise with the batched kernel over
+   * all emitters of that type.
+   */
+  void SenseEmitters(const SensingCutoff &cutoff);
+
   // Dimensions of graphics window inside which entities must operate
   double x_dim_;
   double y_dim_;
@@ -185,22 +495,65 @@ class Arena {
   // Store the paramaters used to create the arena
   arena_params params_;
 
-  // Sensors are not entities and thus must be stored separately.
+  // Finds candidate collision pairs. nullptr selects the brute-force loop.
+  BroadPhase *broad_phase_;
+
+  // Runs the per-entity phases of a timestep.
+  ThreadPool *thread_pool_;
+
+  // Scratch list of candidate pairs, reused every timestep.
+  std::vector<CollisionPair> collision_pairs_;
+
+  // Sensors are not entities and thus must be stored separately. The light
+  // sensors of every robot come first, then the food sensors.
   std::vector<class Sensor *> sensors_;
+  size_t n_light_sensors_;
+
+  // Positions and impulses of sensors_, as arrays for ComputeImpulses().
+  std::vector<double> sensor_x_;
+  std::vector<double> sensor_y_;
+  std::vector<double> sensor_impulse_;
 
   // Robot is special. It's also stored in the entity vectors.
   std::vector<class Robot *> robots_;
 
-  // All entities mobile and immobile.
+  // All entities mobile and immobile, partitioned by type.
   std::vector<class ArenaEntity *> entities_;
 
+  // Geometry of entities_ as contiguous arrays, for the step kernels.
+  EntityStore store_;
+
   // A subset of the entities -- only those that can move (only Robot for now).
   std::vector<class ArenaMobileEntity *> mobile_entities_;
 
+  // Simulated time, in timesteps since construction or the last Reset().
+  SimClock clock_;
+
+  // Times each phase of UpdateEntitiesTimestep().
+  StepProfiler profiler_;
+
+  // Source of all randomness in this Arena. Shared with the entities.
+  Rng rng_;
+
+  // Sensing cut-offs for light and food sensors.
+  SensingCutoff light_cutoff_;
+  SensingCutoff food_cutoff_;
+
+  // Commands posted by the Controller, applied at step boundaries.
+  SpscQueue<arena_command> commands_;
+
+  // Set only while the constructor runs; see Arena().
+  const std::atomic<bool> *cancel_build_;
+
   // win/lose/playing state
   int game_status_;
   bool paused_{true};
 
+  // See get_n_collisions().
+  uint64_t n_collisions_{0};
+  bool record_collisions_{false};
+  std::vector<collision_event> collision_events_{};
+
   // ratio of robots created with the fear behavior vs the exploratory behavior
   float f_e_ratio_;
 };
@@ -0,0 +1,139 @@
+/**
+ * @file arena_builder.cc
+ *
+ * @copyright 2018 3081 Staff, All rights reserved.
+ */
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include "src/arena_builder.h"
+#include "src/tracer.h"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+NAMESPACE_BEGIN(csci3081);
+
+/*******************************************************************************
+ * Constructors/Destructor
+ ******************************************************************************/
+ArenaBuilder::ArenaBuilder() {
+  worker_ = std::thread(&ArenaBuilder::WorkerLoop, this);
+}
+
+ArenaBuilder::~ArenaBuilder() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+    cancel_ = true;
+  }
+  wake_.notify_all();
+  worker_.join();
+  delete ready_;
+  for (auto arena : retired_) {
+    delete arena;
+  }
+}
+
+/*******************************************************************************
+ * Member Functions
+ ******************************************************************************/
+void ArenaBuilder::Request(const arena_params &params) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    request_ = params;
+    has_request_ = true;
+    cancel_ = true;
+    if (ready_ != nullptr) {
+      retired_.push_back(ready_);
+      ready_ = nullptr;
+    }
+  }
+  wake_.notify_all();
+}
+
+void ArenaBuilder::Cancel() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    has_request_ = false;
+    cancel_ = true;
+    if (ready_ != nullptr) {
+      retired_.push_back(ready_);
+      ready_ = nullptr;
+    }
+  }
+  wake_.notify_all();
+}
+
+Arena *ArenaBuilder::TakeReady() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  Arena *arena = ready_;
+  ready_ = nullptr;
+  return arena;
+}
+
+void ArenaBuilder::Retire(Arena *arena) {
+  if (arena == nullptr) {
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    retired_.push_back(arena);
+  }
+  wake_.notify_all();
+}
+
+bool ArenaBuilder::is_busy() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return has_request_ || building_;
+}
+
+void ArenaBuilder::WorkerLoop() {
+  Tracer::SetThreadName("arena builder");
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (true) {
+    wake_.wait(lock, [this] {
+        return stop_ || has_request_ || !retired_.empty();
+      });
+    if (stop_) {
+      return;
+    }
+
+    if (!retired_.empty()) {
+      std::vector<Arena *> retired;
+      retired.swap(retired_);
+      lock.unlock();
+      {
+        ScopedTrace trace("retire arenas", "rebuild");
+        for (auto arena : retired) {
+          delete arena;
+        }
+      }
+      lock.lock();
+      continue;
+    }
+
+    arena_params params = request_;
+    has_request_ = false;
+    building_ = true;
+    cancel_ = false;
+    lock.unlock();
+    Arena *arena = nullptr;
+    {
+      ScopedTrace trace("build arena", "rebuild");
+      arena = new Arena(&params, &cancel_);
+    }
+    lock.lock();
+    building_ = false;
+    if (cancel_) {
+      // Superseded or cancelled while it was being built.
+      ++n_cancelled_;
+      retired_.push_back(arena);
+    } else {
+      ready_ = arena;
+    }
+  }
+} /* WorkerLoop() */
+
+NAMESPACE_END(csci3081);
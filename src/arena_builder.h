@@ -0,0 +1,110 @@
+/**
+ * @file arena_builder.h
+ *
+ * @copyright 2018 3081 Staff, All rights reserved.
+ */
+
+#ifndef SRC_ARENA_BUILDER_H_
+#define SRC_ARENA_BUILDER_H_
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "src/arena.h"
+#include "src/arena_params.h"
+#include "src/common.h"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+NAMESPACE_BEGIN(csci3081);
+
+/*******************************************************************************
+ * Class Definitions
+ ******************************************************************************/
+/**
+ * @brief Builds Arenas on a background thread, so that a large rebuild does
+ * not freeze the viewer.
+ *
+ * Only the newest request matters: a new request cancels the build in
+ * flight (see the `cancel` argument of Arena's constructor) and replaces
+ * any finished Arena that has not been taken yet. The owner polls
+ * TakeReady() and swaps the result in whenever it is convenient, and can
+ * hand the old Arena to Retire() to have it deleted on the same thread.
+ *
+ * The methods may be called from any one thread.
+ */
+class ArenaBuilder {
+ public:
+  ArenaBuilder();
+
+  /**
+   * @brief Cancels any build in flight and deletes every Arena not yet
+   * taken or still waiting to be retired.
+   */
+  ~ArenaBuilder();
+
+  ArenaBuilder(const ArenaBuilder &other) = delete;
+  ArenaBuilder &operator=(const ArenaBuilder &other) = delete;
+
+  /**
+   * @brief Start building an Arena from `params`, dropping any earlier
+   * request.
+   */
+  void Request(const arena_params &params);
+
+  /**
+   * @brief Drop the current request, if any.
+   */
+  void Cancel();
+
+  /**
+   * @brief The finished Arena, if there is one. The caller owns it.
+   *
+   * @return nullptr if no build has finished since the last call.
+   */
+  Arena *TakeReady();
+
+  /**
+   * @brief Delete `arena` on the builder's thread.
+   */
+  void Retire(Arena *arena);
+
+  /**
+   * @brief Whether a request is queued or being built.
+   */
+  bool is_busy() const;
+
+  /**
+   * @brief The # of builds stopped part way by a newer request or Cancel().
+   */
+  uint64_t get_n_cancelled() const { return n_cancelled_; }
+
+ private:
+  void WorkerLoop();
+
+  mutable std::mutex mutex_{};
+  std::condition_variable wake_{};
+  // The newest request, if has_request_.
+  arena_params request_{};
+  bool has_request_{false};
+  bool building_{false};
+  // Tells the Arena being built to stop.
+  std::atomic<bool> cancel_{false};
+  Arena *ready_{nullptr};
+  std::vector<Arena *> retired_{};
+  std::atomic<uint64_t> n_cancelled_{0};
+  bool stop_{false};
+  std::thread worker_{};
+};
+
+NAMESPACE_END(csci3081);
+
+#endif  // SRC_ARENA_BUILDER_H_
@@ -10,13 +10,18 @@
 /*******************************************************************************
  * Includes
  ******************************************************************************/
+#include <algorithm>
+#include <cstdlib>
 #include <string>
 
 #include "src/common.h"
+#include "src/entity_state.h"
 #include "src/entity_type.h"
 #include "src/params.h"
 #include "src/pose.h"
 #include "src/rgb_color.h"
+#include "src/rng.h"
+#include "src/sim_clock.h"
 
 /*******************************************************************************
  * Namespaces
@@ -51,6 +56,9 @@ class ArenaEntity {
  */
   ArenaEntity() : pose_(DEFAULT_POSE), color_(DEFAULT_COLOR) {}
 
+  ArenaEntity(const ArenaEntity &other) = default;
+  ArenaEntity &operator=(const ArenaEntity &other) = default;
+
   /**
    * @brief Default destructor -- as defined by compiler.
    */
@@ -77,6 +85,35 @@ class ArenaEntity {
    */
   virtual std::string get_name() const = 0;
 
+  /**
+   * @brief Copy everything the entity carries between steps into `state`,
+   * for a checkpoint. Subclasses add their own state to ArenaEntity's.
+   */
+  virtual void SaveState(entity_state *state) const {
+    state->x = pose_.x;
+    state->y = pose_.y;
+    state->theta = pose_.theta;
+    state->radius = radius_;
+    state->intensity = intensity_;
+    state->type = type_;
+    state->id = id_;
+    state->color_r = color_.r;
+    state->color_g = color_.g;
+    state->color_b = color_.b;
+  }
+
+  /**
+   * @brief Put the entity back in the state SaveState() recorded. The type
+   * is not changed.
+   */
+  virtual void LoadState(const entity_state &state) {
+    pose_ = Pose(state.x, state.y, state.theta);
+    radius_ = state.radius;
+    intensity_ = state.intensity;
+    id_ = state.id;
+    color_ = RgbColor(state.color_r, state.color_g, state.color_b);
+  }
+
 
   const Pose &get_pose() const { return pose_; }
   void set_pose(const Pose &pose) { pose_ = pose; }
@@ -148,6 +185,60 @@ class ArenaEntity {
    */
   double get_intensity() { return intensity_; }
 
+  /**
+   * @brief Set the clock that the entity's timers are measured against.
+   * The Arena hands every entity its own clock when it is added.
+   */
+  void set_clock(const SimClock *clock) { clock_ = clock; }
+
+  const SimClock *get_clock() const { return clock_; }
+
+  /**
+   * @brief The current simulated time in timesteps, or 0 if the entity does
+   * not belong to an Arena.
+   */
+  uint64_t get_sim_time() const {
+    return (clock_ != nullptr) ? clock_->get_ticks() : 0;
+  }
+
+  /**
+   * @brief Set the generator that the entity's random placement and size are
+   * drawn from. The Arena hands every entity its own generator when it is
+   * added.
+   */
+  void set_rng(Rng *rng) { rng_ = rng; }
+
+  Rng *get_rng() const { return rng_; }
+
+  /**
+   * @brief A random integer in [0, n), from the Arena's generator, or from
+   * random() if the entity does not belong to an Arena.
+   */
+  int RandomInt(int n) {
+    return (rng_ != nullptr) ? rng_->UniformInt(n)
+                             : static_cast<int>(random() % n);
+  }
+
+  /**
+   * @brief Set the size of the arena the entity is placed in. The Arena
+   * hands it to every entity when it is added; until then the entity is
+   * placed as if in an ARENA_X_DIM x ARENA_Y_DIM arena.
+   */
+  void set_arena_size(int x_dim, int y_dim) {
+    grid_cols_ = GridCells(x_dim);
+    grid_rows_ = GridCells(y_dim);
+  }
+
+  /**
+   * @brief A random pose on the placement grid: the arena divided into 50x50
+   * squares, keeping 30 from the top and left walls.
+   */
+  Pose RandomGridPose() {
+    int col = RandomInt(grid_cols_);
+    int row = RandomInt(grid_rows_);
+    return {30.0 + col * 50.0, 30.0 + row * 50.0};
+  }
+
  private:
   double intensity_{1200.0};
   double radius_{DEFAULT_RADIUS};
@@ -156,6 +247,12 @@ class ArenaEntity {
   EntityType type_{kEntity};
   int id_{-1};
   bool is_mobile_{false};
+  const SimClock *clock_{nullptr};
+  Rng *rng_{nullptr};
+  // The placement grid. 19x14 for the default 1024x768 arena.
+  static int GridCells(int dim) { return std::max((dim - 60) / 50, 1); }
+  int grid_cols_{GridCells(ARENA_X_DIM)};
+  int grid_rows_{GridCells(ARENA_Y_DIM)};
 };
 
 NAMESPACE_END(csci3081);
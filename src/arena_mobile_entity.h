@@ -49,6 +49,23 @@ class ArenaMobileEntity : public ArenaEntity {
   ArenaMobileEntity(const ArenaMobileEntity& other) = delete;
   ArenaMobileEntity& operator=(const ArenaMobileEntity& other) = delete;
 
+  /**
+   * @brief ArenaMobileEntity's destructor. The entity owns its touch sensor.
+   */
+  ~ArenaMobileEntity() override { delete sensor_touch_; }
+
+
+  void SaveState(entity_state *state) const override {
+    ArenaEntity::SaveState(state);
+    state->speed = speed_;
+    state->touch_output = sensor_touch_->get_output();
+  }
+
+  void LoadState(const entity_state &state) override {
+    ArenaEntity::LoadState(state);
+    speed_ = state.speed;
+    sensor_touch_->set_output(state.touch_output != 0);
+  }
 
   virtual double get_speed() { return speed_; }
   virtual void set_speed(double sp) { speed_ = sp; }
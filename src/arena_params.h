@@ -11,6 +11,9 @@
 /*******************************************************************************
  * Includes
  ******************************************************************************/
+#include <cstdint>
+
+#include "src/broad_phase_type.h"
 #include "src/common.h"
 #include "src/params.h"
 
@@ -34,14 +37,24 @@ struct arena_params {
       n_lights == other.n_lights &&
       n_foods == other.n_foods &&
       x_dim == other.x_dim &&
-      y_dim == other.y_dim);
+      y_dim == other.y_dim &&
+      broad_phase == other.broad_phase &&
+      n_threads == other.n_threads &&
+      seed == other.seed &&
+      !(sensing_error < other.sensing_error ||
+        other.sensing_error < sensing_error));
   }
   bool operator!=(const arena_params other) const {
     return (n_robots != other.n_robots ||
       n_lights != other.n_lights ||
       n_foods != other.n_foods ||
       x_dim != other.x_dim ||
-      y_dim != other.y_dim);
+      y_dim != other.y_dim ||
+      broad_phase != other.broad_phase ||
+      n_threads != other.n_threads ||
+      seed != other.seed ||
+      sensing_error < other.sensing_error ||
+      other.sensing_error < sensing_error);
   }
 
   size_t n_robots{N_ROBOTS};
@@ -49,6 +62,18 @@ struct arena_params {
   size_t n_foods{N_FOODS};
   uint x_dim{ARENA_X_DIM};
   uint y_dim{ARENA_Y_DIM};
+  // kBruteForce selects the reference all-pairs collision loop, which
+  // handles each entity's wall and then its pairs in turn. The broad phases
+  // move every entity off the walls first and then resolve the pairs, so
+  // crowded entities near a wall can end up in different places.
+  BroadPhaseType broad_phase{kSpatialHash};
+  // Threads used to step the Arena, including the caller. 1 is serial.
+  int n_threads{1};
+  // Seed for entity placement and sizes. 0 seeds from the time of day.
+  uint64_t seed{0};
+  // Largest absolute error allowed in each sensor's impulse in exchange for
+  // skipping far-away emitters. 0 senses every emitter exactly.
+  double sensing_error{0.0};
 };
 
 NAMESPACE_END(csci3081);
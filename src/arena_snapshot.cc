@@ -0,0 +1,139 @@
+/**
+ * @file arena_snapshot.cc
+ *
+ * @copyright 2018 3081 Staff, All rights reserved.
+ */
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+#include "src/arena_snapshot.h"
+#include "src/robot.h"
+#include "src/sensor.h"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+NAMESPACE_BEGIN(csci3081);
+
+/*******************************************************************************
+ * Constants
+ ******************************************************************************/
+// Snapshots further apart than this, in seconds, are not blended.
+static const double kMaxBlendInterval = 0.25;
+
+/*******************************************************************************
+ * Member Functions
+ ******************************************************************************/
+bool SnapshotBuffer::Acquire() {
+  if (!buffer_.is_fresh()) {
+    return false;
+  }
+  // Keep the current front as the previous snapshot. The swap leaves the
+  // old previous one in the front slot, which goes back to the writer.
+  std::swap(previous_, *buffer_.get_front());
+  return buffer_.Acquire();
+}
+
+/*******************************************************************************
+ * Non-Member Functions
+ ******************************************************************************/
+static void CapturePose(const Pose &pose, double radius,
+                        const RgbColor &color, entity_snapshot *out) {
+  out->x = pose.x;
+  out->y = pose.y;
+  out->theta = pose.theta;
+  out->radius = radius;
+  out->color = color;
+}
+
+void CaptureSnapshot(const Arena &arena, double wall_seconds,
+                     arena_snapshot *snapshot) {
+  snapshot->ticks = arena.get_clock().get_ticks();
+  snapshot->wall_seconds = wall_seconds;
+  snapshot->x_dim = arena.get_x_dim();
+  snapshot->y_dim = arena.get_y_dim();
+  snapshot->game_status = arena.get_game_status();
+  snapshot->stats = arena.GetStepStats();
+
+  const auto &entities = arena.get_entities();
+  snapshot->entities.resize(entities.size());
+  for (size_t i = 0; i < entities.size(); ++i) {
+    const ArenaEntity *ent = entities[i];
+    entity_snapshot &out = snapshot->entities[i];
+    out.type = ent->get_type();
+    out.name = ent->get_name();
+    CapturePose(ent->get_pose(), ent->get_radius(), ent->get_color(), &out);
+    if (out.type == kRobot) {
+      auto *robot = static_cast<const Robot *>(ent);
+      out.l_behavior = robot->get_l_behavior();
+      out.f_behavior = robot->get_f_behavior();
+      out.hunger = robot->is_hungry();
+    }
+  }
+
+  const auto &sensors = arena.get_sensors();
+  snapshot->sensors.resize(sensors.size());
+  for (size_t i = 0; i < sensors.size(); ++i) {
+    entity_snapshot &out = snapshot->sensors[i];
+    out.type = kSensor;
+    CapturePose(sensors[i]->get_pose(), sensors[i]->get_radius(),
+                sensors[i]->get_color(), &out);
+  }
+} /* CaptureSnapshot() */
+
+double SnapshotBlend(const arena_snapshot &from, const arena_snapshot &to,
+                     double now) {
+  // Only blend consecutive steps of a running simulation, not across a
+  // reset or a long pause.
+  double interval = to.wall_seconds - from.wall_seconds;
+  if (!(to.ticks > from.ticks) || !(interval > 0) ||
+      interval > kMaxBlendInterval) {
+    return 1.0;
+  }
+  return std::min(std::max((now - to.wall_seconds) / interval, 0.0), 1.0);
+}
+
+static void Blend(const std::vector<entity_snapshot> &from,
+                  const std::vector<entity_snapshot> &to, double alpha,
+                  std::vector<entity_snapshot> *out) {
+  *out = to;
+  if (from.size() != to.size()) {
+    return;
+  }
+  for (size_t i = 0; i < to.size(); ++i) {
+    if (from[i].type != to[i].type) {
+      return;
+    }
+  }
+  for (size_t i = 0; i < to.size(); ++i) {
+    const entity_snapshot &a = from[i];
+    const entity_snapshot &b = to[i];
+    entity_snapshot &blend = (*out)[i];
+    blend.x = a.x + (b.x - a.x) * alpha;
+    blend.y = a.y + (b.y - a.y) * alpha;
+    blend.radius = a.radius + (b.radius - a.radius) * alpha;
+    // Headings are in degrees; turn the short way.
+    double turn = std::remainder(b.theta - a.theta, 360.0);
+    blend.theta = a.theta + turn * alpha;
+  }
+}
+
+void InterpolateSnapshots(const arena_snapshot &from,
+                          const arena_snapshot &to, double alpha,
+                          arena_snapshot *out) {
+  out->ticks = to.ticks;
+  out->wall_seconds = to.wall_seconds;
+  out->x_dim = to.x_dim;
+  out->y_dim = to.y_dim;
+  out->game_status = to.game_status;
+  out->stats = to.stats;
+  Blend(from.entities, to.entities, alpha, &out->entities);
+  Blend(from.sensors, to.sensors, alpha, &out->sensors);
+}
+
+NAMESPACE_END(csci3081);
@@ -0,0 +1,160 @@
+/**
+ * @file arena_snapshot.h
+ *
+ * @copyright 2018 3081 Staff, All rights reserved.
+ */
+
+#ifndef SRC_ARENA_SNAPSHOT_H_
+#define SRC_ARENA_SNAPSHOT_H_
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "src/arena.h"
+#include "src/common.h"
+#include "src/entity_type.h"
+#include "src/rgb_color.h"
+#include "src/step_profiler.h"
+#include "src/triple_buffer.h"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+NAMESPACE_BEGIN(csci3081);
+
+/*******************************************************************************
+ * Structure Definitions
+ ******************************************************************************/
+/**
+ * @brief What the viewer needs to draw one entity or sensor.
+ */
+struct entity_snapshot {
+  EntityType type{kEntity};
+  std::string name{};
+  double x{0.0};
+  double y{0.0};
+  double theta{0.0};
+  double radius{0.0};
+  RgbColor color{};
+  // Robots only: shown in the robot's label.
+  int l_behavior{0};
+  int f_behavior{0};
+  int hunger{0};
+};
+
+/**
+ * @brief A copy of everything the viewer draws, taken between timesteps.
+ */
+struct arena_snapshot {
+  // Simulated time of the copy, in timesteps.
+  uint64_t ticks{0};
+  // Wall-clock time of the copy, in seconds on the steady clock.
+  double wall_seconds{0.0};
+  double x_dim{0.0};
+  double y_dim{0.0};
+  int game_status{PLAYING};
+  // The recent cost of stepping (see Arena::GetStepStats()).
+  step_stats stats{};
+  // In the order of Arena::get_entities() and Arena::get_sensors().
+  std::vector<entity_snapshot> entities{};
+  std::vector<entity_snapshot> sensors{};
+};
+
+/*******************************************************************************
+ * Class Definitions
+ ******************************************************************************/
+/**
+ * @brief Hands arena_snapshots from the simulation thread to the viewer
+ * without either one waiting for the other.
+ *
+ * A TripleBuffer: the writer can publish as often as it likes and the
+ * reader always gets the newest complete snapshot. Intermediate ones are
+ * simply skipped.
+ *
+ * The reader also keeps the snapshot it had before the latest one, so that
+ * it can interpolate between the two.
+ *
+ * One thread may write and one other thread may read.
+ */
+class SnapshotBuffer {
+ public:
+  SnapshotBuffer() = default;
+
+  SnapshotBuffer(const SnapshotBuffer &other) = delete;
+  SnapshotBuffer &operator=(const SnapshotBuffer &other) = delete;
+
+  /**
+   * @brief The writer's back buffer, to fill in before Publish().
+   */
+  arena_snapshot *get_back() { return buffer_.get_back(); }
+
+  /**
+   * @brief Make the back buffer the newest snapshot. The writer gets a
+   * different back buffer, whose contents are stale.
+   */
+  void Publish() { buffer_.Publish(); }
+
+  /**
+   * @brief Take the newest published snapshot, if there is one the reader
+   * has not seen.
+   *
+   * @return Whether get_latest() changed.
+   */
+  bool Acquire();
+
+  /**
+   * @brief The newest snapshot the reader has acquired.
+   */
+  const arena_snapshot &get_latest() const { return buffer_.get_front(); }
+
+  /**
+   * @brief The snapshot acquired before get_latest().
+   */
+  const arena_snapshot &get_previous() const { return previous_; }
+
+ private:
+  TripleBuffer<arena_snapshot> buffer_{};
+  arena_snapshot previous_{};
+};
+
+/*******************************************************************************
+ * Non-Member Functions
+ ******************************************************************************/
+/**
+ * @brief Copy what the viewer draws out of `arena`.
+ *
+ * Reuses the storage already in `snapshot`, so capturing an Arena of the
+ * same size again does not allocate.
+ */
+void CaptureSnapshot(const Arena &arena, double wall_seconds,
+                     arena_snapshot *snapshot);
+
+/**
+ * @brief How far the viewer should be between `from` and `to` at wall time
+ * `now`, for drawing one snapshot interval behind the simulation.
+ *
+ * @return A fraction in [0, 1]: 0 at the time `to` was taken, 1 one
+ * snapshot interval later. Always 1 if the simulation did not move forward
+ * between the two, or they are too far apart to be worth blending.
+ */
+double SnapshotBlend(const arena_snapshot &from, const arena_snapshot &to,
+                     double now);
+
+/**
+ * @brief Blend the poses of two snapshots of the same Arena.
+ *
+ * Positions and radii are interpolated linearly and headings along the
+ * shorter way round. Everything else is taken from `to`, as is everything
+ * when the two snapshots do not list the same entities.
+ */
+void InterpolateSnapshots(const arena_snapshot &from,
+                          const arena_snapshot &to, double alpha,
+                          arena_snapshot *out);
+
+NAMESPACE_END(csci3081);
+
+#endif  // SRC_ARENA_SNAPSHOT_H_
@@ -0,0 +1,530 @@
+/**
+ * @file arenasim.cc
+ *
+ * @copyright 2018 3081 Staff, All rights reserved.
+ *
+ * Headless runner: builds an Arena without any graphics, advances it a fixed
+ * number of timesteps as fast as possible and reports the throughput. With
+ * --runs K it instead runs an ensemble of K seeds in parallel, each until a
+ * robot starves or --steps is reached, and reports one line per run.
+ *
+ * A single run prints its step latency histogram at the end, and on
+ * SIGUSR1 while it steps. --trace FILE writes a Chrome trace of the run.
+ * --perf-counters 1 adds the hardware events per phase, per entity and step.
+ * --metrics-socket PATH serves live Prometheus metrics while it steps.
+ * --checkpoint FILE saves the arena at the end (and with --checkpoint-every N
+ * every N steps); --restore FILE continues from such a checkpoint instead of
+ * building a new arena. --snapshot-every N saves it every N steps from a
+ * forked child instead, so that stepping does not wait for the disk.
+ * --trajectory FILE records every step's poses, wheel velocities, hunger and
+ * collisions (read them back with TrajectoryReader).
+ */
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <algorithm>
+#include <chrono>
+#include <csignal>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "src/alloc_counter.h"
+#include "src/arena.h"
+#include "src/arena_params.h"
+#include "src/background_checkpointer.h"
+#include "src/checkpoint.h"
+#include "src/ensemble.h"
+#include "src/metrics_exporter.h"
+#include "src/object_pool.h"
+#include "src/params.h"
+#include "src/tracer.h"
+#include "src/trajectory_recorder.h"
+
+/*******************************************************************************
+ * Structure Definitions
+ ******************************************************************************/
+/* Options that are not part of arena_params. */
+struct sim_options {
+  long steps{1000};
+  long runs{1};
+  // Ensemble threads; 0 is one per hardware thread.
+  int threads{0};
+  float f_e_ratio{0.0f};
+  double light_intensity{1200.0};
+  // Log steps slower than this many ms; 0 is off.
+  double step_budget_ms{0.0};
+  // Write a Chrome trace-event file here; empty is off.
+  std::string trace_file{};
+  // Count hardware events per phase with perf_event_open.
+  bool perf_counters{false};
+  // Serve Prometheus metrics on this Unix socket; empty is off.
+  std::string metrics_socket{};
+  // Save a checkpoint here at the end, and every checkpoint_every steps if
+  // that is not 0; empty is off.
+  std::string checkpoint_file{};
+  long checkpoint_every{0};
+  // Like checkpoint_every, but written by a forked child.
+  long snapshot_every{0};
+  // Continue from this checkpoint instead of building an arena.
+  std::string restore_file{};
+  // Record the trajectories here; empty is off.
+  std::string trajectory_file{};
+};
+
+/*******************************************************************************
+ * Global Variables
+ ******************************************************************************/
+// Set by SIGUSR1: dump the step latency histogram after the current step.
+static volatile std::sig_atomic_t dump_requested = 0;
+
+/*******************************************************************************
+ * Non-Member Functions
+ ******************************************************************************/
+static void PrintUsage(const char *prog) {
+  std::cout
+    << "Usage: " << prog << " [options]\n"
+    << "  --params FILE      read options from FILE (one \"key value\" per"
+    << " line, # comments)\n"
+    << "  --robots N         number of robots (default " << N_ROBOTS << ")\n"
+    << "  --lights N         number of lights (default " << N_LIGHTS << ")\n"
+    << "  --foods N          number of foods (default " << N_FOODS << ")\n"
+    << "  --width N          arena x dimension (default " << ARENA_X_DIM
+    << ")\n"
+    << "  --height N         arena y dimension (default " << ARENA_Y_DIM
+    << ")\n"
+    << "  --broad-phase B    brute, grid or sweep (default grid)\n"
+    << "  --threads N        threads used to step the arena (default 1), or"
+    << " to run the ensemble (default: all cores)\n"
+    << "  --seed N           seed for entity placement (default: time of"
+    << " day)\n"
+    << "  --fe-ratio R       fear/exploration ratio, 0 to 1 (default 0)\n"
+    << "  --intensity I      light intensity (default 1200)\n"
+    << "  --sensing-error E  allowed absolute error per sensor impulse;"
+    << " far emitters are skipped (default 0, exact)\n"
+    << "  --step-budget MS   log the steps slower than MS milliseconds,"
+    << " phase by phase (default 0, off)\n"
+    << "  --trace FILE       write a Chrome trace of the run to FILE\n"
+    << "  --perf-counters 1  count cycles, instructions and misses per"
+    << " phase (Linux, stepping thread only)\n"
+    << "  --metrics-socket PATH  serve Prometheus metrics on the Unix"
+    << " socket PATH while stepping\n"
+    << "  --checkpoint FILE  save the arena to FILE after the last step\n"
+    << "  --checkpoint-every N  also save it every N steps\n"
+    << "  --snapshot-every N  save it every N steps from a forked child,"
+    << " without pausing the steps\n"
+    << "  --restore FILE     continue from the checkpoint FILE; the arena"
+    << " options but --threads are ignored\n"
+    << "  --trajectory FILE  record every step's trajectories to FILE\n"
+    << "  --steps N          timesteps to run (default 1000)\n"
+    << "  --runs K           run an ensemble of K seeds, starting at --seed"
+    << " (default 1)\n";
+}
+
+static bool WriteCheckpoint(const csci3081::Arena &arena,
+                            const std::string &path) {
+  std::string error;
+  if (!csci3081::SaveCheckpoint(arena, path, &error)) {
+    std::cerr << "arenasim: cannot save checkpoint: " << error << std::endl;
+    return false;
+  }
+  return true;
+}
+
+static void RequestDump(int) {
+  dump_requested = 1;
+}
+
+/* Apply one option. Keys are the long option names without the dashes.
+ * Returns false if the key or value is not understood.
+ */
+static bool SetOption(const std::string &key, const std::string &value,
+                      csci3081::arena_params *params, sim_options *options) {
+  char *end = nullptr;
+  if (key == "trace") {
+    options->trace_file = value;
+    return !value.empty();
+  } else if (key == "metrics-socket") {
+    options->metrics_socket = value;
+    return !value.empty();
+  } else if (key == "checkpoint") {
+    options->checkpoint_file = value;
+    return !value.empty();
+  } else if (key == "restore") {
+    options->restore_file = value;
+    return !value.empty();
+  } else if (key == "trajectory") {
+    options->trajectory_file = value;
+    return !value.empty();
+  }
+  if (key == "fe-ratio" || key == "intensity" || key == "sensing-error" ||
+      key == "step-budget") {
+    double real = std::strtod(value.c_str(), &end);
+    if (value.empty() || *end != '\0' || real < 0) {
+      return false;
+    }
+    if (key == "fe-ratio") {
+      options->f_e_ratio = static_cast<float>(real);
+    } else if (key == "sensing-error") {
+      params->sensing_error = real;
+    } else if (key == "step-budget") {
+      options->step_budget_ms = real;
+    } else {
+      options->light_intensity = real;
+    }
+    return true;
+  }
+  long number = std::strtol(value.c_str(), &end, 10);
+  bool is_number = !value.empty() && *end == '\0' && number >= 0;
+  if (key == "broad-phase") {
+    if (value == "brute") {
+      params->broad_phase = csci3081::kBruteForce;
+    } else if (value == "grid") {
+      params->broad_phase = csci3081::kSpatialHash;
+    } else if (value == "sweep") {
+      params->broad_phase = csci3081::kSortAndSweep;
+    } else {
+      return false;
+    }
+    return true;
+  }
+  if (!is_number) {
+    return false;
+  }
+  if (key == "robots") {
+    params->n_robots = static_cast<size_t>(number);
+  } else if (key == "lights") {
+    params->n_lights = static_cast<size_t>(number);
+  } else if (key == "foods") {
+    params->n_foods = static_cast<size_t>(number);
+  } else if (key == "width") {
+    params->x_dim = static_cast<uint>(number);
+  } else if (key == "height") {
+    params->y_dim = static_cast<uint>(number);
+  } else if (key == "threads") {
+    params->n_threads = static_cast<int>(number);
+    options->threads = static_cast<int>(number);
+  } else if (key == "seed") {
+    params->seed = static_cast<uint64_t>(number);
+  } else if (key == "steps") {
+    options->steps = number;
+  } else if (key == "runs") {
+    options->runs = number;
+  } else if (key == "checkpoint-every") {
+    options->checkpoint_every = number;
+  } else if (key == "snapshot-every") {
+    options->snapshot_every = number;
+  } else if (key == "perf-counters") {
+    options->perf_counters = number != 0;
+  } else {
+    return false;
+  }
+  return true;
+}
+
+static bool ReadParamsFile(const std::string &path,
+                           csci3081::arena_params *params,
+                           sim_options *options) {
+  std::ifstream in(path);
+  if (!in) {
+    std::cerr << "arenasim: cannot open " << path << std::endl;
+    return false;
+  }
+  std::string line;
+  int line_no = 0;
+  while (std::getline(in, line)) {
+    ++line_no;
+    line = line.substr(0, line.find('#'));
+    std::istringstream fields(line);
+    std::string key, value;
+    if (!(fields >> key)) {
+      continue;
+    }
+    fields >> value;
+    if (value == "=") {
+      fields >> value;
+    }
+    if (!SetOption(key, value, params, options)) {
+      std::cerr << "arenasim: " << path << ":" << line_no
+                << ": bad option '" << key << "'" << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+/* The counted events of each phase, per entity and step. */
+static void PrintCounters(const csci3081::step_counters &counters,
+                          size_t n_entities, int n_threads) {
+  std::cout << "perf counters per entity and step (" << counters.n_steps
+            << " steps, " << n_entities << " entities";
+  if (n_threads > 1) {
+    std::cout << ", stepping thread only";
+  }
+  std::cout << ")\n  phase      ";
+  for (int event = 0; event < csci3081::kNumPerfEvents; ++event) {
+    std::cout << std::setw(14) << csci3081::PerfCounters::EventName(
+      static_cast<csci3081::PerfEvent>(event));
+  }
+  std::cout << std::setw(8) << "ipc" << "\n";
+  double per = static_cast<double>(counters.n_steps) *
+               std::max<size_t>(n_entities, 1);
+  std::cout << std::fixed << std::setprecision(1);
+  for (int phase = 0; phase < csci3081::kNumStepPhases; ++phase) {
+    const uint64_t *counts = counters.phase_counts[phase];
+    std::cout << "  " << std::left << std::setw(11)
+              << csci3081::StepProfiler::PhaseName(
+                   static_cast<csci3081::StepPhase>(phase))
+              << std::right;
+    for (int event = 0; event < csci3081::kNumPerfEvents; ++event) {
+      if (counters.counted[event]) {
+        std::cout << std::setw(14) << counts[event] / per;
+      } else {
+        std::cout << std::setw(14) << "n/a";
+      }
+    }
+    if (counts[csci3081::kPerfCycles] > 0) {
+      std::cout << std::setw(8) << std::setprecision(2)
+                << static_cast<double>(counts[csci3081::kPerfInstructions]) /
+                   counts[csci3081::kPerfCycles]
+                << std::setprecision(1);
+    }
+    std::cout << "\n";
+  }
+  std::cout << std::defaultfloat << std::setprecision(6) << std::flush;
+}
+
+/* Run options.runs seeds of the same setup and print one line per run. */
+static int RunEnsemble(const csci3081::arena_params &params,
+                       const sim_options &options) {
+  uint64_t first_seed = (params.seed != 0) ? params.seed : 1;
+  std::vector<csci3081::EnsembleRun> runs(options.runs);
+  for (long k = 0; k < options.runs; ++k) {
+    runs[k].params = params;
+    runs[k].params.seed = first_seed + k;
+    runs[k].f_e_ratio = options.f_e_ratio;
+    runs[k].light_intensity = options.light_intensity;
+    runs[k].max_steps = static_cast<uint64_t>(options.steps);
+  }
+
+  csci3081::EnsembleRunner runner(options.threads);
+  auto start = std::chrono::steady_clock::now();
+  std::vector<csci3081::EnsembleOutcome> outcomes = runner.Run(runs);
+  double run_s = std::chrono::duration<double>(
+    std::chrono::steady_clock::now() - start).count();
+
+  std::cout << "seed steps status starved meals\n";
+  long n_lost = 0;
+  for (auto &outcome : outcomes) {
+    n_lost += outcome.lost ? 1 : 0;
+    std::cout << outcome.seed << " " << outcome.steps << " "
+              << (outcome.lost ? "lost" : "playing") << " "
+              << outcome.n_starved << " " << outcome.n_food_collisions << "\n";
+  }
+  std::cout << "runs " << options.runs << " lost " << n_lost
+            << " threads " << runner.get_n_threads()
+            << " arenas built " << runner.get_n_arenas_built()
+            << " in " << run_s << " s" << std::endl;
+  return 0;
+}
+
+int main(int argc, char **argv) {
+  csci3081::arena_params params;
+  sim_options options;
+
+  for (int i = 1; i < argc; ++i) {
+    std::string arg = argv[i];
+    if (arg == "-h" || arg == "--help") {
+      PrintUsage(argv[0]);
+      return 0;
+    }
+    if (arg.compare(0, 2, "--") != 0 || i + 1 >= argc) {
+      PrintUsage(argv[0]);
+      return 1;
+    }
+    std::string key = arg.substr(2);
+    std::string value = argv[++i];
+    bool ok = (key == "params") ? ReadParamsFile(value, &params, &options)
+                                : SetOption(key, value, &params, &options);
+    if (!ok) {
+      std::cerr << "arenasim: bad option " << arg << " " << value << std::endl;
+      return 1;
+    }
+  }
+
+  if (!options.trace_file.empty() &&
+      !csci3081::Tracer::Start(options.trace_file)) {
+    std::cerr << "arenasim: cannot write " << options.trace_file << std::endl;
+    return 1;
+  }
+  csci3081::Tracer::SetThreadName("main");
+  if (options.runs > 1) {
+    int status = RunEnsemble(params, options);
+    csci3081::Tracer::Stop();
+    return status;
+  }
+
+  long steps = options.steps;
+  std::signal(SIGUSR1, RequestDump);
+  auto build_start = std::chrono::steady_clock::now();
+  csci3081::Arena *arena = nullptr;
+  if (options.restore_file.empty()) {
+    arena = new csci3081::Arena(&params);
+    arena->set_f_e_ratio(options.f_e_ratio);
+    for (auto &ent : arena->get_entities()) {
+      if (ent->get_type() == csci3081::kLight) {
+        ent->set_intensity(options.light_intensity);
+      }
+    }
+  } else {
+    // The checkpoint has the arena, its ratio and intensities; only the
+    // thread count may be changed.
+    std::string error;
+    arena = csci3081::LoadCheckpoint(options.restore_file, &error,
+                                     options.threads);
+    if (arena == nullptr) {
+      std::cerr << "arenasim: cannot restore: " << error << std::endl;
+      return 1;
+    }
+    params = arena->get_params();
+  }
+  arena->set_step_budget(options.step_budget_ms / 1000.0);
+  if (options.perf_counters && !arena->EnableStepCounters()) {
+    std::cerr << "arenasim: perf counters unavailable ("
+              << arena->GetStepCounters().error << "), running without them"
+              << std::endl;
+  }
+  csci3081::MetricsExporter exporter(options.metrics_socket);
+  bool exporting = !options.metrics_socket.empty();
+  if (exporting && !exporter.Start()) {
+    std::cerr << "arenasim: cannot serve metrics: " << exporter.get_error()
+              << std::endl;
+    return 1;
+  }
+  csci3081::TrajectoryRecorder recorder(options.trajectory_file);
+  bool recording = !options.trajectory_file.empty();
+  if (recording && !recorder.Open(arena)) {
+    std::cerr << "arenasim: cannot record: " << recorder.get_error()
+              << std::endl;
+    return 1;
+  }
+  bool snapshotting = options.snapshot_every > 0 &&
+                      !options.checkpoint_file.empty();
+  csci3081::BackgroundCheckpointer checkpointer(
+    options.checkpoint_file,
+    snapshotting ? static_cast<uint64_t>(options.snapshot_every) : 0);
+  auto run_start = std::chrono::steady_clock::now();
+  csci3081::alloc_stats allocs_before = csci3081::GetAllocStats();
+  for (long i = 0; i < steps; ++i) {
+    arena->UpdateEntitiesTimestep();
+    if (recording) {
+      recorder.Record(*arena);
+    }
+    if (exporting) {
+      exporter.Sample(*arena);
+    }
+    if (dump_requested) {
+      dump_requested = 0;
+      arena->get_step_histogram().Dump(std::cerr, "step");
+    }
+    checkpointer.AfterStep(*arena);
+    bool checkpoint_due = !snapshotting && options.checkpoint_every > 0 &&
+                          (i + 1) % options.checkpoint_every == 0;
+    if (checkpoint_due && !options.checkpoint_file.empty() &&
+        !WriteCheckpoint(*arena, options.checkpoint_file)) {
+      return 1;
+    }
+  }
+  csci3081::alloc_stats allocs_after = csci3081::GetAllocStats();
+  auto run_end = std::chrono::steady_clock::now();
+  if (recording && !recorder.Close()) {
+    std::cerr << "arenasim: recording failed: " << recorder.get_error()
+              << std::endl;
+  }
+  csci3081::Tracer::Stop();
+  // The last checkpoint must not race a child writing the same file.
+  checkpointer.Wait();
+  if (!options.checkpoint_file.empty() &&
+      !WriteCheckpoint(*arena, options.checkpoint_file)) {
+    return 1;
+  }
+  csci3081::step_stats stats = arena->GetStepStats();
+  csci3081::step_counters counters = arena->GetStepCounters();
+  bool lost = arena->get_game_status() == LOST;
+  arena->Reset();
+  auto reset_end = std::chrono::steady_clock::now();
+
+  double build_s =
+    std::chrono::duration<double>(run_start - build_start).count();
+  double run_s = std::chrono::duration<double>(run_end - run_start).count();
+  double reset_s =
+    std::chrono::duration<double>(reset_end - run_end).count();
+  std::cout << "robots " << params.n_robots
+            << " lights " << params.n_lights
+            << " foods " << params.n_foods
+            << " arena " << params.x_dim << "x" << params.y_dim
+            << " threads " << arena->get_n_threads() << "\n"
+            << (options.restore_file.empty() ? "build " : "restore ")
+            << build_s << " s reset " << reset_s << " s\n"
+            << "steps " << steps << " in " << run_s << " s\n"
+            << "steps/sec " << (run_s > 0 ? steps / run_s : 0.0) << "\n"
+            << "sensing error bound " << arena->get_sensing_error_bound()
+            << " cutoff light " << arena->get_sensing_cutoff(csci3081::kLight)
+            << " food " << arena->get_sensing_cutoff(csci3081::kFood) << "\n"
+            << "status "
+            << (lost ? "lost" : "playing")
+            << std::endl;
+  if (stats.n_steps > 0) {
+    std::cout << "last " << std::min<uint64_t>(stats.n_steps, PROFILER_WINDOW)
+              << " steps: mean " << stats.step_mean_ms << " ms max "
+              << stats.step_max_ms << " ms\n";
+    for (int phase = 0; phase < csci3081::kNumStepPhases; ++phase) {
+      std::cout << "  phase "
+                << csci3081::StepProfiler::PhaseName(
+                     static_cast<csci3081::StepPhase>(phase))
+                << " mean " << stats.phase_mean_ms[phase] << " ms max "
+                << stats.phase_max_ms[phase] << " ms\n";
+    }
+    std::cout << std::flush;
+  }
+  arena->get_step_histogram().Dump(std::cout, "step");
+  if (recording) {
+    uint64_t n_frames = recorder.get_n_frames();
+    std::cout << "trajectory " << n_frames << " frames "
+              << recorder.get_n_bytes() << " bytes ("
+              << (n_frames > 0 ? recorder.get_n_bytes() / n_frames : 0)
+              << " per frame), stalled " << recorder.get_stall_time()
+              << " s" << std::endl;
+    recorder.get_record_histogram().Dump(std::cout, "trajectory record");
+  }
+  if (snapshotting) {
+    std::cout << "snapshots " << checkpointer.get_n_written() << " written "
+              << checkpointer.get_n_failed() << " failed "
+              << checkpointer.get_n_delayed() << " delayed by the one before"
+              << std::endl;
+    checkpointer.get_pause_histogram().Dump(std::cout, "snapshot pause");
+    checkpointer.get_latency_histogram().Dump(std::cout, "snapshot write");
+  }
+  if (counters.available) {
+    PrintCounters(counters, params.n_robots + params.n_lights + params.n_foods,
+                  arena->get_n_threads());
+  }
+  if (csci3081::AllocCountingEnabled()) {
+    std::cout << "allocations "
+              << allocs_after.n_allocations - allocs_before.n_allocations
+              << " (" << allocs_after.n_bytes - allocs_before.n_bytes
+              << " bytes) while stepping" << std::endl;
+  }
+  for (auto &pool : csci3081::GetPoolStats()) {
+    std::cout << "pool " << pool.name << " live " << pool.n_live << " ("
+              << pool.n_live_bytes << " bytes) reserved "
+              << pool.n_reserved_bytes << " bytes" << std::endl;
+  }
+  delete arena;
+  return 0;
+}
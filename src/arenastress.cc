@@ -0,0 +1,367 @@
+/**
+ * @file arenastress.cc
+ *
+ * @copyright 2018 3081 Staff, All rights reserved.
+ *
+ * Scaling stress harness: builds headless Arenas of growing population and
+ * reports, for each, the build time, the time to the first step, the mean
+ * time per step and the peak memory. It fits how the step time grows with
+ * the population, and can compare the results against a stored baseline.
+ *
+ * The arena grows with the population, so the density of entities stays
+ * that of the default arena. The sweep stops early once a step takes longer
+ * than --time-limit: that is where the arena falls over.
+ */
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <sys/resource.h>
+
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "src/arena.h"
+#include "src/arena_params.h"
+#include "src/params.h"
+
+/*******************************************************************************
+ * Constants
+ ******************************************************************************/
+// Small arenas step for at least this long, so their step time is not noise.
+static const double kMinTimedSeconds = 0.25;
+
+/*******************************************************************************
+ * Structure Definitions
+ ******************************************************************************/
+struct stress_options {
+  size_t min_population{10};
+  size_t max_population{1000000};
+  size_t factor{10};
+  // Which counts follow the population: "all", "robots", "lights" or
+  // "foods". The others keep their defaults.
+  std::string sweep{"all"};
+  long steps{10};
+  int threads{1};
+  uint64_t seed{1};
+  // Stop the sweep once building, or one step, takes longer than this.
+  double time_limit{30.0};
+  std::string baseline{};
+  std::string save_baseline{};
+  // Flag a step time more than this fraction above the baseline.
+  double margin{0.25};
+};
+
+/* The results for one population. */
+struct stress_point {
+  csci3081::arena_params params{};
+  size_t n_entities{0};
+  double build_s{0.0};
+  double first_step_s{0.0};
+  double step_s{0.0};
+  long peak_rss_kb{0};
+  bool completed{false};
+};
+
+/*******************************************************************************
+ * Non-Member Functions
+ ******************************************************************************/
+static void PrintUsage(const char *prog) {
+  std::cout
+    << "Usage: " << prog << " [options]\n"
+    << "  --min N            smallest population (default 10)\n"
+    << "  --max N            largest population (default 1000000)\n"
+    << "  --factor N         population growth per point (default 10)\n"
+    << "  --sweep S          counts to grow: all, robots, lights or foods"
+    << " (default all)\n"
+    << "  --steps N          least timesteps timed per point, after the"
+    << " first (default 10)\n"
+    << "  --threads N        threads used to step the arena (default 1)\n"
+    << "  --seed N           seed for entity placement (default 1)\n"
+    << "  --time-limit S     stop once building or one step takes longer"
+    << " than S seconds (default 30)\n"
+    << "  --baseline FILE    flag points slower than the step times in"
+    << " FILE\n"
+    << "  --margin M         allowed slowdown over the baseline, as a"
+    << " fraction (default 0.25)\n"
+    << "  --save-baseline FILE  write this run's step times to FILE\n";
+}
+
+static bool SetOption(const std::string &key, const std::string &value,
+                      stress_options *options) {
+  char *end = nullptr;
+  if (key == "sweep") {
+    if (value != "all" && value != "robots" && value != "lights" &&
+        value != "foods") {
+      return false;
+    }
+    options->sweep = value;
+    return true;
+  } else if (key == "baseline") {
+    options->baseline = value;
+    return true;
+  } else if (key == "save-baseline") {
+    options->save_baseline = value;
+    return true;
+  } else if (key == "time-limit" || key == "margin") {
+    double real = std::strtod(value.c_str(), &end);
+    if (value.empty() || *end != '\0' || real < 0) {
+      return false;
+    }
+    (key == "margin" ? options->margin : options->time_limit) = real;
+    return true;
+  }
+  long number = std::strtol(value.c_str(), &end, 10);
+  if (value.empty() || *end != '\0' || number < 0) {
+    return false;
+  }
+  if (key == "min") {
+    options->min_population = static_cast<size_t>(number);
+  } else if (key == "max") {
+    options->max_population = static_cast<size_t>(number);
+  } else if (key == "factor" && number > 1) {
+    options->factor = static_cast<size_t>(number);
+  } else if (key == "steps") {
+    options->steps = number;
+  } else if (key == "threads") {
+    options->threads = static_cast<int>(number);
+  } else if (key == "seed") {
+    options->seed = static_cast<uint64_t>(number);
+  } else {
+    return false;
+  }
+  return true;
+}
+
+/* The Arena for one population. Its area grows with the entity count, so
+ * that the density stays that of the default arena.
+ */
+static csci3081::arena_params ScaledParams(size_t population,
+                                           const stress_options &options) {
+  csci3081::arena_params params;
+  bool all = options.sweep == "all";
+  if (all || options.sweep == "robots") {
+    params.n_robots = population;
+  }
+  if (all || options.sweep == "lights") {
+    params.n_lights = population;
+  }
+  if (all || options.sweep == "foods") {
+    params.n_foods = population;
+  }
+  params.n_threads = options.threads;
+  params.seed = options.seed;
+
+  double n_default = N_ROBOTS + N_LIGHTS + N_FOODS;
+  double n_entities = params.n_robots + params.n_lights + params.n_foods;
+  double scale = std::sqrt(n_entities / n_default);
+  if (scale > 1.0) {
+    params.x_dim = static_cast<uint>(std::lround(ARENA_X_DIM * scale));
+    params.y_dim = static_cast<uint>(std::lround(ARENA_Y_DIM * scale));
+  }
+  return params;
+}
+
+/* The process's peak resident set so far, in KiB. */
+static long PeakRssKb() {
+  struct rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+  return usage.ru_maxrss;
+}
+
+static double SecondsSince(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double>(
+    std::chrono::steady_clock::now() - start).count();
+}
+
+static stress_point RunPoint(size_t population,
+                             const stress_options &options) {
+  stress_point point;
+  point.params = ScaledParams(population, options);
+  point.n_entities = point.params.n_robots + point.params.n_lights +
+                     point.params.n_foods;
+
+  auto start = std::chrono::steady_clock::now();
+  csci3081::Arena arena(&point.params);
+  point.build_s = SecondsSince(start);
+  if (point.build_s > options.time_limit) {
+    point.peak_rss_kb = PeakRssKb();
+    return point;
+  }
+  arena.UpdateEntitiesTimestep();
+  point.first_step_s = SecondsSince(start);
+  double step_limit = options.time_limit;
+  if (point.first_step_s - point.build_s > step_limit) {
+    point.step_s = point.first_step_s - point.build_s;
+    point.peak_rss_kb = PeakRssKb();
+    return point;
+  }
+
+  auto steps_start = std::chrono::steady_clock::now();
+  long steps = 0;
+  double run_s = 0.0;
+  while (steps < options.steps || run_s < kMinTimedSeconds) {
+    arena.UpdateEntitiesTimestep();
+    ++steps;
+    run_s = SecondsSince(steps_start);
+    if (run_s > step_limit * steps) {
+      break;
+    }
+  }
+  point.step_s = run_s / steps;
+  point.peak_rss_kb = PeakRssKb();
+  point.completed = point.step_s < step_limit;
+  return point;
+}
+
+/* The least-squares slope of log(step time) against log(entities): the
+ * exponent k in step time ~ entities^k.
+ */
+static double GrowthExponent(const std::vector<stress_point> &points) {
+  double n = 0, sum_x = 0, sum_y = 0, sum_xx = 0, sum_xy = 0;
+  for (auto &point : points) {
+    if (!point.completed || !(point.step_s > 0)) {
+      continue;
+    }
+    double x = std::log(static_cast<double>(point.n_entities));
+    double y = std::log(point.step_s);
+    n += 1;
+    sum_x += x;
+    sum_y += y;
+    sum_xx += x * x;
+    sum_xy += x * y;
+  }
+  double denominator = n * sum_xx - sum_x * sum_x;
+  if (n < 2 || !(denominator > 0)) {
+    return 0.0;
+  }
+  return (n * sum_xy - sum_x * sum_y) / denominator;
+}
+
+/* Baseline files hold one "entities step_seconds" pair per line, with #
+ * comments, as written by --save-baseline.
+ */
+static bool ReadBaseline(const std::string &path,
+                         std::map<size_t, double> *baseline) {
+  std::ifstream in(path);
+  if (!in) {
+    std::cerr << "arenastress: cannot open " << path << std::endl;
+    return false;
+  }
+  std::string line;
+  while (std::getline(in, line)) {
+    std::istringstream fields(line.substr(0, line.find('#')));
+    size_t n_entities = 0;
+    double step_s = 0.0;
+    if (fields >> n_entities >> step_s) {
+      (*baseline)[n_entities] = step_s;
+    }
+  }
+  return true;
+}
+
+static bool WriteBaseline(const std::string &path,
+                          const std::vector<stress_point> &points) {
+  std::ofstream out(path);
+  if (!out) {
+    std::cerr << "arenastress: cannot write " << path << std::endl;
+    return false;
+  }
+  out << "# entities step_seconds\n";
+  for (auto &point : points) {
+    if (point.completed) {
+      out << point.n_entities << " " << point.step_s << "\n";
+    }
+  }
+  return true;
+}
+
+int main(int argc, char **argv) {
+  stress_options options;
+  for (int i = 1; i < argc; ++i) {
+    std::string arg = argv[i];
+    if (arg == "-h" || arg == "--help") {
+      PrintUsage(argv[0]);
+      return 0;
+    }
+    if (arg.compare(0, 2, "--") != 0 || i + 1 >= argc) {
+      PrintUsage(argv[0]);
+      return 1;
+    }
+    std::string value = argv[++i];
+    if (!SetOption(arg.substr(2), value, &options)) {
+      std::cerr << "arenastress: bad option " << arg << " " << value
+                << std::endl;
+      return 1;
+    }
+  }
+
+  std::map<size_t, double> baseline;
+  if (!options.baseline.empty() && !ReadBaseline(options.baseline,
+                                                 &baseline)) {
+    return 1;
+  }
+
+  std::cout << "entities robots lights foods arena build_s first_step_s"
+            << " step_s peak_rss_mb exponent status\n";
+  std::vector<stress_point> points;
+  int n_regressions = 0;
+  for (size_t population = std::max<size_t>(options.min_population, 1);
+       population <= options.max_population;
+       population *= options.factor) {
+    stress_point point = RunPoint(population, options);
+    points.push_back(point);
+
+    // The exponent between this point and the previous one.
+    double local_exponent = 0.0;
+    if (points.size() > 1 && points[points.size() - 2].completed &&
+        point.completed) {
+      const stress_point &previous = points[points.size() - 2];
+      local_exponent = std::log(point.step_s / previous.step_s) /
+        std::log(static_cast<double>(point.n_entities) /
+                 previous.n_entities);
+    }
+    std::string status = point.completed ? "ok" : "over-limit";
+    auto expected = baseline.find(point.n_entities);
+    if (point.completed && expected != baseline.end() &&
+        point.step_s > expected->second * (1.0 + options.margin)) {
+      status = "SLOWER";
+      ++n_regressions;
+    }
+    std::cout << point.n_entities << " " << point.params.n_robots << " "
+              << point.params.n_lights << " " << point.params.n_foods << " "
+              << point.params.x_dim << "x" << point.params.y_dim << " "
+              << point.build_s << " " << point.first_step_s << " "
+              << point.step_s << " "
+              << std::fixed << std::setprecision(1)
+              << point.peak_rss_kb / 1024.0 << " "
+              << std::setprecision(2) << local_exponent
+              << std::defaultfloat << std::setprecision(6) << " "
+              << status << std::endl;
+    if (!point.completed) {
+      break;
+    }
+  }
+
+  std::cout << "growth exponent " << GrowthExponent(points)
+            << " (step time ~ entities^k)\n"
+            << "regressions " << n_regressions;
+  if (!baseline.empty()) {
+    std::cout << " (margin " << options.margin * 100 << "% over "
+              << options.baseline << ")";
+  }
+  std::cout << std::endl;
+  if (!options.save_baseline.empty() &&
+      !WriteBaseline(options.save_baseline, points)) {
+    return 1;
+  }
+  return n_regressions > 0 ? 2 : 0;
+}
@@ -0,0 +1,161 @@
+/**
+ * @file background_checkpointer.cc
+ *
+ * @copyright 2018 3081 Staff, All rights reserved.
+ */
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <fcntl.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+
+#include "src/background_checkpointer.h"
+#include "src/checkpoint.h"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+NAMESPACE_BEGIN(csci3081);
+
+/*******************************************************************************
+ * Non-Member Functions
+ ******************************************************************************/
+static int64_t NowNanos() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+    std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/* The body of the child: save, report when it finished, and exit without
+ * running any of the parent's exit handlers or flushing its buffers.
+ */
+static void RunChild(const Arena &arena, const std::string &path,
+                     int finish_fd) {
+  std::string error;
+  bool ok = SaveCheckpoint(arena, path, &error);
+  if (!ok) {
+    std::string line = "checkpoint child: " + error + "\n";
+    ssize_t n = write(STDERR_FILENO, line.data(), line.size());
+    static_cast<void>(n);
+  }
+  // steady_clock is CLOCK_MONOTONIC, which both processes share.
+  int64_t finish = NowNanos();
+  ssize_t n = write(finish_fd, &finish, sizeof(finish));
+  static_cast<void>(n);
+  _exit(ok ? 0 : 1);
+}
+
+/*******************************************************************************
+ * Constructors/Destructor
+ ******************************************************************************/
+BackgroundCheckpointer::BackgroundCheckpointer(const std::string &path,
+                                               uint64_t interval)
+    : path_(path), interval_(interval) {}
+
+BackgroundCheckpointer::~BackgroundCheckpointer() { Wait(); }
+
+/*******************************************************************************
+ * Member Functions
+ ******************************************************************************/
+void BackgroundCheckpointer::AfterStep(const Arena &arena) {
+  Poll();
+  if (interval_ == 0 || ++steps_since_start_ < interval_) {
+    return;
+  }
+  if (child_ > 0) {
+    if (!delayed_) {
+      delayed_ = true;
+      ++n_delayed_;
+    }
+    return;
+  }
+  delayed_ = false;
+  // A failed fork is retried an interval later, not every step.
+  if (!Start(arena)) {
+    steps_since_start_ = 0;
+  }
+} /* AfterStep() */
+
+bool BackgroundCheckpointer::Start(const Arena &arena) {
+  if (child_ > 0) {
+    return false;
+  }
+  int fds[2];
+  if (pipe2(fds, O_CLOEXEC) < 0) {
+    error_ = std::string("pipe: ") + strerror(errno);
+    return false;
+  }
+  auto start = std::chrono::steady_clock::now();
+  pid_t pid = fork();
+  if (pid == 0) {
+    close(fds[0]);
+    RunChild(arena, path_, fds[1]);
+  }
+  auto resumed = std::chrono::steady_clock::now();
+  close(fds[1]);
+  if (pid < 0) {
+    close(fds[0]);
+    error_ = std::string("fork: ") + strerror(errno);
+    return false;
+  }
+  pause_.Record(std::chrono::duration<double>(resumed - start).count());
+  child_ = pid;
+  finish_fd_ = fds[0];
+  fork_time_ = start;
+  steps_since_start_ = 0;
+  return true;
+} /* Start() */
+
+bool BackgroundCheckpointer::Poll() {
+  if (child_ <= 0) {
+    return false;
+  }
+  int status = 0;
+  pid_t done = waitpid(child_, &status, WNOHANG);
+  if (done == 0 || (done < 0 && errno == EINTR)) {
+    return true;
+  }
+  Collect(done == child_ ? status : -1);
+  return false;
+} /* Poll() */
+
+void BackgroundCheckpointer::Wait() {
+  if (child_ <= 0) {
+    return;
+  }
+  int status = 0;
+  pid_t done;
+  do {
+    done = waitpid(child_, &status, 0);
+  } while (done < 0 && errno == EINTR);
+  Collect(done == child_ ? status : -1);
+} /* Wait() */
+
+void BackgroundCheckpointer::Collect(int status) {
+  // A child that died before it could say when it finished is taken to have
+  // finished now.
+  int64_t finish = 0;
+  if (read(finish_fd_, &finish, sizeof(finish)) !=
+      static_cast<ssize_t>(sizeof(finish))) {
+    finish = NowNanos();
+  }
+  close(finish_fd_);
+  finish_fd_ = -1;
+  int64_t start = std::chrono::duration_cast<std::chrono::nanoseconds>(
+    fork_time_.time_since_epoch()).count();
+  latency_.Record((finish - start) * 1e-9);
+
+  if (status >= 0 && WIFEXITED(status) && WEXITSTATUS(status) == 0) {
+    ++n_written_;
+  } else {
+    ++n_failed_;
+    error_ = "checkpoint child " + std::to_string(child_) + " failed";
+  }
+  child_ = -1;
+} /* Collect() */
+
+NAMESPACE_END(csci3081);
@@ -0,0 +1,128 @@
+/**
+ * @file background_checkpointer.h
+ *
+ * @copyright 2018 3081 Staff, All rights reserved.
+ */
+
+#ifndef SRC_BACKGROUND_CHECKPOINTER_H_
+#define SRC_BACKGROUND_CHECKPOINTER_H_
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <sys/types.h>
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+#include "src/arena.h"
+#include "src/common.h"
+#include "src/latency_histogram.h"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+NAMESPACE_BEGIN(csci3081);
+
+/*******************************************************************************
+ * Class Definitions
+ ******************************************************************************/
+/**
+ * @brief Writes checkpoints of an Arena from a forked child process, so that
+ * the simulation keeps stepping while they are written.
+ *
+ * fork() gives the child a copy-on-write image of the Arena as of the step
+ * boundary it was called at; the child saves it with SaveCheckpoint() and
+ * exits, while the parent only pays for copying its page tables (the pause)
+ * and for the pages it writes to before the child is done. At most one child
+ * is in flight: a checkpoint that falls due while one is being written waits
+ * for the next step boundary after it finishes.
+ *
+ * All calls must come from the thread that steps the Arena, between steps.
+ * The child runs only SaveCheckpoint(), which takes no locks that the
+ * Arena's other threads might hold.
+ */
+class BackgroundCheckpointer {
+ public:
+  /**
+   * @param path The checkpoint file; each checkpoint replaces the last.
+   * @param interval Steps between checkpoints taken by AfterStep(); 0 is
+   * none.
+   */
+  BackgroundCheckpointer(const std::string &path, uint64_t interval);
+  ~BackgroundCheckpointer();
+
+  BackgroundCheckpointer(const BackgroundCheckpointer &other) = delete;
+  BackgroundCheckpointer &operator=(const BackgroundCheckpointer &other) =
+    delete;
+
+  /**
+   * @brief Count a step of `arena`, collect a finished child and start a
+   * checkpoint if one is due and none is in flight.
+   */
+  void AfterStep(const Arena &arena);
+
+  /**
+   * @brief Fork a child that checkpoints `arena` as it is now.
+   *
+   * @return false if a child is still in flight, or (see get_error()) if
+   * fork() failed.
+   */
+  bool Start(const Arena &arena);
+
+  /**
+   * @brief Collect the child if it has finished, without blocking.
+   *
+   * @return Whether a child is still in flight.
+   */
+  bool Poll();
+
+  /**
+   * @brief Block until the child in flight, if any, has finished.
+   */
+  void Wait();
+
+  bool is_in_flight() const { return child_ > 0; }
+  const std::string &get_error() const { return error_; }
+
+  // Checkpoints written, and children that failed to write theirs.
+  uint64_t get_n_written() const { return n_written_; }
+  uint64_t get_n_failed() const { return n_failed_; }
+  // Checkpoints that fell due while a child was in flight.
+  uint64_t get_n_delayed() const { return n_delayed_; }
+
+  /**
+   * @brief How long fork() stalled the stepping thread.
+   */
+  const LatencyHistogram &get_pause_histogram() const { return pause_; }
+
+  /**
+   * @brief How long after fork() each child finished writing.
+   */
+  const LatencyHistogram &get_latency_histogram() const { return latency_; }
+
+ private:
+  void Collect(int status);
+
+  std::string path_;
+  uint64_t interval_;
+  uint64_t steps_since_start_{0};
+  bool delayed_{false};
+
+  pid_t child_{-1};
+  // Read end of a pipe the child sends its finish time over.
+  int finish_fd_{-1};
+  std::chrono::steady_clock::time_point fork_time_{};
+
+  std::string error_{};
+  uint64_t n_written_{0};
+  uint64_t n_failed_{0};
+  uint64_t n_delayed_{0};
+  LatencyHistogram pause_{};
+  LatencyHistogram latency_{};
+};
+
+NAMESPACE_END(csci3081);
+
+#endif  // SRC_BACKGROUND_CHECKPOINTER_H_
@@ -0,0 +1,200 @@
+/**
+ * @file broad_phase.cc
+ *
+ * @copyright 2018 3081 Staff, All rights reserved.
+ */
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <algorithm>
+#include <cmath>
+
+#include "src/broad_phase.h"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+NAMESPACE_BEGIN(csci3081);
+
+/*******************************************************************************
+ * Static Variables
+ ******************************************************************************/
+constexpr unsigned BroadPhase::kReactMask[];
+
+/*******************************************************************************
+ * Non-Member Functions
+ ******************************************************************************/
+static bool PairLess(const CollisionPair &a, const CollisionPair &b) {
+  return a.first < b.first || (a.first == b.first && a.second < b.second);
+}
+
+static CollisionPair MakePair(int a, int b) {
+  return (a < b) ? CollisionPair{a, b} : CollisionPair{b, a};
+}
+
+/*******************************************************************************
+ * Member Functions
+ ******************************************************************************/
+BroadPhase *BroadPhase::Create(BroadPhaseType type) {
+  switch (type) {
+    case (kSpatialHash):
+      return new SpatialHashGrid;
+    case (kSortAndSweep):
+      return new SortAndSweep;
+    case (kBruteForce):
+      return nullptr;
+    default:
+      return nullptr;
+  }
+}
+
+void SpatialHashGrid::FindPairs(const EntityStore &store,
+                                std::vector<CollisionPair> *pairs) {
+  pairs->clear();
+  int n = static_cast<int>(store.size());
+  if (n < 2) {
+    return;
+  }
+  const double *x = store.x();
+  const double *y = store.y();
+  const double *radius = store.radius();
+
+  // Bounds of everything, and the biggest entity, decide the grid shape.
+  double min_x = x[0];
+  double min_y = y[0];
+  double max_x = min_x;
+  double max_y = min_y;
+  double max_radius = 0.0;
+  for (int i = 0; i < n; ++i) {
+    min_x = std::min(min_x, x[i]);
+    min_y = std::min(min_y, y[i]);
+    max_x = std::max(max_x, x[i]);
+    max_y = std::max(max_y, y[i]);
+    max_radius = std::max(max_radius, radius[i]);
+  }
+  double cell_size = std::max(2.0 * max_radius, 1.0);
+  // Never use more than ~4 cells per entity.
+  double max_cells = 4.0 * n;
+  while (std::ceil((max_x - min_x + 1) / cell_size) *
+         std::ceil((max_y - min_y + 1) / cell_size) > max_cells) {
+    cell_size *= 2.0;
+  }
+  n_cols_ = static_cast<int>((max_x - min_x) / cell_size) + 1;
+  n_rows_ = static_cast<int>((max_y - min_y) / cell_size) + 1;
+  int n_cells = n_cols_ * n_rows_;
+
+  // Counting sort of the entities into their cells. The cap above bounds the
+  // cell count, so reserving for it once keeps later steps from allocating.
+  cell_start_.reserve(4 * n + 1);
+  cell_start_.assign(n_cells + 1, 0);
+  item_cell_.resize(n);
+  for (int i = 0; i < n; ++i) {
+    int col = static_cast<int>((x[i] - min_x) / cell_size);
+    int row = static_cast<int>((y[i] - min_y) / cell_size);
+    col = std::min(std::max(col, 0), n_cols_ - 1);
+    row = std::min(std::max(row, 0), n_rows_ - 1);
+    item_cell_[i] = row * n_cols_ + col;
+    ++cell_start_[item_cell_[i] + 1];
+  }
+  for (int c = 0; c < n_cells; ++c) {
+    cell_start_[c + 1] += cell_start_[c];
+  }
+  cell_items_.resize(n);
+  for (int i = 0; i < n; ++i) {
+    cell_items_[cell_start_[item_cell_[i]]++] = i;
+  }
+  // The fill pass advanced each start to the next cell's start; shift back.
+  for (int c = n_cells; c > 0; --c) {
+    cell_start_[c] = cell_start_[c - 1];
+  }
+  cell_start_[0] = 0;
+
+  const EntityType *type = store.type();
+  for (int row = 0; row < n_rows_; ++row) {
+    for (int col = 0; col < n_cols_; ++col) {
+      int cell = row * n_cols_ + col;
+      if (cell_start_[cell] == cell_start_[cell + 1]) {
+        continue;
+      }
+      AddCellPairs(type, cell, cell, pairs);
+      if (col + 1 < n_cols_) {
+        AddCellPairs(type, cell, cell + 1, pairs);
+      }
+      if (row + 1 < n_rows_) {
+        if (col > 0) {
+          AddCellPairs(type, cell, cell + n_cols_ - 1, pairs);
+        }
+        AddCellPairs(type, cell, cell + n_cols_, pairs);
+        if (col + 1 < n_cols_) {
+          AddCellPairs(type, cell, cell + n_cols_ + 1, pairs);
+        }
+      }
+    }
+  }
+  std::sort(pairs->begin(), pairs->end(), PairLess);
+} /* FindPairs() */
+
+void SpatialHashGrid::AddCellPairs(const EntityType *type, int cell,
+                                   int other_cell,
+                                   std::vector<CollisionPair> *pairs) const {
+  for (int a = cell_start_[cell]; a < cell_start_[cell + 1]; ++a) {
+    int i = cell_items_[a];
+    // Within one cell, only look forward so each pair is seen once.
+    int b = (cell == other_cell) ? a + 1 : cell_start_[other_cell];
+    for (; b < cell_start_[other_cell + 1]; ++b) {
+      int j = cell_items_[b];
+      if (Interacts(type[i], type[j])) {
+        pairs->push_back(MakePair(i, j));
+      }
+    }
+  }
+} /* AddCellPairs() */
+
+void SortAndSweep::FindPairs(const EntityStore &store,
+                             std::vector<CollisionPair> *pairs) {
+  pairs->clear();
+  int n = static_cast<int>(store.size());
+  const double *x = store.x();
+  const double *y = store.y();
+  const double *radius = store.radius();
+  const EntityType *type = store.type();
+  intervals_.resize(n);
+  for (int i = 0; i < n; ++i) {
+    intervals_[i] = {x[i] - radius[i], x[i] + radius[i], i};
+  }
+  std::sort(intervals_.begin(), intervals_.end(),
+            [](const Interval &a, const Interval &b) {
+              return a.min_x < b.min_x ||
+                  (a.min_x <= b.min_x && a.index < b.index);
+            });
+
+  // At most every box is open at once.
+  active_.reserve(intervals_.size());
+  active_.clear();
+  for (auto &cur : intervals_) {
+    // Drop the boxes that closed before this one opened.
+    size_t kept = 0;
+    for (size_t k = 0; k < active_.size(); ++k) {
+      if (active_[k].max_x >= cur.min_x) {
+        active_[kept++] = active_[k];
+      }
+    }
+    active_.resize(kept);
+
+    int i = cur.index;
+    for (auto &open : active_) {
+      int j = open.index;
+      if (!Interacts(type[i], type[j])) {
+        continue;
+      }
+      if (std::fabs(y[i] - y[j]) <= radius[i] + radius[j]) {
+        pairs->push_back(MakePair(i, j));
+      }
+    }
+    active_.push_back(cur);
+  }
+  std::sort(pairs->begin(), pairs->end(), PairLess);
+} /* FindPairs() */
+
+NAMESPACE_END(csci3081);
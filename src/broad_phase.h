@@ -0,0 +1,160 @@
+/**
+ * @file broad_phase.h
+ *
+ * @copyright 2018 3081 Staff, All rights reserved.
+ */
+
+#ifndef SRC_BROAD_PHASE_H_
+#define SRC_BROAD_PHASE_H_
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <vector>
+
+#include "src/broad_phase_type.h"
+#include "src/common.h"
+#include "src/entity_store.h"
+#include "src/entity_type.h"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+NAMESPACE_BEGIN(csci3081);
+
+/*******************************************************************************
+ * Structure Definitions
+ ******************************************************************************/
+/**
+ * @brief An unordered pair of entities that might be colliding, stored as
+ * indices into the EntityStore handed to BroadPhase::FindPairs().
+ *
+ * `first` is always less than `second`, so each pair appears exactly once.
+ */
+struct CollisionPair {
+  int first;
+  int second;
+};
+
+/*******************************************************************************
+ * Class Definitions
+ ******************************************************************************/
+/**
+ * @brief Interface for the broad phase of collision detection.
+ *
+ * A broad phase cheaply narrows the N^2 possible entity pairs down to the
+ * pairs that are close enough to possibly collide. The Arena then runs the
+ * exact IsColliding() test (the narrow phase) on those pairs only.
+ *
+ * Type pairs that can never interact (lights ignore robots and food, robots
+ * ignore lights, nothing reacts to food) are rejected with a mask before any
+ * distance math is done. Pairs are returned sorted so that every backend
+ * resolves collisions in the same order.
+ */
+class BroadPhase {
+ public:
+  /**
+   * @brief Create the broad phase for the requested backend.
+   *
+   * @return The new broad phase, or nullptr for kBruteForce, which the Arena
+   * handles with its reference all-pairs loop.
+   */
+  static BroadPhase *Create(BroadPhaseType type);
+
+  BroadPhase() = default;
+  virtual ~BroadPhase() = default;
+  BroadPhase(const BroadPhase &other) = delete;
+  BroadPhase &operator=(const BroadPhase &other) = delete;
+
+  /**
+   * @brief Find every pair of entities whose bounding circles might overlap.
+   *
+   * @param[in] store The geometry of the entities to test.
+   * @param[out] pairs Cleared, then filled with the candidate pairs sorted by
+   * (first, second).
+   */
+  virtual void FindPairs(const EntityStore &store,
+                         std::vector<CollisionPair> *pairs) = 0;
+
+  /**
+   * @brief Whether an entity of type `self` reacts to touching an entity of
+   * type `other` (e.g. a robot reacts to food, food reacts to nothing).
+   */
+  static bool Reacts(EntityType self, EntityType other) {
+    return self <= kFood && other <= kFood &&
+        (kReactMask[self] & (1u << other)) != 0;
+  }
+
+  /**
+   * @brief Whether either entity of the pair reacts to the other. Pairs for
+   * which this is false are never considered.
+   */
+  static bool Interacts(EntityType a, EntityType b) {
+    return Reacts(a, b) || Reacts(b, a);
+  }
+
+ private:
+  // Indexed by the reacting type, one bit per type it reacts to.
+  static constexpr unsigned kReactMask[kFood + 1] = {
+    (1u << kRobot) | (1u << kFood),  // kRobot
+    (1u << kLight),                  // kLight
+    0u                               // kFood
+  };
+};
+
+/**
+ * @brief A uniform grid whose cells are at least as wide as the largest
+ * entity diameter, so colliding entities always sit in the same or in
+ * neighbouring cells.
+ *
+ * Entities are bucketed with a counting sort each step, and only the four
+ * "forward" neighbour cells are visited so each pair is produced once. The
+ * cell count is capped relative to the entity count so that sparse, very
+ * large arenas do not allocate huge grids.
+ */
+class SpatialHashGrid : public BroadPhase {
+ public:
+  SpatialHashGrid() = default;
+
+  void FindPairs(const EntityStore &store,
+                 std::vector<CollisionPair> *pairs) override;
+
+ private:
+  void AddCellPairs(const EntityType *type, int cell, int other_cell,
+                    std::vector<CollisionPair> *pairs) const;
+
+  int n_cols_{0};
+  int n_rows_{0};
+  // cell_start_[c] .. cell_start_[c + 1] indexes cell c's run in cell_items_.
+  std::vector<int> cell_start_{};
+  std::vector<int> cell_items_{};
+  std::vector<int> item_cell_{};
+};
+
+/**
+ * @brief Sort-and-sweep (sweep and prune) along the x axis.
+ *
+ * Entities are sorted by the left edge of their bounding box, then swept
+ * while keeping the set of boxes that are still open. Only open boxes whose
+ * y extents overlap are reported.
+ */
+class SortAndSweep : public BroadPhase {
+ public:
+  SortAndSweep() = default;
+
+  void FindPairs(const EntityStore &store,
+                 std::vector<CollisionPair> *pairs) override;
+
+ private:
+  struct Interval {
+    double min_x;
+    double max_x;
+    int index;
+  };
+  std::vector<Interval> intervals_{};
+  std::vector<Interval> active_{};
+};
+
+NAMESPACE_END(csci3081);
+
+#endif  // SRC_BROAD_PHASE_H_
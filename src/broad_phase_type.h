@@ -0,0 +1,32 @@
+/**
+ * @file broad_phase_type.h
+ *
+ * @copyright 2018 3081 Staff, All rights reserved.
+ */
+
+#ifndef SRC_BROAD_PHASE_TYPE_H_
+#define SRC_BROAD_PHASE_TYPE_H_
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include "src/common.h"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+NAMESPACE_BEGIN(csci3081);
+
+/**
+ * @brief The broad-phase collision backends the Arena can be built with.
+ *
+ * kBruteForce is the original all-pairs loop and is kept as the reference
+ * that the other backends are checked against.
+ */
+enum BroadPhaseType {
+  kBruteForce, kSpatialHash, kSortAndSweep
+};
+
+NAMESPACE_END(csci3081);
+
+#endif  // SRC_BROAD_PHASE_TYPE_H_
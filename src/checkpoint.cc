@@ -0,0 +1,302 @@
+/**
+ * @file checkpoint.cc
+ *
+ * @copyright 2018 3081 Staff, All rights reserved.
+ */
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+#include "src/checkpoint.h"
+#include "src/sensor.h"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+NAMESPACE_BEGIN(csci3081);
+
+/*******************************************************************************
+ * Constants
+ ******************************************************************************/
+static const char kMagic[8] = {'A', 'R', 'E', 'N', 'A', 'C', 'K', 'P'};
+static const uint32_t kByteOrderMark = 0x01020304;
+
+// Records are written this many at a time.
+static const size_t kWriteBatch = 4096;
+
+/*******************************************************************************
+ * Class Definitions
+ ******************************************************************************/
+/* A checkpoint file mapped read-only into memory, with its header checked. */
+class MappedCheckpoint {
+ public:
+  MappedCheckpoint() = default;
+  ~MappedCheckpoint() {
+    if (data_ != nullptr) {
+      munmap(data_, size_);
+    }
+  }
+
+  MappedCheckpoint(const MappedCheckpoint &other) = delete;
+  MappedCheckpoint &operator=(const MappedCheckpoint &other) = delete;
+
+  bool Open(const std::string &path, std::string *error);
+
+  const checkpoint_header &header() const {
+    return *static_cast<const checkpoint_header *>(data_);
+  }
+  const entity_state *entities() const {
+    return reinterpret_cast<const entity_state *>(
+      static_cast<const char *>(data_) + sizeof(checkpoint_header));
+  }
+  const sensor_state *sensors() const {
+    return reinterpret_cast<const sensor_state *>(
+      entities() + header().n_entities);
+  }
+
+ private:
+  void *data_{nullptr};
+  size_t size_{0};
+};
+
+bool MappedCheckpoint::Open(const std::string &path, std::string *error) {
+  int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0) {
+    *error = path + ": " + strerror(errno);
+    return false;
+  }
+  struct stat info;
+  if (fstat(fd, &info) < 0 ||
+      static_cast<size_t>(info.st_size) < sizeof(checkpoint_header)) {
+    close(fd);
+    *error = path + ": not a checkpoint (too short)";
+    return false;
+  }
+  size_ = static_cast<size_t>(info.st_size);
+  // Restoring reads every page once, in order.
+  void *data = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE | MAP_POPULATE,
+                    fd, 0);
+  close(fd);
+  if (data == MAP_FAILED) {
+    *error = path + ": " + strerror(errno);
+    return false;
+  }
+  data_ = data;
+  madvise(data_, size_, MADV_SEQUENTIAL);
+
+  const checkpoint_header &head = header();
+  if (memcmp(head.magic, kMagic, sizeof(kMagic)) != 0) {
+    *error = path + ": not a checkpoint";
+    return false;
+  }
+  if (head.version != kCheckpointVersion) {
+    *error = path + ": checkpoint version " + std::to_string(head.version) +
+             ", expected " + std::to_string(kCheckpointVersion);
+    return false;
+  }
+  if (head.byte_order != kByteOrderMark ||
+      head.entity_size != sizeof(entity_state) ||
+      head.sensor_size != sizeof(sensor_state)) {
+    *error = path + ": checkpoint written by an incompatible build";
+    return false;
+  }
+  if (size_ != sizeof(checkpoint_header) +
+               head.n_entities * sizeof(entity_state) +
+               head.n_sensors * sizeof(sensor_state)) {
+    *error = path + ": checkpoint is truncated or corrupt";
+    return false;
+  }
+  return true;
+} /* Open() */
+
+/*******************************************************************************
+ * Non-Member Functions
+ ******************************************************************************/
+/* Check that an open checkpoint was saved from an Arena like `arena`. */
+static bool Fits(const MappedCheckpoint &checkpoint, Arena *arena,
+                 std::string *error) {
+  const checkpoint_header &head = checkpoint.header();
+  const std::vector<ArenaEntity *> &entities = arena->get_entities();
+  const std::vector<Sensor *> &sensors = arena->get_sensors();
+  if (entities.size() != head.n_entities ||
+      sensors.size() != head.n_sensors ||
+      arena->get_x_dim() < head.arena.x_dim ||
+      arena->get_x_dim() > head.arena.x_dim ||
+      arena->get_y_dim() < head.arena.y_dim ||
+      arena->get_y_dim() > head.arena.y_dim) {
+    *error = "the checkpoint is of a different arena";
+    return false;
+  }
+  const entity_state *records = checkpoint.entities();
+  for (size_t i = 0; i < entities.size(); ++i) {
+    if (records[i].type != entities[i]->get_type()) {
+      *error = "the checkpoint is of a different arena";
+      return false;
+    }
+  }
+  return true;
+} /* Fits() */
+
+/* Restore the sensors and the Arena's own state; the entities are done. */
+static void RestoreSensorsAndArena(const MappedCheckpoint &checkpoint,
+                                   Arena *arena) {
+  const std::vector<Sensor *> &sensors = arena->get_sensors();
+  const sensor_state *sensor_records = checkpoint.sensors();
+  for (size_t i = 0; i < sensors.size(); ++i) {
+    const sensor_state &record = sensor_records[i];
+    sensors[i]->set_pose(Pose(record.x, record.y, record.theta));
+    sensors[i]->set_impulse(record.impulse);
+    sensors[i]->set_activity(record.active != 0);
+  }
+  arena->LoadState(checkpoint.header().arena);
+} /* RestoreSensorsAndArena() */
+
+/* Whether the records are the robots, then the lights, then the foods of
+ * the saved Arena, as the Arena constructor takes them. */
+static bool RecordsInOrder(const MappedCheckpoint &checkpoint) {
+  const arena_state &state = checkpoint.header().arena;
+  if (checkpoint.header().n_entities !=
+      state.n_robots + state.n_lights + state.n_foods) {
+    return false;
+  }
+  const entity_state *record = checkpoint.entities();
+  const uint64_t counts[] = {state.n_robots, state.n_lights, state.n_foods};
+  const EntityType types[] = {kRobot, kLight, kFood};
+  for (int t = 0; t < 3; ++t) {
+    for (uint64_t i = 0; i < counts[t]; ++i, ++record) {
+      if (record->type != types[t]) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+bool SaveCheckpoint(const Arena &arena, const std::string &path,
+                    std::string *error) {
+  checkpoint_header head;
+  memset(&head, 0, sizeof(head));
+  memcpy(head.magic, kMagic, sizeof(kMagic));
+  head.version = kCheckpointVersion;
+  head.byte_order = kByteOrderMark;
+  head.entity_size = sizeof(entity_state);
+  head.sensor_size = sizeof(sensor_state);
+  head.n_entities = arena.get_entities().size();
+  head.n_sensors = arena.get_sensors().size();
+  arena.SaveState(&head.arena);
+
+  std::string partial = path + ".partial";
+  std::ofstream out(partial, std::ios::binary | std::ios::trunc);
+  if (!out) {
+    *error = partial + ": " + strerror(errno);
+    return false;
+  }
+  out.write(reinterpret_cast<const char *>(&head), sizeof(head));
+
+  std::vector<entity_state> records;
+  records.reserve(kWriteBatch);
+  const std::vector<ArenaEntity *> &entities = arena.get_entities();
+  for (size_t begin = 0; begin < entities.size(); begin += kWriteBatch) {
+    size_t end = std::min(begin + kWriteBatch, entities.size());
+    records.assign(end - begin, entity_state());
+    for (size_t i = begin; i < end; ++i) {
+      entities[i]->SaveState(&records[i - begin]);
+    }
+    out.write(reinterpret_cast<const char *>(records.data()),
+              static_cast<std::streamsize>(records.size() *
+                                           sizeof(entity_state)));
+  }
+
+  std::vector<sensor_state> sensor_records;
+  const std::vector<Sensor *> &sensors = arena.get_sensors();
+  for (size_t begin = 0; begin < sensors.size(); begin += kWriteBatch) {
+    size_t end = std::min(begin + kWriteBatch, sensors.size());
+    sensor_records.assign(end - begin, sensor_state());
+    for (size_t i = begin; i < end; ++i) {
+      sensor_state &record = sensor_records[i - begin];
+      record.x = sensors[i]->get_pose().x;
+      record.y = sensors[i]->get_pose().y;
+      record.theta = sensors[i]->get_pose().theta;
+      record.impulse = sensors[i]->get_impulse();
+      record.active = sensors[i]->is_active();
+    }
+    out.write(reinterpret_cast<const char *>(sensor_records.data()),
+              static_cast<std::streamsize>(sensor_records.size() *
+                                           sizeof(sensor_state)));
+  }
+
+  out.close();
+  if (!out) {
+    *error = partial + ": write failed";
+    std::remove(partial.c_str());
+    return false;
+  }
+  if (std::rename(partial.c_str(), path.c_str()) != 0) {
+    *error = path + ": " + strerror(errno);
+    std::remove(partial.c_str());
+    return false;
+  }
+  return true;
+} /* SaveCheckpoint() */
+
+bool RestoreCheckpoint(const std::string &path, Arena *arena,
+                       std::string *error) {
+  MappedCheckpoint checkpoint;
+  if (!checkpoint.Open(path, error) || !Fits(checkpoint, arena, error)) {
+    return false;
+  }
+  const std::vector<ArenaEntity *> &entities = arena->get_entities();
+  const entity_state *records = checkpoint.entities();
+  for (size_t i = 0; i < entities.size(); ++i) {
+    entities[i]->LoadState(records[i]);
+  }
+  RestoreSensorsAndArena(checkpoint, arena);
+  return true;
+}
+
+Arena *LoadCheckpoint(const std::string &path, std::string *error,
+                      int n_threads) {
+  MappedCheckpoint checkpoint;
+  if (!checkpoint.Open(path, error)) {
+    return nullptr;
+  }
+  if (!RecordsInOrder(checkpoint)) {
+    *error = path + ": checkpoint is truncated or corrupt";
+    return nullptr;
+  }
+  const arena_state &state = checkpoint.header().arena;
+  arena_params params;
+  params.n_robots = state.n_robots;
+  params.n_lights = state.n_lights;
+  params.n_foods = state.n_foods;
+  params.x_dim = static_cast<uint>(std::lround(state.x_dim));
+  params.y_dim = static_cast<uint>(std::lround(state.y_dim));
+  params.broad_phase = static_cast<BroadPhaseType>(state.broad_phase);
+  params.n_threads = (n_threads > 0) ? n_threads : state.n_threads;
+  params.seed = state.seed;
+  params.sensing_error = state.sensing_error;
+  // The entities are built straight from their records, rather than placed
+  // at random and then overwritten.
+  Arena *arena = new Arena(&params, nullptr, checkpoint.entities());
+  if (!Fits(checkpoint, arena, error)) {
+    delete arena;
+    return nullptr;
+  }
+  RestoreSensorsAndArena(checkpoint, arena);
+  return arena;
+} /* LoadCheckpoint() */
+
+NAMESPACE_END(csci3081);
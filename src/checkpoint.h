@@ -0,0 +1,99 @@
+/**
+ * @file checkpoint.h
+ *
+ * @copyright 2018 3081 Staff, All rights reserved.
+ */
+
+#ifndef SRC_CHECKPOINT_H_
+#define SRC_CHECKPOINT_H_
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <cstdint>
+#include <string>
+
+#include "src/arena.h"
+#include "src/common.h"
+#include "src/entity_state.h"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+NAMESPACE_BEGIN(csci3081);
+
+/*******************************************************************************
+ * Constants
+ ******************************************************************************/
+// Bumped whenever the layout of a checkpoint or of a state record changes.
+const uint32_t kCheckpointVersion = 1;
+
+/*******************************************************************************
+ * Structure Definitions
+ ******************************************************************************/
+/**
+ * @brief The start of a checkpoint file.
+ *
+ * A checkpoint is this header, then one entity_state per entity in the
+ * order of Arena::get_entities(), then one sensor_state per sensor in the
+ * order of Arena::get_sensors(). Records are stored in the machine's own
+ * byte order and layout, which the header records so that a mismatched
+ * file is rejected rather than misread.
+ */
+struct checkpoint_header {
+  char magic[8];
+  uint32_t version;
+  // kByteOrderMark as written by the machine that saved the checkpoint.
+  uint32_t byte_order;
+  uint32_t entity_size;
+  uint32_t sensor_size;
+  uint64_t n_entities;
+  uint64_t n_sensors;
+  arena_state arena;
+};
+
+static_assert(sizeof(checkpoint_header) == 144, "checkpoint_header padding");
+
+/*******************************************************************************
+ * Non-Member Functions
+ ******************************************************************************/
+/**
+ * @brief Write the full state of `arena` to `path`.
+ *
+ * The checkpoint is written next to `path` and renamed over it once
+ * complete, so a run that dies while checkpointing keeps its last good
+ * checkpoint. Must be called from the thread that steps the Arena, between
+ * steps.
+ *
+ * @return false, with the reason in `error`, if it could not be written.
+ */
+bool SaveCheckpoint(const Arena &arena, const std::string &path,
+                    std::string *error);
+
+/**
+ * @brief Put `arena` back in the state saved in `path`. Stepping it then
+ * continues exactly as the saved Arena would have.
+ *
+ * `arena` must have the entity counts and dimensions of the saved one (for
+ * instance, be built from the same arena_params); otherwise, or if the file
+ * is not a valid checkpoint, nothing is changed.
+ *
+ * @return false, with the reason in `error`, if nothing was restored.
+ */
+bool RestoreCheckpoint(const std::string &path, Arena *arena,
+                       std::string *error);
+
+/**
+ * @brief Build a new Arena from the checkpoint at `path`.
+ *
+ * @param[in] n_threads The # of threads to step it with; 0 uses the saved
+ * count. The results do not depend on it.
+ *
+ * @return The Arena, or nullptr with the reason in `error`.
+ */
+Arena *LoadCheckpoint(const std::string &path, std::string *error,
+                      int n_threads = 0);
+
+NAMESPACE_END(csci3081);
+
+#endif  // SRC_CHECKPOINT_H_
@@ -36,6 +36,8 @@ enum Communication {
   kTurnRight,
   kTurnLeft,
   kReset,
+  kSetFERatio,         // payload: the fear/exploration ratio
+  kSetLightIntensity,  // payload: the light intensity
 
   // communications from Arena to Controller
   kWon,
@@ -44,6 +46,15 @@ enum Communication {
   kNone   // in case it is needed
 };
 
+/**
+ * @brief A Communication and its payload, as queued for the Arena.
+ */
+struct arena_command {
+  Communication type{kNone};
+  // The new value, for the kSet* commands.
+  double value{0.0};
+};
+
 NAMESPACE_END(csci3081);
 
 #endif  // SRC_COMMUNICATION_H_
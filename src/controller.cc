@@ -8,18 +8,20 @@
  * Includes
  ******************************************************************************/
 #include <nanogui/nanogui.h>
+#include <iostream>
 #include <string>
 
 #include "src/arena_params.h"
 #include "src/common.h"
 #include "src/controller.h"
+#include "src/tracer.h"
 
 /*******************************************************************************
  * Namespaces
  ******************************************************************************/
 NAMESPACE_BEGIN(csci3081);
 
-Controller::Controller() : last_dt(0) {
+Controller::Controller() {
   // Initialize default properties for various arena entities
   arena_params aparams;
   aparams.n_lights = N_LIGHTS;
@@ -27,27 +29,29 @@ Controller::Controller() : last_dt(0) {
   aparams.y_dim = ARENA_Y_DIM;
 
   arena_ = new Arena(&aparams);
+  arena_->set_step_budget(STEP_BUDGET_SECONDS);
+  target_params_ = aparams;
+  sim_thread_ = new SimulationThread(arena_, &snapshots_);
 
   // Start up the graphics (which creates the arena).
   // Run() will enter the nanogui::mainloop().
-  viewer_ = new GraphicsArenaViewer(&aparams, arena_, this);
+  viewer_ = new GraphicsArenaViewer(&aparams, &snapshots_, this);
 }
 
-void Controller::Run() { viewer_->Run(); }
+void Controller::Run() {
+  sim_thread_->Start();
+  viewer_->Run();
+  sim_thread_->Stop();
+  viewer_->DumpFrameLatency();
+  arena_->get_step_histogram().Dump(std::cout, "step");
+}
 
-void Controller::AdvanceTime(double dt) {
-  /** first, before anything, check if the arena needs to be renewed because
-   * change in one of the slider values
-   */
-  if ((last_dt + dt) <= .05) {
-    last_dt += dt;
-    return;
-  }
-  last_dt = 0;
-  arena_->AdvanceTime(dt);
+void Controller::SetTimeScale(double scale) {
+  sim_thread_->SetTimeScale(scale);
 }
 
 void Controller::ChangeArena() {
+  ScopedTrace trace("change arena", "rebuild");
   arena_params new_params;
   new_params.n_lights = viewer_->get_n_lights();
   new_params.n_foods = viewer_->get_n_foods();
@@ -55,28 +59,57 @@ void Controller::ChangeArena() {
   new_params.x_dim = ARENA_X_DIM;
   new_params.y_dim = ARENA_Y_DIM;
 
-  if (arena_->get_params() != new_params) {
-    delete(arena_);
-    arena_ = new Arena(&new_params);
-    viewer_->set_arena(arena_);
+  if (new_params == target_params_) {
+    return;
+  }
+  target_params_ = new_params;
+  // The parameters are only written when an Arena is built, so reading
+  // them while it steps is safe.
+  if (arena_->get_params() == new_params) {
+    // Back to what is already running.
+    builder_.Cancel();
+  } else {
+    builder_.Request(new_params);
+  }
+}
+
+void Controller::PollArenaRebuild() {
+  Arena *next = builder_.TakeReady();
+  if (next == nullptr) {
+    return;
   }
+  ScopedTrace trace("swap arena", "rebuild");
+  next->set_step_budget(STEP_BUDGET_SECONDS);
+  builder_.Retire(sim_thread_->ReplaceArena(next));
+  arena_ = next;
+}
+
+void Controller::DumpStepLatency() {
+  sim_thread_->EditArena([](Arena *arena) {
+      arena->get_step_histogram().Dump(std::cout, "step");
+    });
 }
 
 void Controller::SetArenaFERatio(float value) {
-  arena_->set_f_e_ratio(value);
+  PostCommand(kSetFERatio, value);
 }
 
 void Controller::UpdateLightIntensity(float value) {
-  for (auto &ent : arena_->get_entities()) {
-    if (ent->get_type() == kLight) {
-                static_cast<Light*>
-                  (ent)->set_intensity(static_cast<int>(value*1200));
-    }
-  }
+  PostCommand(kSetLightIntensity, static_cast<int>(value*1200));
 }
 
 void Controller::AcceptCommunication(Communication com) {
-  arena_->AcceptCommand(ConvertComm(com));
+  Communication command = ConvertComm(com);
+  if (command == kPlay || command == kPause) {
+    sim_thread_->set_running(command == kPlay);
+  }
+  PostCommand(command, 0.0);
+}
+
+void Controller::PostCommand(Communication com, double value) {
+  if (!arena_->PostCommand(com, value)) {
+    std::cerr << "Arena command queue is full; command dropped." << std::endl;
+  }
 }
 
 /** Converts communication from one source to appropriate communication to
@@ -14,10 +14,13 @@
 #include <string>
 
 #include "src/arena.h"
+#include "src/arena_builder.h"
 #include "src/common.h"
 #include "src/communication.h"
 #include "src/graphics_arena_viewer.h"
+#include "src/arena_snapshot.h"
 #include "src/params.h"
+#include "src/sim_thread.h"
 
 /*******************************************************************************
  * Namespaces
@@ -33,8 +36,8 @@ class GraphicsArenaViewer;
  * @brief Controller that mediates Arena and GraphicsArenaViewer communication.
  *
  * The Controller instantiates the Arena and the GraphicsArenaViewer. The
- * viewer contains the main loop that keeps it live, but at each update, the
- * viewer sends a message to the controller to update its time.
+ * viewer contains the main loop that keeps it live, while the Arena steps on
+ * a SimulationThread and publishes snapshots for the viewer to draw.
  *
  * Other types of communication between Arena and Viewer include:
  * - Play/Pause/New Game user input via the Viewer.
@@ -54,13 +57,32 @@ class Controller {
   void Run();
 
   /**
-   * @brief AdvanceTime is communication from the Viewer to advance the
-   * simulation.
+   * @brief Set how many simulated seconds pass per wall-clock second, or
+   * StepAccumulator::kMaxTimeScale to step as fast as the budget allows.
    */
-  void AdvanceTime(double dt);
+  void SetTimeScale(double scale);
 
+  /**
+   * @brief Rebuild the Arena from the viewer's sliders.
+   *
+   * The new Arena is built on a background thread while the current one
+   * keeps running; moving a slider again cancels a build still in flight.
+   * PollArenaRebuild() swaps it in once it is ready.
+   */
   void ChangeArena();
 
+  /**
+   * @brief Swap in the Arena requested by ChangeArena(), if it has finished
+   * building. Called by the viewer once per frame.
+   */
+  void PollArenaRebuild();
+
+  /**
+   * @brief Print the step latency histogram of the current Arena to
+   * std::cout. Run() also prints it when the viewer closes.
+   */
+  void DumpStepLatency();
+
   void SetArenaFERatio(float value);
 
   void UpdateLightIntensity(float value);
@@ -79,8 +101,21 @@ class Controller {
   Communication ConvertComm(Communication com);
 
  private:
-  double last_dt{0};
+  /**
+   * @brief Queue a command for the Arena, which applies it at its next step
+   * boundary. Never waits for the simulation thread.
+   */
+  void PostCommand(Communication com, double value);
+
   Arena* arena_{nullptr};
+  // The viewer draws from snapshots_, which sim_thread_ fills as it steps
+  // arena_.
+  SnapshotBuffer snapshots_{};
+  SimulationThread* sim_thread_{nullptr};
+  // Builds the Arenas requested by ChangeArena(); target_params_ is the
+  // newest request, or arena_'s parameters if there is none.
+  ArenaBuilder builder_{};
+  arena_params target_params_{};
   GraphicsArenaViewer* viewer_{nullptr};
 };
 
@@ -0,0 +1,71 @@
+/**
+ * @file emitter_grid.cc
+ *
+ * @copyright 2018 3081 Staff, All rights reserved.
+ */
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include "src/emitter_grid.h"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+NAMESPACE_BEGIN(csci3081);
+
+/*******************************************************************************
+ * Member Functions
+ ******************************************************************************/
+void EmitterGrid::Build(const EntityStore &store, EntityRange range,
+                        double cell_size) {
+  cell_items_.clear();
+  if (range.size() == 0) {
+    return;
+  }
+  const double *x = store.x();
+  const double *y = store.y();
+
+  min_x_ = x[range.begin];
+  min_y_ = y[range.begin];
+  double max_x = min_x_;
+  double max_y = min_y_;
+  for (size_t i = range.begin; i < range.end; ++i) {
+    min_x_ = std::min(min_x_, x[i]);
+    min_y_ = std::min(min_y_, y[i]);
+    max_x = std::max(max_x, x[i]);
+    max_y = std::max(max_y, y[i]);
+  }
+  // Never use more than ~4 cells per emitter.
+  cell_size_ = std::max(cell_size, 1.0);
+  double max_cells = 4.0 * range.size();
+  while (std::ceil((max_x - min_x_ + 1) / cell_size_) *
+         std::ceil((max_y - min_y_ + 1) / cell_size_) > max_cells) {
+    cell_size_ *= 2.0;
+  }
+  n_cols_ = ColumnOf(max_x) + 1;
+  n_rows_ = RowOf(max_y) + 1;
+  int n_cells = n_cols_ * n_rows_;
+
+  // Counting sort of the emitters into their cells. Reserving for the cap
+  // keeps a rebuild from allocating when the emitters spread out.
+  cell_start_.reserve(4 * range.size() + 1);
+  cell_start_.assign(n_cells + 1, 0);
+  for (size_t i = range.begin; i < range.end; ++i) {
+    ++cell_start_[RowOf(y[i]) * n_cols_ + ColumnOf(x[i]) + 1];
+  }
+  for (int c = 0; c < n_cells; ++c) {
+    cell_start_[c + 1] += cell_start_[c];
+  }
+  cell_items_.resize(range.size());
+  for (size_t i = range.begin; i < range.end; ++i) {
+    cell_items_[cell_start_[RowOf(y[i]) * n_cols_ + ColumnOf(x[i])]++] = i;
+  }
+  // The fill pass advanced each start to the next cell's start; shift back.
+  for (int c = n_cells; c > 0; --c) {
+    cell_start_[c] = cell_start_[c - 1];
+  }
+  cell_start_[0] = 0;
+} /* Build() */
+
+NAMESPACE_END(csci3081);
@@ -0,0 +1,93 @@
+/**
+ * @file emitter_grid.h
+ *
+ * @copyright 2018 3081 Staff, All rights reserved.
+ */
+
+#ifndef SRC_EMITTER_GRID_H_
+#define SRC_EMITTER_GRID_H_
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+#include "src/common.h"
+#include "src/entity_store.h"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+NAMESPACE_BEGIN(csci3081);
+
+/*******************************************************************************
+ * Class Definitions
+ ******************************************************************************/
+/**
+ * @brief A uniform grid over one range of emitters (e.g. the lights) of an
+ * EntityStore, answering "which emitters might be within r of (x, y)".
+ *
+ * Sensors with a cut-off radius use it to visit only the nearby emitters
+ * instead of all of them. The grid is rebuilt whenever the emitters move.
+ */
+class EmitterGrid {
+ public:
+  EmitterGrid() = default;
+
+  /**
+   * @brief Bucket the emitters in `range` of `store`.
+   *
+   * @param[in] cell_size Edge of a grid cell; the query radius is a good
+   * choice. The cell count is capped relative to the emitter count, so the
+   * cells may end up larger.
+   */
+  void Build(const EntityStore &store, EntityRange range, double cell_size);
+
+  /**
+   * @brief Call `visit(i)` with the store index of every emitter whose cell
+   * overlaps the square around (x, y) of half-width `radius`. The caller
+   * checks the exact distance.
+   */
+  template <typename Visit>
+  void ForEachWithin(double x, double y, double radius, Visit visit) const {
+    if (cell_items_.empty()) {
+      return;
+    }
+    int col_begin = std::max(ColumnOf(x - radius), 0);
+    int col_end = std::min(ColumnOf(x + radius), n_cols_ - 1);
+    int row_begin = std::max(RowOf(y - radius), 0);
+    int row_end = std::min(RowOf(y + radius), n_rows_ - 1);
+    for (int row = row_begin; row <= row_end; ++row) {
+      for (int col = col_begin; col <= col_end; ++col) {
+        int cell = row * n_cols_ + col;
+        for (int k = cell_start_[cell]; k < cell_start_[cell + 1]; ++k) {
+          visit(cell_items_[k]);
+        }
+      }
+    }
+  }
+
+ private:
+  int ColumnOf(double x) const {
+    return static_cast<int>(std::floor((x - min_x_) / cell_size_));
+  }
+  int RowOf(double y) const {
+    return static_cast<int>(std::floor((y - min_y_) / cell_size_));
+  }
+
+  double min_x_{0.0};
+  double min_y_{0.0};
+  double cell_size_{1.0};
+  int n_cols_{0};
+  int n_rows_{0};
+  // cell_start_[c] .. cell_start_[c + 1] indexes cell c's run in cell_items_.
+  std::vector<int> cell_start_{};
+  std::vector<size_t> cell_items_{};
+};
+
+NAMESPACE_END(csci3081);
+
+#endif  // SRC_EMITTER_GRID_H_
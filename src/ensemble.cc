@@ -0,0 +1,109 @@
+/**
+ * @file ensemble.cc
+ *
+ * @copyright 2018 3081 Staff, All rights reserved.
+ */
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <atomic>
+#include <thread>
+
+#include "src/ensemble.h"
+#include "src/light.h"
+#include "src/tracer.h"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+NAMESPACE_BEGIN(csci3081);
+
+/*******************************************************************************
+ * Non-Member Functions
+ ******************************************************************************/
+/* Whether an Arena built from `a` can be reset to run `b`. The seed and the
+ * thread count do not change what gets built.
+ */
+static bool SameLayout(arena_params a, const arena_params &b) {
+  a.seed = b.seed;
+  a.n_threads = b.n_threads;
+  return a == b;
+}
+
+/*******************************************************************************
+ * Constructors/Destructor
+ ******************************************************************************/
+EnsembleRunner::EnsembleRunner(int n_threads)
+    : pool_(new ThreadPool(n_threads > 0 ? n_threads : static_cast<int>(
+          std::thread::hardware_concurrency()))),
+      arenas_() {
+  arenas_.assign(pool_->get_n_threads(), nullptr);
+}
+
+EnsembleRunner::~EnsembleRunner() {
+  for (auto &arena : arenas_) {
+    delete arena;
+  }
+  delete pool_;
+}
+
+/*******************************************************************************
+ * Member Functions
+ ******************************************************************************/
+std::vector<EnsembleOutcome> EnsembleRunner::Run(
+  const std::vector<EnsembleRun> &runs) {
+  std::vector<EnsembleOutcome> outcomes(runs.size());
+  std::atomic<size_t> next_run(0);
+
+  // One item per slot; each slot pulls runs until none are left, so long and
+  // short runs balance out across the threads.
+  pool_->ParallelFor(arenas_.size(), [&](size_t begin, size_t end) {
+      for (size_t slot = begin; slot < end; ++slot) {
+        size_t k;
+        while ((k = next_run++) < runs.size()) {
+          ScopedTrace trace("ensemble run", "ensemble");
+          const EnsembleRun &run = runs[k];
+          uint64_t seed = (run.params.seed != 0) ? run.params.seed : k + 1;
+          Arena *arena = ArenaFor(slot, run.params);
+          arena->Reseed(seed);
+          arena->set_f_e_ratio(run.f_e_ratio);
+          for (auto &ent : arena->get_entities()) {
+            if (ent->get_type() == kLight) {
+              ent->set_intensity(run.light_intensity);
+            }
+          }
+          arena->Reset();
+
+          uint64_t steps = arena->StepN(run.max_steps);
+
+          EnsembleOutcome &outcome = outcomes[k];
+          outcome.seed = seed;
+          outcome.steps = steps;
+          outcome.lost = (arena->get_game_status() == LOST);
+          outcome.n_starved = 0;
+          outcome.n_food_collisions = 0;
+          for (auto &robot : arena->get_robots()) {
+            outcome.n_starved += robot->is_starved() ? 1 : 0;
+            outcome.n_food_collisions += robot->get_food_count();
+          }
+        }
+      }
+    });
+  return outcomes;
+} /* Run() */
+
+Arena *EnsembleRunner::ArenaFor(size_t slot, const arena_params &params) {
+  Arena *&arena = arenas_[slot];
+  if (arena != nullptr && SameLayout(arena->get_params(), params)) {
+    return arena;
+  }
+  delete arena;
+  arena_params serial = params;
+  serial.n_threads = 1;
+  arena = new Arena(&serial);
+  ++n_arenas_built_;
+  return arena;
+}
+
+NAMESPACE_END(csci3081);
@@ -0,0 +1,111 @@
+/**
+ * @file ensemble.h
+ *
+ * @copyright 2018 3081 Staff, All rights reserved.
+ */
+
+#ifndef SRC_ENSEMBLE_H_
+#define SRC_ENSEMBLE_H_
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+#include "src/arena.h"
+#include "src/arena_params.h"
+#include "src/common.h"
+#include "src/thread_pool.h"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+NAMESPACE_BEGIN(csci3081);
+
+/*******************************************************************************
+ * Structure Definitions
+ ******************************************************************************/
+/**
+ * @brief The setup of one run of an ensemble.
+ */
+struct EnsembleRun {
+  // Entity counts, geometry, broad phase and seed. A seed of 0 is replaced
+  // by the run's index + 1 so that an ensemble is always reproducible.
+  // n_threads is ignored: each run is stepped on one thread.
+  arena_params params{};
+  float f_e_ratio{0.0f};
+  double light_intensity{1200.0};
+  // The run stops when a robot starves or after this many steps.
+  uint64_t max_steps{10000};
+};
+
+/**
+ * @brief What happened in one run of an ensemble.
+ */
+struct EnsembleOutcome {
+  uint64_t seed;
+  // Steps taken; the step at which the game was lost if `lost`.
+  uint64_t steps;
+  bool lost;
+  // Robots that had starved when the run stopped.
+  int n_starved;
+  // Robot-food collisions (meals) over the whole run.
+  int n_food_collisions;
+};
+
+/*******************************************************************************
+ * Class Definitions
+ ******************************************************************************/
+/**
+ * @brief Runs many independent Arenas side by side, one per thread.
+ *
+ * Each thread keeps one Arena and works through the runs that are still
+ * waiting. When the next run has the same entity counts and geometry as the
+ * thread's Arena, the Arena is reseeded and Reset() instead of rebuilt. Every
+ * run starts from Reseed() + Reset(), so its outcome depends only on its
+ * EnsembleRun, not on which thread ran it or what ran there before.
+ */
+class EnsembleRunner {
+ public:
+  /**
+   * @param[in] n_threads The # of Arenas stepped at once. 0 uses one per
+   * hardware thread.
+   */
+  explicit EnsembleRunner(int n_threads = 0);
+  ~EnsembleRunner();
+
+  EnsembleRunner(const EnsembleRunner &other) = delete;
+  EnsembleRunner &operator=(const EnsembleRunner &other) = delete;
+
+  /**
+   * @brief Step every run to completion.
+   *
+   * @return One outcome per run, in the order of `runs`.
+   */
+  std::vector<EnsembleOutcome> Run(const std::vector<EnsembleRun> &runs);
+
+  int get_n_threads() const { return pool_->get_n_threads(); }
+
+  /**
+   * @brief The # of Arenas constructed so far (rather than reused).
+   */
+  int get_n_arenas_built() const { return n_arenas_built_; }
+
+ private:
+  /**
+   * @brief An Arena in slot `slot` that fits `params`, reusing the slot's
+   * current Arena when possible.
+   */
+  Arena *ArenaFor(size_t slot, const arena_params &params);
+
+  ThreadPool *pool_;
+  // One Arena per thread, kept between calls to Run(). Null until used.
+  std::vector<Arena *> arenas_;
+  std::atomic<int> n_arenas_built_{0};
+};
+
+NAMESPACE_END(csci3081);
+
+#endif  // SRC_ENSEMBLE_H_
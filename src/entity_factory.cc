@@ -27,7 +27,7 @@ NAMESPACE_BEGIN(csci3081);
 /*******************************************************************************
  * Class Definitions
  ******************************************************************************/
-EntityFactory::EntityFactory() {
+EntityFactory::EntityFactory(Rng *rng) : rng_(rng) {
   srand(time(nullptr));
 }
 
@@ -49,56 +49,82 @@ ArenaEntity* EntityFactory::CreateEntity(EntityType etype) {
   return nullptr;
 }
 
-Robot* EntityFactory::CreateRobot() {
-  thread_local unsigned int seed = time(NULL);
+ArenaEntity* EntityFactory::LoadEntity(const entity_state &state) {
+  switch (state.type) {
+    case (kRobot):
+      return CreateRobot(&state);
+    case (kLight):
+      return CreateLight(&state);
+    case (kFood):
+      return CreateFood(&state);
+    default:
+      std::cout << "FATAL: Bad entity type on load\n";
+      assert(false);
+  }
+  return nullptr;
+}
+
+Robot* EntityFactory::CreateRobot(const entity_state *state) {
   auto* robot = new Robot;
+  robot->set_rng(rng_);
   robot->set_type(kRobot);
   robot->set_color(ROBOT_COLOR);
-  robot->set_pose(SetPoseRandomly());
-  robot->set_radius(ROBOT_RADIUS+(rand_r(&seed) % ROBOT_RADIUS));
-  robot->get_sensors().push_back(new Sensor(LEFT, kLight));
-  robot->get_sensors().push_back(new Sensor(RIGHT, kLight));
-  robot->get_sensors().push_back(new Sensor(LEFT, kFood));
-  robot->get_sensors().push_back(new Sensor(RIGHT, kFood));
-  for (auto &sensor : robot->get_sensors()) {
-    sensor->set_pose(sensor->CalcPose(ROBOT_INIT_POS, ROBOT_RADIUS));
-  }
+  robot->set_arena_size(x_dim_, y_dim_);
   sensor_count_ += 4;
   ++entity_count_;
   ++robot_count_;
   robot->set_id(robot_count_);
+  if (state != nullptr) {
+    robot->LoadState(*state);
+    return robot;
+  }
+  robot->set_pose(robot->RandomGridPose());
+  robot->set_radius(ROBOT_RADIUS + RandomInt(ROBOT_RADIUS));
+  for (auto &sensor : robot->get_sensors()) {
+    sensor->set_pose(sensor->CalcPose(ROBOT_INIT_POS, ROBOT_RADIUS));
+  }
   return robot;
 }
 
-Light* EntityFactory::CreateLight() {
-  thread_local unsigned int seed = time(NULL);
+Light* EntityFactory::CreateLight(const entity_state *state) {
   auto* light = new Light;
+  light->set_rng(rng_);
   light->set_type(kLight);
   light->set_color(LIGHT_COLOR);
-  light->set_pose(SetPoseRandomly());
-  light->set_radius((rand_r(&seed) % LIGHT_RADIUS)+LIGHT_RADIUS);
+  light->set_arena_size(x_dim_, y_dim_);
   ++entity_count_;
   ++light_count_;
   light->set_id(light_count_);
+  if (state != nullptr) {
+    light->LoadState(*state);
+    return light;
+  }
+  light->set_pose(light->RandomGridPose());
+  light->set_radius(RandomInt(LIGHT_RADIUS) + LIGHT_RADIUS);
   return light;
 }
 
-Food* EntityFactory::CreateFood() {
+Food* EntityFactory::CreateFood(const entity_state *state) {
   auto* food = new Food;
+  food->set_rng(rng_);
   food->set_type(kFood);
   food->set_color(FOOD_COLOR);
-  food->set_pose(SetPoseRandomly());
-  food->set_radius(FOOD_RADIUS);
+  food->set_arena_size(x_dim_, y_dim_);
   ++entity_count_;
   ++food_count_;
   food->set_id(food_count_);
+  if (state != nullptr) {
+    food->LoadState(*state);
+    return food;
+  }
+  food->set_pose(food->RandomGridPose());
+  food->set_radius(FOOD_RADIUS);
   return food;
 }
 
-Pose EntityFactory::SetPoseRandomly() {
-  // Dividing arena into 19x14 grid. Each grid square is 50x50
-  return {static_cast<double>((30 + (random() % 19) * 50)),
-        static_cast<double>((30 + (random() % 14) * 50))};
+int EntityFactory::RandomInt(int n) {
+  return (rng_ != nullptr) ? rng_->UniformInt(n)
+                           : static_cast<int>(random() % n);
 }
 
 NAMESPACE_END(csci3081);
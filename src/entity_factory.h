@@ -14,11 +14,13 @@
 
 #include "src/food.h"
 #include "src/common.h"
+#include "src/entity_state.h"
 #include "src/entity_type.h"
 #include "src/light.h"
 #include "src/params.h"
 #include "src/pose.h"
 #include "src/rgb_color.h"
+#include "src/rng.h"
 #include "src/robot.h"
 
 /*******************************************************************************
@@ -41,8 +43,13 @@ class EntityFactory {
   /**
    * @brief EntityFactory constructor.
    *
+   * @param rng The generator that placements and sizes are drawn from. It is
+   * also handed to every entity created. If null, random() is used.
    */
-  EntityFactory();
+  explicit EntityFactory(Rng *rng = nullptr);
+
+  EntityFactory(const EntityFactory &other) = delete;
+  EntityFactory &operator=(const EntityFactory &other) = delete;
 
   /**
    * @brief Default destructor.
@@ -62,31 +69,52 @@ class EntityFactory {
   */
   ArenaEntity* CreateEntity(EntityType etype);
 
+  /**
+   * @brief Create an entity of the type in `state` and load it from
+   * `state`, rather than placing it at random. Draws nothing from the rng.
+   */
+  ArenaEntity* LoadEntity(const entity_state &state);
+
   int get_robot_count() { return robot_count_; }
 
+  /**
+   * @brief Set the size of the arena that new entities are placed in.
+   */
+  void set_arena_size(int x_dim, int y_dim) {
+    x_dim_ = x_dim;
+    y_dim_ = y_dim;
+  }
+
  private:
    /**
    * @brief CreateRobot called from within CreateEntity.
    * Create Robot is responsible for initializaing all of the robots in the arena
    * and their sensors. The sensor count is increment in accordance with how many
    * sensors each robot has.
+   *
+   * @param state If given, the robot is loaded from it instead of being
+   * placed at random (likewise for the others).
    */
-  Robot* CreateRobot();
+  Robot* CreateRobot(const entity_state *state = nullptr);
 
   /**
   * @brief CreateLight called from within CreateEntity.
   */
-  Light* CreateLight();
+  Light* CreateLight(const entity_state *state = nullptr);
 
   /**
   * @brief CreateFood called from within CreateEntity.
   */
-  Food* CreateFood();
+  Food* CreateFood(const entity_state *state = nullptr);
 
   /**
-  * @brief An attempt to not overlap any of the newly constructed entities.
-  */
-  Pose SetPoseRandomly();
+   * @brief A random integer in [0, n).
+   */
+  int RandomInt(int n);
+
+  Rng *rng_;
+  int x_dim_{ARENA_X_DIM};
+  int y_dim_{ARENA_Y_DIM};
 
   /* Factory tracks the number of created entities. There is no accounting for
    * the destruction of entities */
@@ -0,0 +1,110 @@
+/**
+ * @file entity_state.h
+ *
+ * @copyright 2018 3081 Staff, All rights reserved.
+ */
+
+#ifndef SRC_ENTITY_STATE_H_
+#define SRC_ENTITY_STATE_H_
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <cstdint>
+
+#include "src/common.h"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+NAMESPACE_BEGIN(csci3081);
+
+/*******************************************************************************
+ * Structure Definitions
+ ******************************************************************************/
+/*
+ * The plain-data state of an Arena and its contents, as written to a
+ * checkpoint (see checkpoint.h). Each one is laid out without implicit
+ * padding, so that a record's bytes are fully determined by its fields, and
+ * a change to any of them must bump kCheckpointVersion.
+ */
+
+/**
+ * @brief Everything an entity carries from one step to the next. Fields an
+ * entity type does not have are left 0.
+ */
+struct entity_state {
+  double x;
+  double y;
+  double theta;
+  double radius;
+  double intensity;
+  double speed;
+  // MotionHandler (robots and lights).
+  double velocity_left;
+  double velocity_right;
+  double max_speed;
+  double max_angle;
+  double speed_delta;
+  double angle_delta;
+  // Robot: time of the last collision; Light: start of the last retreat.
+  uint64_t timer;
+  // Robot: time of the last meal.
+  uint64_t food_timer;
+  int32_t type;
+  int32_t id;
+  int32_t color_r;
+  int32_t color_g;
+  int32_t color_b;
+  // Robot only.
+  int32_t hunger;
+  int32_t food_count;
+  int32_t f_behavior;
+  int32_t l_behavior;
+  uint8_t retreating;
+  uint8_t starved;
+  uint8_t touch_output;
+  uint8_t food_exists;
+};
+
+/**
+ * @brief The state of one of a robot's light or food sensors.
+ */
+struct sensor_state {
+  double x;
+  double y;
+  double theta;
+  double impulse;
+  uint8_t active;
+  uint8_t reserved[7];
+};
+
+/**
+ * @brief The Arena's own state: how it was built and where it stands.
+ */
+struct arena_state {
+  double x_dim;
+  double y_dim;
+  double sensing_error;
+  uint64_t n_robots;
+  uint64_t n_lights;
+  uint64_t n_foods;
+  uint64_t seed;
+  uint64_t ticks;
+  uint64_t rng_state;
+  uint64_t n_collisions;
+  int32_t broad_phase;
+  int32_t n_threads;
+  int32_t game_status;
+  float f_e_ratio;
+  uint8_t paused;
+  uint8_t reserved[7];
+};
+
+static_assert(sizeof(entity_state) == 152, "entity_state has padding");
+static_assert(sizeof(sensor_state) == 40, "sensor_state has padding");
+static_assert(sizeof(arena_state) == 104, "arena_state has padding");
+
+NAMESPACE_END(csci3081);
+
+#endif  // SRC_ENTITY_STATE_H_
@@ -0,0 +1,76 @@
+/**
+ * @file entity_store.cc
+ *
+ * @copyright 2018 3081 Staff, All rights reserved.
+ */
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <cassert>
+
+#include "src/entity_store.h"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+NAMESPACE_BEGIN(csci3081);
+
+/*******************************************************************************
+ * Member Functions
+ ******************************************************************************/
+void EntityStore::Build(const std::vector<ArenaEntity *> &entities) {
+  size_t n = entities.size();
+  x_.resize(n);
+  y_.resize(n);
+  theta_.resize(n);
+  radius_.resize(n);
+  intensity_.resize(n);
+  type_.resize(n);
+
+  // The entities are partitioned by type, so each range ends where the next
+  // type starts.
+  size_t i = 0;
+  robots_.begin = i;
+  while (i < n && entities[i]->get_type() == kRobot) { ++i; }
+  robots_.end = i;
+  lights_.begin = i;
+  while (i < n && entities[i]->get_type() == kLight) { ++i; }
+  lights_.end = i;
+  foods_.begin = i;
+  while (i < n && entities[i]->get_type() == kFood) { ++i; }
+  foods_.end = i;
+  assert(i == n);
+
+  for (i = 0; i < n; ++i) {
+    type_[i] = entities[i]->get_type();
+  }
+  Gather(entities);
+} /* Build() */
+
+void EntityStore::Gather(const std::vector<ArenaEntity *> &entities,
+                         EntityRange range) {
+  for (size_t i = range.begin; i < range.end; ++i) {
+    const Pose &pose = entities[i]->get_pose();
+    x_[i] = pose.x;
+    y_[i] = pose.y;
+    theta_[i] = pose.theta;
+    radius_[i] = entities[i]->get_radius();
+    intensity_[i] = entities[i]->get_intensity();
+  }
+} /* Gather() */
+
+EntityRange EntityStore::range(EntityType type) const {
+  switch (type) {
+    case (kRobot):
+      return robots_;
+    case (kLight):
+      return lights_;
+    case (kFood):
+      return foods_;
+    default:
+      return {0, 0};
+  }
+}
+
+NAMESPACE_END(csci3081);
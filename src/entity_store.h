@@ -0,0 +1,120 @@
+/**
+ * @file entity_store.h
+ *
+ * @copyright 2018 3081 Staff, All rights reserved.
+ */
+
+#ifndef SRC_ENTITY_STORE_H_
+#define SRC_ENTITY_STORE_H_
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <cstddef>
+#include <vector>
+
+#include "src/arena_entity.h"
+#include "src/common.h"
+#include "src/entity_type.h"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+NAMESPACE_BEGIN(csci3081);
+
+/*******************************************************************************
+ * Structure Definitions
+ ******************************************************************************/
+/**
+ * @brief A half-open range [begin, end) of indices into an EntityStore.
+ */
+struct EntityRange {
+  size_t begin;
+  size_t end;
+  size_t size() const { return end - begin; }
+};
+
+/*******************************************************************************
+ * Class Definitions
+ ******************************************************************************/
+/**
+ * @brief Structure-of-arrays copy of the geometry of every entity in the
+ * Arena.
+ *
+ * Index i of every array describes the i'th entry of the entity vector the
+ * store was built from. That vector must be partitioned by type (all robots,
+ * then all lights, then all foods) so that each type is one contiguous range.
+ * Step kernels (sensing, broad-phase collision) loop over the range of the
+ * one type they need, over plain arrays, without pointer chasing or virtual
+ * calls.
+ *
+ * The ArenaEntity objects stay the owners of their state; the Arena calls
+ * Gather() at the points of the timestep where the kernels need a fresh copy.
+ * This is deliberate: poses are read and written through the entities by
+ * the motion handlers, the sensors, checkpoints and the viewer, and a gather
+ * costs well under 1% of a step (see BM_EntityStoreGather).
+ */
+class EntityStore {
+ public:
+  EntityStore() = default;
+
+  /**
+   * @brief Size the arrays for `entities`, record the type ranges, and gather
+   * the current geometry.
+   *
+   * @param entities The Arena's entities, partitioned robot, light, food.
+   */
+  void Build(const std::vector<ArenaEntity *> &entities);
+
+  /**
+   * @brief Copy the pose, radius and intensity of `entities[begin, end)`
+   * into the arrays.
+   */
+  void Gather(const std::vector<ArenaEntity *> &entities,
+              EntityRange range);
+
+  /**
+   * @brief Copy the pose, radius and intensity of every entity.
+   */
+  void Gather(const std::vector<ArenaEntity *> &entities) {
+    Gather(entities, {0, size()});
+  }
+
+  size_t size() const { return type_.size(); }
+
+  EntityRange robots() const { return robots_; }
+  EntityRange lights() const { return lights_; }
+  EntityRange foods() const { return foods_; }
+
+  /**
+   * @brief The robots and the lights, which are adjacent in the store.
+   */
+  EntityRange mobiles() const { return {robots_.begin, lights_.end}; }
+
+  /**
+   * @brief The range holding entities of `type`, or an empty range.
+   */
+  EntityRange range(EntityType type) const;
+
+  const double *x() const { return x_.data(); }
+  const double *y() const { return y_.data(); }
+  const double *theta() const { return theta_.data(); }
+  const double *radius() const { return radius_.data(); }
+  const double *intensity() const { return intensity_.data(); }
+  const EntityType *type() const { return type_.data(); }
+
+ private:
+  std::vector<double> x_{};
+  std::vector<double> y_{};
+  std::vector<double> theta_{};
+  std::vector<double> radius_{};
+  std::vector<double> intensity_{};
+  std::vector<EntityType> type_{};
+  EntityRange robots_{0, 0};
+  EntityRange lights_{0, 0};
+  EntityRange foods_{0, 0};
+};
+
+NAMESPACE_END(csci3081);
+
+#endif  // SRC_ENTITY_STORE_H_
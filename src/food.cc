@@ -15,6 +15,11 @@
  ******************************************************************************/
 NAMESPACE_BEGIN(csci3081);
 
+/*******************************************************************************
+ * Constants
+ ******************************************************************************/
+const char Food::kPoolName[] = "Food";
+
 /*******************************************************************************
  * Constructors/Destructor
  ******************************************************************************/
@@ -33,8 +38,7 @@ void Food::Reset() {
 } /* Reset */
 
 Pose Food::SetPoseRandomly() {
-  return {static_cast<double>((30 + (random() % 19) * 50)),
-      static_cast<double>((30 + (random() % 14) * 50))};
+  return RandomGridPose();
 }
 
 
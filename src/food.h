@@ -10,11 +10,13 @@
 /*******************************************************************************
  * Includes
  ******************************************************************************/
+#include <cstddef>
 #include <string>
 
 #include "src/arena_immobile_entity.h"
 #include "src/common.h"
 #include "src/entity_type.h"
+#include "src/object_pool.h"
 
 /*******************************************************************************
  * Namespaces
@@ -36,7 +38,7 @@ NAMESPACE_BEGIN(csci3081);
  * events.
  *
  */
-class Food : public ArenaImmobileEntity {
+class Food : public ArenaImmobileEntity, public PooledObject<Food> {
  public:
   /**
    * @brief Constructor.
@@ -46,6 +48,8 @@ class Food : public ArenaImmobileEntity {
    */
   Food();
 
+  static const char kPoolName[];
+
   /**
    * @brief Reset the Food using the initialization parameters received
    * by the constructor.
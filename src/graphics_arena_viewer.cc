@@ -7,6 +7,8 @@
 /*******************************************************************************
  * Includes
  ******************************************************************************/
+#include <chrono>
+#include <cstdio>
 #include <vector>
 #include <iostream>
 #include <string>
@@ -15,24 +17,39 @@
 #include "src/arena_params.h"
 #include "src/params.h"
 #include "src/rgb_color.h"
+#include "src/sim_thread.h"
+#include "src/step_accumulator.h"
+#include "src/tracer.h"
 
 /*******************************************************************************
  * Namespaces
  ******************************************************************************/
 NAMESPACE_BEGIN(csci3081);
 
+/*******************************************************************************
+ * Constants
+ ******************************************************************************/
+// The time scales the speed button cycles through.
+static const double kTimeScales[] = {
+  1.0, 10.0, 100.0, StepAccumulator::kMaxTimeScale
+};
+static const char *const kTimeScaleLabels[] = {
+  "Speed: 1x", "Speed: 10x", "Speed: 100x", "Speed: max"
+};
+static const int kNumTimeScales = sizeof(kTimeScales) / sizeof(kTimeScales[0]);
+
 /*******************************************************************************
  * Constructors/Destructor
  ******************************************************************************/
 GraphicsArenaViewer::GraphicsArenaViewer(
     const struct arena_params *const params,
-    Arena * arena, Controller * controller) :
+    SnapshotBuffer * snapshots, Controller * controller) :
     GraphicsApp(
         params->x_dim + GUI_MENU_WIDTH + GUI_MENU_GAP * 2,
         params->y_dim,
         "Robot Simulation"),
     controller_(controller),
-    arena_(arena) {
+    snapshots_(snapshots) {
   auto *gui = new nanogui::FormHelper(screen());
   nanogui::ref<nanogui::Window> window =
       gui->addWindow(
@@ -52,6 +69,21 @@ GraphicsArenaViewer::GraphicsArenaViewer(
       "Play",
       std::bind(&GraphicsArenaViewer::OnPlayingBtnPressed, this));
   playing_button_->setFixedWidth(100);
+  speed_button_ =
+    gui->addButton(
+      kTimeScaleLabels[0],
+      std::bind(&GraphicsArenaViewer::OnSpeedBtnPressed, this));
+  speed_button_->setFixedWidth(100);
+  stats_button_ =
+    gui->addButton(
+      "Show Stats",
+      std::bind(&GraphicsArenaViewer::OnStatsBtnPressed, this));
+  stats_button_->setFixedWidth(100);
+  dump_latency_button_ =
+    gui->addButton(
+      "Dump Latency",
+      std::bind(&GraphicsArenaViewer::OnDumpLatencyBtnPressed, this));
+  dump_latency_button_->setFixedWidth(100);
 
   gui->addGroup("Arena Configuration");
   food_button_ =
@@ -212,18 +244,25 @@ GraphicsArenaViewer::GraphicsArenaViewer(
 // This is the primary driver for state change in the arena.
 // It will be called at each iteration of nanogui::mainloop()
 void GraphicsArenaViewer::UpdateSimulation(double dt) {
+  ScopedTrace trace("update", "render");
+  frame_seconds_.Add(dt);
+  frame_latency_.Record(dt);
+  controller_->PollArenaRebuild();
+  snapshots_->Acquire();
+  const arena_snapshot &previous = snapshots_->get_previous();
+  const arena_snapshot &latest = snapshots_->get_latest();
+  InterpolateSnapshots(
+    previous, latest,
+    SnapshotBlend(previous, latest, SimulationThread::WallSeconds()),
+    &frame_);
   if (paused_) {
-    controller_->AdvanceTime(0);
-  } else if (arena_->get_game_status() == WON) {
+    return;
+  } else if (latest.game_status == WON) {
     stopped_ = true;
     playing_button_->setCaption("You Win");
-    controller_->AdvanceTime(0);
-  } else if (arena_->get_game_status() == LOST) {
+  } else if (latest.game_status == LOST) {
     stopped_ = true;
     playing_button_->setCaption("You Lose");
-    controller_->AdvanceTime(0);
-  } else {
-    controller_->AdvanceTime(dt);
   }
 }
 
@@ -244,6 +283,22 @@ void GraphicsArenaViewer::OnPlayingBtnPressed() {
   }
 }
 
+void GraphicsArenaViewer::OnSpeedBtnPressed() {
+  time_scale_index_ = (time_scale_index_ + 1) % kNumTimeScales;
+  speed_button_->setCaption(kTimeScaleLabels[time_scale_index_]);
+  controller_->SetTimeScale(kTimeScales[time_scale_index_]);
+}
+
+void GraphicsArenaViewer::OnStatsBtnPressed() {
+  show_stats_ = !show_stats_;
+  stats_button_->setCaption(show_stats_ ? "Hide Stats" : "Show Stats");
+}
+
+void GraphicsArenaViewer::OnDumpLatencyBtnPressed() {
+  DumpFrameLatency();
+  controller_->DumpStepLatency();
+}
+
 void GraphicsArenaViewer::OnFoodBtnPressed() {
   if (paused_ || stopped_) {
   if (!food_) {
@@ -276,22 +331,22 @@ void GraphicsArenaViewer::OnNewGameBtnPressed() {
  * Drawing of Entities in Arena
  ******************************************************************************/
 void GraphicsArenaViewer::DrawRobot(NVGcontext *ctx,
-                                     const Robot *const robot) {
+                                     const entity_snapshot &robot) {
   // translate and rotate all graphics calls that follow so that they are
   // centered, at the position and heading of this robot
   nvgSave(ctx);
   nvgTranslate(ctx,
-               static_cast<float>(robot->get_pose().x),
-               static_cast<float>(robot->get_pose().y));
+               static_cast<float>(robot.x),
+               static_cast<float>(robot.y));
   nvgRotate(ctx,
-            static_cast<float>(robot->get_pose().theta * M_PI / 180.0));
+            static_cast<float>(robot.theta * M_PI / 180.0));
 
   // robot's circle
   nvgBeginPath(ctx);
-  nvgCircle(ctx, 0.0, 0.0, static_cast<float>(robot->get_radius()));
+  nvgCircle(ctx, 0.0, 0.0, static_cast<float>(robot.radius));
   nvgFillColor(ctx,
-               nvgRGBA(robot->get_color().r, robot->get_color().g,
-                       robot->get_color().b, 255));
+               nvgRGBA(robot.color.r, robot.color.g,
+                       robot.color.b, 255));
   nvgFill(ctx);
   nvgStrokeColor(ctx, nvgRGBA(0, 0, 0, 255));
   nvgStroke(ctx);
@@ -300,55 +355,56 @@ void GraphicsArenaViewer::DrawRobot(NVGcontext *ctx,
   nvgSave(ctx);
   nvgRotate(ctx, static_cast<float>(M_PI / 2.0));
   nvgFillColor(ctx, nvgRGBA(0, 0, 0, 255));
-  nvgText(ctx, 0.0, -10.0, robot->get_name().c_str(), nullptr);
-  std::string info = std::to_string(robot->get_l_behavior()) + ", " +
-                     std::to_string(robot->get_f_behavior()) + ", " +
-                     std::to_string(robot->is_hungry());
+  nvgText(ctx, 0.0, -10.0, robot.name.c_str(), nullptr);
+  std::string info = std::to_string(robot.l_behavior) + ", " +
+                     std::to_string(robot.f_behavior) + ", " +
+                     std::to_string(robot.hunger);
   nvgText(ctx, 0.0, 0.0, info.c_str(), nullptr);
   nvgRestore(ctx);
   nvgRestore(ctx);
 }
 
 void GraphicsArenaViewer::DrawSensor(NVGcontext *ctx,
-                                       const Sensor *const sensor) {
+                                       const entity_snapshot &sensor) {
   nvgBeginPath(ctx);
   nvgCircle(ctx,
-            static_cast<float>(sensor->get_pose().x),
-            static_cast<float>(sensor->get_pose().y),
-            static_cast<float>(sensor->get_radius()));
+            static_cast<float>(sensor.x),
+            static_cast<float>(sensor.y),
+            static_cast<float>(sensor.radius));
   nvgFillColor(ctx,
-               nvgRGBA(sensor->get_color().r, sensor->get_color().g,
-                       sensor->get_color().b, 255));
+               nvgRGBA(sensor.color.r, sensor.color.g,
+                       sensor.color.b, 255));
   nvgFill(ctx);
   nvgStrokeColor(ctx, nvgRGBA(0, 0, 0, 255));
   nvgStroke(ctx);
 
   nvgFillColor(ctx, nvgRGBA(0, 0, 0, 255));
   nvgText(ctx,
-          static_cast<float>(sensor->get_pose().x),
-          static_cast<float>(sensor->get_pose().y),
+          static_cast<float>(sensor.x),
+          static_cast<float>(sensor.y),
           "X", nullptr);
 }
 
 void GraphicsArenaViewer::DrawArena(NVGcontext *ctx) {
   nvgBeginPath(ctx);
   // Creates new rectangle shaped sub-path.
-  nvgRect(ctx, 0, 0, arena_->get_x_dim(), arena_->get_y_dim());
+  nvgRect(ctx, 0, 0, static_cast<float>(frame_.x_dim),
+          static_cast<float>(frame_.y_dim));
   nvgStrokeColor(ctx, nvgRGBA(255, 255, 255, 255));
   nvgStroke(ctx);
 }
 
 void GraphicsArenaViewer::DrawEntity(NVGcontext *ctx,
-                                       const ArenaEntity *const entity) {
+                                       const entity_snapshot &entity) {
   // light's circle
   nvgBeginPath(ctx);
   nvgCircle(ctx,
-            static_cast<float>(entity->get_pose().x),
-            static_cast<float>(entity->get_pose().y),
-            static_cast<float>(entity->get_radius()));
+            static_cast<float>(entity.x),
+            static_cast<float>(entity.y),
+            static_cast<float>(entity.radius));
   nvgFillColor(ctx,
-               nvgRGBA(entity->get_color().r, entity->get_color().g,
-                       entity->get_color().b, 255));
+               nvgRGBA(entity.color.r, entity.color.g,
+                       entity.color.b, 255));
   nvgFill(ctx);
   nvgStrokeColor(ctx, nvgRGBA(0, 0, 0, 255));
   nvgStroke(ctx);
@@ -356,31 +412,91 @@ void GraphicsArenaViewer::DrawEntity(NVGcontext *ctx,
   // light id text label
   nvgFillColor(ctx, nvgRGBA(0, 0, 0, 255));
   nvgText(ctx,
-          static_cast<float>(entity->get_pose().x),
-          static_cast<float>(entity->get_pose().y),
-          entity->get_name().c_str(), nullptr);
+          static_cast<float>(entity.x),
+          static_cast<float>(entity.y),
+          entity.name.c_str(), nullptr);
+}
+
+void GraphicsArenaViewer::DrawStatsOverlay(NVGcontext *ctx) {
+  int n_robots = 0, n_lights = 0, n_foods = 0;
+  for (auto &entity : frame_.entities) {
+    n_robots += (entity.type == kRobot);
+    n_lights += (entity.type == kLight);
+    n_foods += (entity.type == kFood);
+  }
+  const step_stats &stats = frame_.stats;
+  double frame_s = frame_seconds_.get_mean();
+  char line[96];
+
+  nvgSave(ctx);
+  nvgFontSize(ctx, 14.0f);
+  nvgFontFace(ctx, "sans");
+  nvgTextAlign(ctx, NVG_ALIGN_LEFT | NVG_ALIGN_TOP);
+  nvgBeginPath(ctx);
+  nvgRect(ctx, 5.0f, 5.0f, 250.0f, 16.0f * (kNumStepPhases + 5) + 10.0f);
+  nvgFillColor(ctx, nvgRGBA(0, 0, 0, 160));
+  nvgFill(ctx);
+  nvgFillColor(ctx, nvgRGBA(255, 255, 255, 255));
+
+  float y = 10.0f;
+  snprintf(line, sizeof(line), "FPS %.0f  draw %.2f ms",
+           frame_s > 0 ? 1.0 / frame_s : 0.0,
+           draw_seconds_.get_mean() * 1000.0);
+  nvgText(ctx, 10.0f, y, line, nullptr);
+  y += 16.0f;
+  snprintf(line, sizeof(line), "steps/sec %.0f  step %.2f ms (max %.2f)",
+           stats.steps_per_second, stats.step_mean_ms, stats.step_max_ms);
+  nvgText(ctx, 10.0f, y, line, nullptr);
+  y += 16.0f;
+  snprintf(line, sizeof(line), "p50 %.2f p99 %.2f p99.9 %.2f ms  over %llu",
+           stats.step_p50_ms, stats.step_p99_ms, stats.step_p999_ms,
+           static_cast<unsigned long long>(stats.n_over_budget));
+  nvgText(ctx, 10.0f, y, line, nullptr);
+  y += 16.0f;
+  for (int phase = 0; phase < kNumStepPhases; ++phase) {
+    snprintf(line, sizeof(line), "  %-10s %.3f ms (max %.3f)",
+             StepProfiler::PhaseName(static_cast<StepPhase>(phase)),
+             stats.phase_mean_ms[phase], stats.phase_max_ms[phase]);
+    nvgText(ctx, 10.0f, y, line, nullptr);
+    y += 16.0f;
+  }
+  snprintf(line, sizeof(line), "robots %d  lights %d  foods %d",
+           n_robots, n_lights, n_foods);
+  nvgText(ctx, 10.0f, y, line, nullptr);
+  y += 16.0f;
+  snprintf(line, sizeof(line), "sensors %zu  steps %llu",
+           frame_.sensors.size(),
+           static_cast<unsigned long long>(stats.n_steps));
+  nvgText(ctx, 10.0f, y, line, nullptr);
+  nvgRestore(ctx);
 }
 
 void GraphicsArenaViewer::DrawUsingNanoVG(NVGcontext *ctx) {
+  ScopedTrace trace("draw", "render");
+  auto draw_start = std::chrono::steady_clock::now();
   // initialize text rendering settings
   if (!paused_ && !stopped_) {
   nvgFontSize(ctx, 18.0f);
   nvgFontFace(ctx, "sans-bold");
   nvgTextAlign(ctx, NVG_ALIGN_CENTER | NVG_ALIGN_MIDDLE);
   DrawArena(ctx);
-  std::vector<ArenaEntity *> entities = arena_->get_entities();
-  for (auto &entity : entities) {
+  for (auto &entity : frame_.entities) {
     DrawEntity(ctx, entity);
   } /* for(i..) */
-  std::vector<Robot *> robots = arena_->get_robots();
-  for (auto &robot : robots) {
-    DrawRobot(ctx, robot);
+  for (auto &entity : frame_.entities) {
+    if (entity.type == kRobot) {
+      DrawRobot(ctx, entity);
+    }
   }
-  std::vector<Sensor *> sensors = arena_->get_sensors();
-  for (auto &sensor : sensors) {
+  for (auto &sensor : frame_.sensors) {
     DrawSensor(ctx, sensor);
   }
   }
+  if (show_stats_) {
+    DrawStatsOverlay(ctx);
+  }
+  draw_seconds_.Add(std::chrono::duration<double>(
+    std::chrono::steady_clock::now() - draw_start).count());
 }
 
 NAMESPACE_END(csci3081);
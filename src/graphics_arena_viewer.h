@@ -11,12 +11,16 @@
  * Includes
  ******************************************************************************/
 #include <MinGfx-1.0/mingfx.h>
+#include <iostream>
 
 #include "src/entity_factory.h"
 #include "src/arena.h"
+#include "src/arena_snapshot.h"
 #include "src/controller.h"
 #include "src/common.h"
 #include "src/communication.h"
+#include "src/latency_histogram.h"
+#include "src/step_profiler.h"
 
 /*******************************************************************************
  * Namespaces
@@ -46,8 +50,10 @@ class Controller;
  *  ```
  *
  *  While the window is open UpdateSimulation will be called repeatedly,
- *  once per frame. Fill this in to update your simulation or perform any other
- *  processing that should happen over time as the simulation progresses.
+ *  once per frame. The Arena itself steps on the Controller's
+ *  SimulationThread; the viewer only ever reads the snapshots it publishes,
+ *  and draws a blend of the newest two so that motion stays smooth whatever
+ *  rate the simulation runs at.
  *
  *  Fill in the `On*()` methods as desired to respond to user input events.
  *
@@ -61,21 +67,18 @@ class GraphicsArenaViewer : public GraphicsApp {
    *
    * @param params A arena_params passed down from main.cc for the
    * initialization of the Arena and the entities therein.
+   * @param snapshots Where the simulation thread publishes the Arena.
    */
   explicit GraphicsArenaViewer(const struct arena_params *const params,
-                               Arena *arena, Controller *controller);
+                               SnapshotBuffer *snapshots,
+                               Controller *controller);
 
   /**
-   * @brief Destructor.
+   * @brief Takes the newest snapshot of the Arena, if there is one, and
+   * works out the frame to draw.
    *
-   * `delete` the contained Arena.
-   */
-  ~GraphicsArenaViewer() override { delete arena_; }
-
-  /**
-   * @brief Informs the Arena of the new time, so that it can update.
-   *
-   * @param dt The new timestep.
+   * @param dt The time since the last frame. Only used for the frame rate
+   * in the stats overlay: the snapshots carry their own times.
    */
   void UpdateSimulation(double dt) override;
 
@@ -97,6 +100,31 @@ class GraphicsArenaViewer : public GraphicsApp {
 
   void OnFoodBtnPressed();
 
+  /**
+   * @brief Handle the user pressing the speed button on the GUI.
+   *
+   * Cycles the time scale through 1x, 10x, 100x and max. At max the
+   * simulation runs MAX_STEPS_PER_FRAME timesteps per frame.
+   */
+  void OnSpeedBtnPressed();
+
+  /**
+   * @brief Show or hide the performance overlay: frame rate, draw time,
+   * steps per second, the cost of each phase of a step and the entity
+   * counts.
+   */
+  void OnStatsBtnPressed();
+
+  /**
+   * @brief Print the frame and step latency histograms to std::cout.
+   */
+  void OnDumpLatencyBtnPressed();
+
+  /**
+   * @brief Print the frame latency histogram to std::cout.
+   */
+  void DumpFrameLatency() const { frame_latency_.Dump(std::cout, "frame"); }
+
   /**
    * @brief Called each time the mouse moves on the screen within the GUI
    * window.
@@ -210,8 +238,6 @@ class GraphicsArenaViewer : public GraphicsApp {
    */
   GraphicsArenaViewer(const GraphicsArenaViewer &other) = delete;
 
-  void set_arena(Arena * arena) {arena_ = arena;}
-
   int get_n_robots() { return n_robots_; }
   int get_n_lights() { return n_lights_; }
   int get_n_foods() { return n_foods_; }
@@ -227,7 +253,7 @@ class GraphicsArenaViewer : public GraphicsApp {
    * @param[in] ctx The `nanovg` context.
    * @param[in] robot The Robot handle.
    */
-  void DrawRobot(NVGcontext *ctx, const class Robot *const robot);
+  void DrawRobot(NVGcontext *ctx, const entity_snapshot &robot);
 
   /**
    * @breif Draws sensors using 'nanogui'.
@@ -238,7 +264,7 @@ class GraphicsArenaViewer : public GraphicsApp {
    * @param[in] sensor The relevant sensor being drawn.
    */
 
-  void DrawSensor(NVGcontext *ctx, const class Sensor *const sensor);
+  void DrawSensor(NVGcontext *ctx, const entity_snapshot &sensor);
 
   /**
    * @brief Draw an Light in the Arena using `nanogui`.
@@ -249,13 +275,28 @@ class GraphicsArenaViewer : public GraphicsApp {
    * @param[in] ctx The `nanovg` context.
    * @param[in] light The Light handle.
    */
-  void DrawEntity(NVGcontext *ctx, const class ArenaEntity *const entity);
+  void DrawEntity(NVGcontext *ctx, const entity_snapshot &entity);
+
+  /**
+   * @brief Draw the performance overlay in the top left of the Arena.
+   */
+  void DrawStatsOverlay(NVGcontext *ctx);
 
   Controller *controller_;
-  Arena *arena_;
+  SnapshotBuffer *snapshots_;
+  // What DrawUsingNanoVG() draws: the newest snapshots, blended.
+  arena_snapshot frame_{};
   bool paused_{true};
   bool stopped_{false};
   bool food_{true};
+  // Index into the viewer's table of time scales.
+  int time_scale_index_{0};
+  bool show_stats_{false};
+  // Seconds between frames and seconds spent drawing, for the overlay.
+  RollingWindow frame_seconds_{};
+  RollingWindow draw_seconds_{};
+  // Every frame's interval since the viewer opened.
+  LatencyHistogram frame_latency_{};
 
   // object counts
   int n_foods_{0};
@@ -266,6 +307,9 @@ class GraphicsArenaViewer : public GraphicsApp {
   nanogui::Button *food_button_{nullptr};
   nanogui::Button *playing_button_{nullptr};
   nanogui::Button *new_game_button_{nullptr};
+  nanogui::Button *speed_button_{nullptr};
+  nanogui::Button *stats_button_{nullptr};
+  nanogui::Button *dump_latency_button_{nullptr};
 };
 
 NAMESPACE_END(csci3081);
@@ -0,0 +1,219 @@
+/**
+ * @file impulse_kernel.cc
+ *
+ * @copyright 2018 3081 Staff, All rights reserved.
+ */
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <algorithm>
+#include <cmath>
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
+#include "src/impulse_kernel.h"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+NAMESPACE_BEGIN(csci3081);
+
+/*******************************************************************************
+ * Constants
+ ******************************************************************************/
+// Emitters per block: x, y and intensity of a block take 12 KiB, so a block
+// stays in L1 while every sensor is run against it.
+static const size_t kEmitterBlock = 512;
+
+#if defined(__x86_64__)
+// exp(t) = 2^n * exp(r), with n = round(t / ln 2) and |r| <= ln 2 / 2. ln 2
+// is split in two so that n * kLn2Hi is exact.
+static const double kLog2E = 1.4426950408889634074;
+static const double kLn2Hi = 6.93147180369123816490e-01;
+static const double kLn2Lo = 1.90821492927058770002e-10;
+// Below this exp() would underflow; the clamped result is ~1e-308.
+static const double kExpMin = -708.0;
+// 1/k! for k = 12 down to 2: the Taylor series of exp(r) is accurate to
+// about 1e-16 for |r| <= ln 2 / 2.
+static const double kExpCoeff[] = {
+  1.0 / 479001600.0, 1.0 / 39916800.0, 1.0 / 3628800.0, 1.0 / 362880.0,
+  1.0 / 40320.0, 1.0 / 5040.0, 1.0 / 720.0, 1.0 / 120.0, 1.0 / 24.0,
+  1.0 / 6.0, 1.0 / 2.0
+};
+#endif
+
+/*******************************************************************************
+ * Non-Member Functions
+ ******************************************************************************/
+// One sensor against emitters [begin, end), in order, exactly as
+// Sensor::ReceiveInfo() sums them.
+static double ScalarSum(double sx, double sy, const double *emitter_x,
+                        const double *emitter_y, const double *intensity,
+                        size_t begin, size_t end, double sum) {
+  for (size_t e = begin; e < end; ++e) {
+    double dx = emitter_x[e] - sx;
+    double dy = emitter_y[e] - sy;
+    sum += intensity[e] / std::pow(1.08, std::sqrt(dx*dx + dy*dy));
+  }
+  return sum;
+}
+
+static void ScalarKernel(const double *sensor_x, const double *sensor_y,
+                         size_t n_sensors, const double *emitter_x,
+                         const double *emitter_y, const double *intensity,
+                         size_t n_emitters, double *impulse) {
+  for (size_t block = 0; block < n_emitters; block += kEmitterBlock) {
+    size_t end = std::min(block + kEmitterBlock, n_emitters);
+    for (size_t s = 0; s < n_sensors; ++s) {
+      impulse[s] = ScalarSum(sensor_x[s], sensor_y[s], emitter_x, emitter_y,
+                             intensity, block, end, impulse[s]);
+    }
+  }
+}
+
+#if defined(__x86_64__)
+// SSE2 is part of x86-64, so this needs no run-time check.
+static inline __m128d Exp128(__m128d t) {
+  t = _mm_max_pd(t, _mm_set1_pd(kExpMin));
+  __m128i n_int = _mm_cvtpd_epi32(_mm_mul_pd(t, _mm_set1_pd(kLog2E)));
+  __m128d n = _mm_cvtepi32_pd(n_int);
+  __m128d r = _mm_sub_pd(t, _mm_mul_pd(n, _mm_set1_pd(kLn2Hi)));
+  r = _mm_sub_pd(r, _mm_mul_pd(n, _mm_set1_pd(kLn2Lo)));
+  __m128d p = _mm_set1_pd(kExpCoeff[0]);
+  for (size_t k = 1; k < sizeof(kExpCoeff) / sizeof(kExpCoeff[0]); ++k) {
+    p = _mm_add_pd(_mm_mul_pd(p, r), _mm_set1_pd(kExpCoeff[k]));
+  }
+  p = _mm_add_pd(_mm_mul_pd(p, r), _mm_set1_pd(1.0));
+  p = _mm_add_pd(_mm_mul_pd(p, r), _mm_set1_pd(1.0));
+  // 2^n, built directly in the exponent bits.
+  __m128i bits = _mm_add_epi32(n_int, _mm_set1_epi32(1023));
+  bits = _mm_slli_epi64(_mm_unpacklo_epi32(bits, _mm_setzero_si128()), 52);
+  return _mm_mul_pd(p, _mm_castsi128_pd(bits));
+}
+
+static void Sse2Kernel(const double *sensor_x, const double *sensor_y,
+                       size_t n_sensors, const double *emitter_x,
+                       const double *emitter_y, const double *intensity,
+                       size_t n_emitters, double *impulse) {
+  const __m128d neg_log_base = _mm_set1_pd(-std::log(1.08));
+  for (size_t block = 0; block < n_emitters; block += kEmitterBlock) {
+    size_t end = std::min(block + kEmitterBlock, n_emitters);
+    size_t vector_end = block + (end - block) / 2 * 2;
+    for (size_t s = 0; s < n_sensors; ++s) {
+      __m128d sx = _mm_set1_pd(sensor_x[s]);
+      __m128d sy = _mm_set1_pd(sensor_y[s]);
+      __m128d sum = _mm_setzero_pd();
+      for (size_t e = block; e < vector_end; e += 2) {
+        __m128d dx = _mm_sub_pd(_mm_loadu_pd(emitter_x + e), sx);
+        __m128d dy = _mm_sub_pd(_mm_loadu_pd(emitter_y + e), sy);
+        __m128d d = _mm_sqrt_pd(_mm_add_pd(_mm_mul_pd(dx, dx),
+                                           _mm_mul_pd(dy, dy)));
+        __m128d falloff = Exp128(_mm_mul_pd(d, neg_log_base));
+        sum = _mm_add_pd(sum, _mm_mul_pd(_mm_loadu_pd(intensity + e),
+                                         falloff));
+      }
+      double lanes[2];
+      _mm_storeu_pd(lanes, sum);
+      impulse[s] += lanes[0] + lanes[1];
+      impulse[s] = ScalarSum(sensor_x[s], sensor_y[s], emitter_x, emitter_y,
+                             intensity, vector_end, end, impulse[s]);
+    }
+  }
+}
+
+__attribute__((target("avx2,fma")))
+static inline __m256d Exp256(__m256d t) {
+  t = _mm256_max_pd(t, _mm256_set1_pd(kExpMin));
+  __m256d n = _mm256_round_pd(_mm256_mul_pd(t, _mm256_set1_pd(kLog2E)),
+                              _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+  __m256d r = _mm256_fnmadd_pd(n, _mm256_set1_pd(kLn2Hi), t);
+  r = _mm256_fnmadd_pd(n, _mm256_set1_pd(kLn2Lo), r);
+  __m256d p = _mm256_set1_pd(kExpCoeff[0]);
+  for (size_t k = 1; k < sizeof(kExpCoeff) / sizeof(kExpCoeff[0]); ++k) {
+    p = _mm256_fmadd_pd(p, r, _mm256_set1_pd(kExpCoeff[k]));
+  }
+  p = _mm256_fmadd_pd(p, r, _mm256_set1_pd(1.0));
+  p = _mm256_fmadd_pd(p, r, _mm256_set1_pd(1.0));
+  // 2^n, built directly in the exponent bits.
+  __m256i bits = _mm256_cvtepi32_epi64(_mm256_cvtpd_epi32(n));
+  bits = _mm256_slli_epi64(
+    _mm256_add_epi64(bits, _mm256_set1_epi64x(1023)), 52);
+  return _mm256_mul_pd(p, _mm256_castsi256_pd(bits));
+}
+
+__attribute__((target("avx2,fma")))
+static void Avx2Kernel(const double *sensor_x, const double *sensor_y,
+                       size_t n_sensors, const double *emitter_x,
+                       const double *emitter_y, const double *intensity,
+                       size_t n_emitters, double *impulse) {
+  const __m256d neg_log_base = _mm256_set1_pd(-std::log(1.08));
+  for (size_t block = 0; block < n_emitters; block += kEmitterBlock) {
+    size_t end = std::min(block + kEmitterBlock, n_emitters);
+    size_t vector_end = block + (end - block) / 4 * 4;
+    for (size_t s = 0; s < n_sensors; ++s) {
+      __m256d sx = _mm256_set1_pd(sensor_x[s]);
+      __m256d sy = _mm256_set1_pd(sensor_y[s]);
+      __m256d sum = _mm256_setzero_pd();
+      for (size_t e = block; e < vector_end; e += 4) {
+        __m256d dx = _mm256_sub_pd(_mm256_loadu_pd(emitter_x + e), sx);
+        __m256d dy = _mm256_sub_pd(_mm256_loadu_pd(emitter_y + e), sy);
+        __m256d d = _mm256_sqrt_pd(
+          _mm256_fmadd_pd(dx, dx, _mm256_mul_pd(dy, dy)));
+        __m256d falloff = Exp256(_mm256_mul_pd(d, neg_log_base));
+        sum = _mm256_fmadd_pd(_mm256_loadu_pd(intensity + e), falloff, sum);
+      }
+      double lanes[4];
+      _mm256_storeu_pd(lanes, sum);
+      impulse[s] += (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+      impulse[s] = ScalarSum(sensor_x[s], sensor_y[s], emitter_x, emitter_y,
+                             intensity, vector_end, end, impulse[s]);
+    }
+  }
+}
+#endif
+
+ImpulseKernelIsa ResolveImpulseKernel(ImpulseKernelIsa isa) {
+#if defined(__x86_64__)
+  static const bool has_avx2 =
+    __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+  if (isa == kBestKernel) {
+    isa = kAvx2Kernel;
+  }
+  if (isa == kAvx2Kernel && !has_avx2) {
+    isa = kSse2Kernel;
+  }
+  return isa;
+#else
+  (void) isa;
+  return kScalarKernel;
+#endif
+}
+
+void ComputeImpulses(const double *sensor_x, const double *sensor_y,
+                     size_t n_sensors,
+                     const double *emitter_x, const double *emitter_y,
+                     const double *intensity, size_t n_emitters,
+                     double *impulse, ImpulseKernelIsa isa) {
+  std::fill(impulse, impulse + n_sensors, 0.0);
+  switch (ResolveImpulseKernel(isa)) {
+#if defined(__x86_64__)
+    case (kAvx2Kernel):
+      Avx2Kernel(sensor_x, sensor_y, n_sensors, emitter_x, emitter_y,
+                 intensity, n_emitters, impulse);
+      break;
+    case (kSse2Kernel):
+      Sse2Kernel(sensor_x, sensor_y, n_sensors, emitter_x, emitter_y,
+                 intensity, n_emitters, impulse);
+      break;
+#endif
+    default:
+      ScalarKernel(sensor_x, sensor_y, n_sensors, emitter_x, emitter_y,
+                   intensity, n_emitters, impulse);
+      break;
+  }
+} /* ComputeImpulses() */
+
+NAMESPACE_END(csci3081);
@@ -0,0 +1,65 @@
+/**
+ * @file impulse_kernel.h
+ *
+ * @copyright 2018 3081 Staff, All rights reserved.
+ */
+
+#ifndef SRC_IMPULSE_KERNEL_H_
+#define SRC_IMPULSE_KERNEL_H_
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <cstddef>
+
+#include "src/common.h"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+NAMESPACE_BEGIN(csci3081);
+
+/*******************************************************************************
+ * Type Definitions
+ ******************************************************************************/
+/**
+ * @brief The instruction sets ComputeImpulses() can run on.
+ */
+enum ImpulseKernelIsa {
+  kScalarKernel,  // Plain C++, one emitter at a time.
+  kSse2Kernel,    // Two emitters at a time.
+  kAvx2Kernel,    // Four emitters at a time, with FMA.
+  kBestKernel     // The widest one the CPU supports.
+};
+
+/*******************************************************************************
+ * Non-Member Functions
+ ******************************************************************************/
+/**
+ * @brief The impulse each sensor receives from a set of emitters.
+ *
+ * For every sensor s, computes
+ *   impulse[s] = sum over emitters e of intensity[e] / 1.08^distance(s, e),
+ * the same sum as Sensor::ReceiveInfo(), for all sensors in one pass over
+ * contiguous arrays. The emitters are walked in blocks that fit in L1 cache,
+ * and the vector kernels evaluate 1.08^-d as exp(-d ln 1.08) with a
+ * polynomial accurate to a few ulp. Each sensor's sum is accumulated in the
+ * same order no matter how the sensors are split between calls.
+ *
+ * @param[in] isa The instruction set to use. Requests the CPU cannot run
+ * fall back to the widest one it can.
+ */
+void ComputeImpulses(const double *sensor_x, const double *sensor_y,
+                     size_t n_sensors,
+                     const double *emitter_x, const double *emitter_y,
+                     const double *intensity, size_t n_emitters,
+                     double *impulse, ImpulseKernelIsa isa = kBestKernel);
+
+/**
+ * @brief The instruction set that `isa` resolves to on this CPU.
+ */
+ImpulseKernelIsa ResolveImpulseKernel(ImpulseKernelIsa isa);
+
+NAMESPACE_END(csci3081);
+
+#endif  // SRC_IMPULSE_KERNEL_H_
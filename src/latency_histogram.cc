@@ -0,0 +1,114 @@
+/**
+ * @file latency_histogram.cc
+ *
+ * @copyright 2018 3081 Staff, All rights reserved.
+ */
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <algorithm>
+#include <cmath>
+
+#include "src/latency_histogram.h"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+NAMESPACE_BEGIN(csci3081);
+
+/*******************************************************************************
+ * Constants
+ ******************************************************************************/
+// Values below kLinear have a bucket each. Above, each power of two is
+// split into kLinear / 2 buckets.
+static const int kSubBits = 8;
+static const uint64_t kLinear = uint64_t{1} << kSubBits;
+static const uint64_t kHalf = kLinear / 2;
+// The longest duration told apart from longer ones: 2^40 ns, ~18 minutes.
+static const int kMaxBits = 40;
+static const uint64_t kMaxNs = (uint64_t{1} << kMaxBits) - 1;
+static const size_t kNumBuckets = kLinear + (kMaxBits - kSubBits) * kHalf;
+
+/*******************************************************************************
+ * Constructors/Destructor
+ ******************************************************************************/
+LatencyHistogram::LatencyHistogram() : counts_(kNumBuckets, 0) {}
+
+/*******************************************************************************
+ * Member Functions
+ ******************************************************************************/
+size_t LatencyHistogram::BucketOf(uint64_t ns) {
+  if (ns < kLinear) {
+    return ns;
+  }
+  // The highest set bit is at or above kSubBits; keep the kSubBits bits
+  // below and including it.
+  int shift = (63 - __builtin_clzll(ns)) - kSubBits + 1;
+  uint64_t sub = ns >> shift;  // In [kHalf, kLinear).
+  return kLinear + (shift - 1) * kHalf + (sub - kHalf);
+}
+
+uint64_t LatencyHistogram::BucketTop(size_t bucket) {
+  if (bucket < kLinear) {
+    return bucket;
+  }
+  size_t k = bucket - kLinear;
+  int shift = static_cast<int>(k / kHalf) + 1;
+  uint64_t sub = k % kHalf + kHalf;
+  return ((sub + 1) << shift) - 1;
+}
+
+void LatencyHistogram::Record(double seconds) {
+  double ns = seconds * 1e9;
+  uint64_t value = ns < 0 ? 0
+                 : ns < kMaxNs ? static_cast<uint64_t>(std::llround(ns))
+                 : kMaxNs;
+  ++counts_[BucketOf(value)];
+  if (count_ == 0 || value < min_ns_) {
+    min_ns_ = value;
+  }
+  if (value > max_ns_) {
+    max_ns_ = value;
+  }
+  ++count_;
+  sum_ns_ += value;
+}
+
+void LatencyHistogram::Reset() {
+  std::fill(counts_.begin(), counts_.end(), 0);
+  count_ = 0;
+  min_ns_ = 0;
+  max_ns_ = 0;
+  sum_ns_ = 0.0;
+}
+
+double LatencyHistogram::ValueAtPercentile(double percentile) const {
+  if (count_ == 0) {
+    return 0.0;
+  }
+  double fraction = std::min(std::max(percentile, 0.0), 100.0) / 100.0;
+  uint64_t rank = static_cast<uint64_t>(std::ceil(fraction * count_));
+  rank = std::max<uint64_t>(rank, 1);
+  uint64_t seen = 0;
+  for (size_t bucket = 0; bucket < counts_.size(); ++bucket) {
+    seen += counts_[bucket];
+    if (seen >= rank) {
+      return std::min(BucketTop(bucket), max_ns_) * 1e-9;
+    }
+  }
+  return get_max();
+}
+
+void LatencyHistogram::Dump(std::ostream &out, const char *name) const {
+  out << name << " latency: count " << count_
+      << " mean " << get_mean() * 1e3
+      << " p50 " << ValueAtPercentile(50.0) * 1e3
+      << " p90 " << ValueAtPercentile(90.0) * 1e3
+      << " p99 " << ValueAtPercentile(99.0) * 1e3
+      << " p99.9 " << ValueAtPercentile(99.9) * 1e3
+      << " p99.99 " << ValueAtPercentile(99.99) * 1e3
+      << " max " << get_max() * 1e3 << " ms" << std::endl;
+}
+
+NAMESPACE_END(csci3081);
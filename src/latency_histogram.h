@@ -0,0 +1,85 @@
+/**
+ * @file latency_histogram.h
+ *
+ * @copyright 2018 3081 Staff, All rights reserved.
+ */
+
+#ifndef SRC_LATENCY_HISTOGRAM_H_
+#define SRC_LATENCY_HISTOGRAM_H_
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+#include "src/common.h"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+NAMESPACE_BEGIN(csci3081);
+
+/*******************************************************************************
+ * Class Definitions
+ ******************************************************************************/
+/**
+ * @brief A high-dynamic-range histogram of durations, from 1 ns to about
+ * 18 minutes, with a relative error of under 1% everywhere.
+ *
+ * Durations are counted in nanoseconds. Below 256 ns every value has a
+ * bucket of its own; above that, each power of two is split into 128
+ * equal buckets, so a bucket is never wider than 1/128 of its values.
+ * Longer durations are counted as the longest one.
+ *
+ * The buckets are allocated once, by the constructor: recording never
+ * allocates and takes constant time. The exact minimum, maximum and mean are
+ * kept as well.
+ */
+class LatencyHistogram {
+ public:
+  LatencyHistogram();
+
+  /**
+   * @brief Count one duration, in seconds.
+   */
+  void Record(double seconds);
+
+  void Reset();
+
+  /**
+   * @brief The duration that `percentile` percent of the recorded ones are
+   * at most, in seconds. The result is the top of the bucket it falls in,
+   * but never more than the maximum.
+   */
+  double ValueAtPercentile(double percentile) const;
+
+  uint64_t get_count() const { return count_; }
+  double get_min() const { return count_ > 0 ? min_ns_ * 1e-9 : 0.0; }
+  double get_max() const { return max_ns_ * 1e-9; }
+  double get_mean() const {
+    return count_ > 0 ? sum_ns_ / count_ * 1e-9 : 0.0;
+  }
+
+  /**
+   * @brief Write a one-line summary in milliseconds: the count, mean, p50,
+   * p90, p99, p99.9, p99.99 and max.
+   */
+  void Dump(std::ostream &out, const char *name) const;
+
+ private:
+  static size_t BucketOf(uint64_t ns);
+  static uint64_t BucketTop(size_t bucket);
+
+  std::vector<uint64_t> counts_;
+  uint64_t count_{0};
+  uint64_t min_ns_{0};
+  uint64_t max_ns_{0};
+  double sum_ns_{0.0};
+};
+
+NAMESPACE_END(csci3081);
+
+#endif  // SRC_LATENCY_HISTOGRAM_H_
@@ -7,16 +7,21 @@
 /*******************************************************************************
  * Includes
  ******************************************************************************/
-#include <ctime>
 
 #include "src/light.h"
 #include "src/params.h"
+#include "src/sim_clock.h"
 
 /*******************************************************************************
  * Namespaces
  ******************************************************************************/
 NAMESPACE_BEGIN(csci3081);
 
+/*******************************************************************************
+ * Constants
+ ******************************************************************************/
+const char Light::kPoolName[] = "Light";
+
 /*******************************************************************************
  * Constructors/Destructor
  ******************************************************************************/
@@ -36,10 +41,8 @@ void Light::TimestepUpdate(unsigned int dt) {
   sensor_touch_->Reset();
   if (get_march_direction() == true) {
     motion_handler_.Retreat();
-    std::clock_t end = std::clock();
-    double elapsed_time = static_cast<double>
-      (end - get_start_time()) / CLOCKS_PER_SEC;
-    if (elapsed_time >= 0.2) {
+    uint64_t elapsed = get_sim_time() - get_start_time();
+    if (elapsed >= SimClock::ToTicks(LIGHT_RETREAT_TIME)) {
       set_march_direction(false);
       motion_handler_.Advance();
     }
@@ -48,20 +51,34 @@ void Light::TimestepUpdate(unsigned int dt) {
 
 void Light::Reset() {
   motion_handler_.Advance();
-  thread_local unsigned int seed = time(NULL);
+  set_march_direction(false);
+  set_start_time(get_sim_time());
   set_pose(SetPoseRandomly());
-  set_radius((rand_r(&seed) % LIGHT_RADIUS)+LIGHT_RADIUS);
+  set_radius(RandomInt(LIGHT_RADIUS) + LIGHT_RADIUS);
 } /* Reset */
 
 Pose Light::SetPoseRandomly() {
-  return {static_cast<double>((30 + (random() % 19) * 50)),
-      static_cast<double>((30 + (random() % 14) * 50))};
+  return RandomGridPose();
+}
+
+void Light::SaveState(entity_state *state) const {
+  ArenaMobileEntity::SaveState(state);
+  motion_handler_.SaveState(state);
+  state->timer = start_;
+  state->retreating = retreating_;
+}
+
+void Light::LoadState(const entity_state &state) {
+  ArenaMobileEntity::LoadState(state);
+  motion_handler_.LoadState(state);
+  start_ = state.timer;
+  retreating_ = state.retreating != 0;
 }
 
 void Light::HandleCollision(EntityType object_type, ArenaEntity * object) {
   sensor_touch_->HandleCollision(object_type, object);
   set_march_direction(true);
-  set_start_time(std::clock());
+  set_start_time(get_sim_time());
 }
 
 
@@ -10,14 +10,16 @@
 /*******************************************************************************
  * Includes
  ******************************************************************************/
+#include <cstddef>
+#include <cstdint>
 #include <string>
-#include <ctime>
 
 #include "src/arena_mobile_entity.h"
 #include "src/common.h"
 #include "src/motion_handler.h"
 #include "src/motion_behavior_differential.h"
 #include "src/entity_type.h"
+#include "src/object_pool.h"
 #include "src/pose.h"
 
 /*******************************************************************************
@@ -33,18 +35,26 @@ NAMESPACE_BEGIN(csci3081);
  *
  * Lights are simple mobile entities so they function like simplified robots.
  */
-class Light : public ArenaMobileEntity {
+class Light : public ArenaMobileEntity, public PooledObject<Light> {
  public:
   /**
    * @brief Constructor.
    */
   Light();
 
+  static const char kPoolName[];
+
   /**
    * @brief Resets the light to a random position/size
    */
   void Reset() override;
 
+  /**
+   * @brief The Light's retreat and motion, on top of the base state.
+   */
+  void SaveState(entity_state *state) const override;
+  void LoadState(const entity_state &state) override;
+
   /**
    * @brief Update the Lights' positions at each timestep
    *
@@ -70,12 +80,12 @@ class Light : public ArenaMobileEntity {
   }
 
   /**
-   * @brief sets a clock using the <ctime> package for the sake of having
-   * the light only go into avoidance behavior for fixed amounts of time
+   * @brief The simulated time (in timesteps) the light started retreating,
+   * so that it only goes into avoidance behavior for a fixed amount of time.
    */
-  std::clock_t get_start_time() { return start_; }
+  uint64_t get_start_time() { return start_; }
 
-  void set_start_time(std::clock_t time) { start_ = time; }
+  void set_start_time(uint64_t time) { start_ = time; }
 
   /**
    * @brief getter for the direction the light is moving; whether
@@ -105,7 +115,7 @@ class Light : public ArenaMobileEntity {
   MotionHandler motion_handler_;
   MotionBehaviorDifferential motion_behavior_;
   bool retreating_{false};
-  std::clock_t start_ = std::clock();
+  uint64_t start_{0};
 };
 
 NAMESPACE_END(csci3081);
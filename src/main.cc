@@ -8,19 +8,31 @@
  * Includes
  ******************************************************************************/
 #include <iostream>
+#include <string>
 
 #include "src/arena_params.h"
 #include "src/controller.h"
 #include "src/graphics_arena_viewer.h"
+#include "src/tracer.h"
 
 /*******************************************************************************
  * Non-Member Functions
  ******************************************************************************/
-int main(__unused int argc, __unused char **argv) {
+int main(int argc, char **argv) {
+  // --trace FILE records a Chrome trace of the session to FILE.
+  if (argc == 3 && std::string(argv[1]) == "--trace") {
+    if (!csci3081::Tracer::Start(argv[2])) {
+      std::cerr << "cannot write " << argv[2] << std::endl;
+      return 1;
+    }
+    csci3081::Tracer::SetThreadName("main");
+  }
+
   // The controller creates both the arena and viewer
   auto *controller = new csci3081::Controller;
 
   // The controller will call Run of the viewer
   controller->Run();
+  csci3081::Tracer::Stop();
   return 0;
 }
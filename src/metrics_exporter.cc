@@ -0,0 +1,302 @@
+/**
+ * @file metrics_exporter.cc
+ *
+ * @copyright 2018 3081 Staff, All rights reserved.
+ */
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+#include "src/metrics_exporter.h"
+#include "src/robot.h"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+NAMESPACE_BEGIN(csci3081);
+
+/*******************************************************************************
+ * Constants
+ ******************************************************************************/
+const std::chrono::milliseconds MetricsExporter::kSamplePeriod(100);
+
+// Rates are measured over at least this long.
+static const std::chrono::seconds kRateWindow(1);
+
+// How long the server waits between checks for Stop(), and for a client to
+// send its request.
+static const int kPollMillis = 100;
+
+/*******************************************************************************
+ * Non-Member Functions
+ ******************************************************************************/
+static void AppendMetric(const char *name, const char *type, const char *help,
+                         double value, std::string *out) {
+  char line[256];
+  snprintf(line, sizeof(line), "# HELP %s %s\n# TYPE %s %s\n%s %.15g\n",
+           name, help, name, type, name, value);
+  *out += line;
+}
+
+static void AppendLabeled(const char *name, const char *label, double value,
+                          std::string *out) {
+  char line[256];
+  snprintf(line, sizeof(line), "%s{%s} %.15g\n", name, label, value);
+  *out += line;
+}
+
+/* The resident set of this process, from /proc. 0 where there is none. */
+static uint64_t ResidentBytes() {
+  std::ifstream statm("/proc/self/statm");
+  uint64_t size = 0, resident = 0;
+  if (!(statm >> size >> resident)) {
+    return 0;
+  }
+  return resident * static_cast<uint64_t>(sysconf(_SC_PAGESIZE));
+}
+
+void CaptureMetrics(const Arena &arena, arena_metrics *metrics) {
+  step_stats stats = arena.GetStepStats();
+  metrics->n_steps = stats.n_steps;
+  metrics->steps_per_second = stats.steps_per_second;
+  metrics->step_p50 = stats.step_p50_ms / 1000.0;
+  metrics->step_p99 = stats.step_p99_ms / 1000.0;
+  metrics->step_p999 = stats.step_p999_ms / 1000.0;
+  metrics->step_mean = arena.get_step_histogram().get_mean();
+  metrics->n_robots = 0;
+  metrics->n_lights = 0;
+  metrics->n_foods = 0;
+  for (auto &ent : arena.get_entities()) {
+    switch (ent->get_type()) {
+      case (kRobot):
+        ++metrics->n_robots;
+        break;
+      case (kLight):
+        ++metrics->n_lights;
+        break;
+      case (kFood):
+        ++metrics->n_foods;
+        break;
+      default:
+        break;
+    }
+  }
+  metrics->n_hungry = 0;
+  metrics->n_starved = 0;
+  metrics->n_meals = 0;
+  for (auto &robot : arena.get_robots()) {
+    metrics->n_hungry += robot->is_hungry() ? 1 : 0;
+    metrics->n_starved += robot->is_starved() ? 1 : 0;
+    metrics->n_meals += static_cast<uint64_t>(robot->get_food_count());
+  }
+  metrics->n_collisions = arena.get_n_collisions();
+} /* CaptureMetrics() */
+
+std::string FormatMetrics(const arena_metrics &metrics) {
+  std::string out;
+  AppendMetric("arena_steps_total", "counter",
+               "Timesteps taken since the arena was built.",
+               static_cast<double>(metrics.n_steps), &out);
+  AppendMetric("arena_steps_per_second", "gauge",
+               "Recent timesteps per wall-clock second.",
+               metrics.steps_per_second, &out);
+  out += "# HELP arena_step_seconds Wall-clock time of one timestep.\n"
+         "# TYPE arena_step_seconds summary\n";
+  AppendLabeled("arena_step_seconds", "quantile=\"0.5\"", metrics.step_p50,
+                &out);
+  AppendLabeled("arena_step_seconds", "quantile=\"0.99\"", metrics.step_p99,
+                &out);
+  AppendLabeled("arena_step_seconds", "quantile=\"0.999\"", metrics.step_p999,
+                &out);
+  char line[128];
+  snprintf(line, sizeof(line), "arena_step_seconds_sum %.15g\n"
+           "arena_step_seconds_count %llu\n",
+           metrics.step_mean * static_cast<double>(metrics.n_steps),
+           static_cast<unsigned long long>(metrics.n_steps));
+  out += line;
+  out += "# HELP arena_entities Entities in the arena, by type.\n"
+         "# TYPE arena_entities gauge\n";
+  AppendLabeled("arena_entities", "type=\"robot\"",
+                static_cast<double>(metrics.n_robots), &out);
+  AppendLabeled("arena_entities", "type=\"light\"",
+                static_cast<double>(metrics.n_lights), &out);
+  AppendLabeled("arena_entities", "type=\"food\"",
+                static_cast<double>(metrics.n_foods), &out);
+  AppendMetric("arena_robots_hungry", "gauge", "Robots that are hungry.",
+               metrics.n_hungry, &out);
+  AppendMetric("arena_robots_starved", "gauge", "Robots that have starved.",
+               metrics.n_starved, &out);
+  AppendMetric("arena_collisions_total", "counter",
+               "Entity-entity collisions, once per entity that reacts.",
+               static_cast<double>(metrics.n_collisions), &out);
+  AppendMetric("arena_collisions_per_second", "gauge",
+               "Recent entity-entity collisions per wall-clock second.",
+               metrics.collisions_per_second, &out);
+  AppendMetric("arena_meals_total", "counter",
+               "Robot-food collisions (meals).",
+               static_cast<double>(metrics.n_meals), &out);
+  AppendMetric("arena_meals_per_second", "gauge",
+               "Recent meals per wall-clock second.",
+               metrics.meals_per_second, &out);
+  AppendMetric("process_resident_memory_bytes", "gauge",
+               "Resident memory size in bytes.",
+               static_cast<double>(metrics.resident_bytes), &out);
+  return out;
+} /* FormatMetrics() */
+
+/*******************************************************************************
+ * Constructors/Destructor
+ ******************************************************************************/
+MetricsExporter::MetricsExporter(const std::string &socket_path)
+    : socket_path_(socket_path) {}
+
+MetricsExporter::~MetricsExporter() { Stop(); }
+
+/*******************************************************************************
+ * Member Functions
+ ******************************************************************************/
+bool MetricsExporter::Start() {
+  if (listen_fd_ >= 0) {
+    return true;
+  }
+  sockaddr_un address;
+  memset(&address, 0, sizeof(address));
+  address.sun_family = AF_UNIX;
+  if (socket_path_.empty() ||
+      socket_path_.size() >= sizeof(address.sun_path)) {
+    error_ = "bad socket path '" + socket_path_ + "'";
+    return false;
+  }
+  memcpy(address.sun_path, socket_path_.c_str(), socket_path_.size());
+
+  int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+  if (fd < 0) {
+    error_ = std::string("socket: ") + strerror(errno);
+    return false;
+  }
+  unlink(socket_path_.c_str());
+  if (bind(fd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) < 0 ||
+      listen(fd, 8) < 0) {
+    error_ = socket_path_ + ": " + strerror(errno);
+    close(fd);
+    return false;
+  }
+  listen_fd_ = fd;
+  stop_ = false;
+  server_ = std::thread(&MetricsExporter::ServeLoop, this);
+  return true;
+} /* Start() */
+
+void MetricsExporter::Stop() {
+  if (listen_fd_ < 0) {
+    return;
+  }
+  stop_ = true;
+  server_.join();
+  close(listen_fd_);
+  listen_fd_ = -1;
+  unlink(socket_path_.c_str());
+}
+
+void MetricsExporter::Sample(const Arena &arena) {
+  if (std::chrono::steady_clock::now() - last_sample_ < kSamplePeriod) {
+    return;
+  }
+  ForceSample(arena);
+}
+
+void MetricsExporter::ForceSample(const Arena &arena) {
+  auto now = std::chrono::steady_clock::now();
+  last_sample_ = now;
+  arena_metrics *metrics = samples_.get_back();
+  CaptureMetrics(arena, metrics);
+
+  // The totals drop when the Arena is reset; start a new window then.
+  if (metrics->n_collisions < rate_collisions_ ||
+      metrics->n_meals < rate_meals_ ||
+      rate_start_ == std::chrono::steady_clock::time_point()) {
+    rate_start_ = now;
+    rate_collisions_ = metrics->n_collisions;
+    rate_meals_ = metrics->n_meals;
+  }
+  // The rates carry over from sample to sample until a window closes.
+  double window = std::chrono::duration<double>(now - rate_start_).count();
+  if (now - rate_start_ >= kRateWindow) {
+    collisions_per_second_ = (metrics->n_collisions - rate_collisions_) /
+                             window;
+    meals_per_second_ = (metrics->n_meals - rate_meals_) / window;
+    rate_start_ = now;
+    rate_collisions_ = metrics->n_collisions;
+    rate_meals_ = metrics->n_meals;
+  }
+  metrics->collisions_per_second = collisions_per_second_;
+  metrics->meals_per_second = meals_per_second_;
+
+  samples_.Publish();
+} /* ForceSample() */
+
+void MetricsExporter::ServeLoop() {
+  pollfd listener = {listen_fd_, POLLIN, 0};
+  while (!stop_) {
+    if (poll(&listener, 1, kPollMillis) <= 0) {
+      continue;
+    }
+    int client = accept4(listen_fd_, nullptr, nullptr, SOCK_CLOEXEC);
+    if (client < 0) {
+      continue;
+    }
+    Serve(client);
+    ++n_requests_;
+    close(client);
+  }
+} /* ServeLoop() */
+
+void MetricsExporter::Serve(int client) {
+  // A client that stops reading only holds up the server, and not for long.
+  timeval timeout = {1, 0};
+  setsockopt(client, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+
+  // Give the client a moment to send a request; HTTP clients get HTTP.
+  char request[1024];
+  ssize_t n_read = 0;
+  pollfd readable = {client, POLLIN, 0};
+  if (poll(&readable, 1, kPollMillis) > 0) {
+    n_read = recv(client, request, sizeof(request), 0);
+  }
+  bool http = n_read >= 4 && memcmp(request, "GET ", 4) == 0;
+
+  samples_.Acquire();
+  arena_metrics metrics = *samples_.get_front();
+  metrics.resident_bytes = ResidentBytes();
+  std::string body = FormatMetrics(metrics);
+  std::string response;
+  if (http) {
+    response = "HTTP/1.0 200 OK\r\n"
+               "Content-Type: text/plain; version=0.0.4\r\n"
+               "Content-Length: " + std::to_string(body.size()) + "\r\n"
+               "Connection: close\r\n\r\n";
+  }
+  response += body;
+  size_t sent = 0;
+  while (sent < response.size()) {
+    ssize_t n = send(client, response.data() + sent, response.size() - sent,
+                     MSG_NOSIGNAL);
+    if (n <= 0) {
+      return;
+    }
+    sent += static_cast<size_t>(n);
+  }
+} /* Serve() */
+
+NAMESPACE_END(csci3081);
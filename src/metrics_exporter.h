@@ -0,0 +1,148 @@
+/**
+ * @file metrics_exporter.h
+ *
+ * @copyright 2018 3081 Staff, All rights reserved.
+ */
+
+#ifndef SRC_METRICS_EXPORTER_H_
+#define SRC_METRICS_EXPORTER_H_
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <thread>
+
+#include "src/arena.h"
+#include "src/common.h"
+#include "src/triple_buffer.h"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+NAMESPACE_BEGIN(csci3081);
+
+/*******************************************************************************
+ * Structure Definitions
+ ******************************************************************************/
+/**
+ * @brief The state of an Arena that the exporter reports, as of one sample.
+ */
+struct arena_metrics {
+  uint64_t n_steps{0};
+  double steps_per_second{0.0};
+  // Step latency, in seconds.
+  double step_p50{0.0};
+  double step_p99{0.0};
+  double step_p999{0.0};
+  double step_mean{0.0};
+  size_t n_robots{0};
+  size_t n_lights{0};
+  size_t n_foods{0};
+  int n_hungry{0};
+  int n_starved{0};
+  // Totals since the Arena was built or reset, and their recent rates.
+  uint64_t n_collisions{0};
+  uint64_t n_meals{0};
+  double collisions_per_second{0.0};
+  double meals_per_second{0.0};
+  // Filled in by the exporter thread when it serves a request.
+  uint64_t resident_bytes{0};
+};
+
+/*******************************************************************************
+ * Class Definitions
+ ******************************************************************************/
+/**
+ * @brief Serves an Arena's metrics in the Prometheus text format on a Unix
+ * domain socket, from a thread of its own.
+ *
+ * The thread that steps the Arena calls Sample() after its steps; at most
+ * every kSamplePeriod that copies the metrics into a TripleBuffer and
+ * publishes them. Serving a request only reads the newest published sample,
+ * so a slow or stuck client never blocks the simulation.
+ *
+ * Requests may be plain HTTP (curl --unix-socket PATH http://localhost/) or
+ * nothing at all (nc -U PATH), which gets the bare metrics.
+ */
+class MetricsExporter {
+ public:
+  static const std::chrono::milliseconds kSamplePeriod;
+
+  explicit MetricsExporter(const std::string &socket_path);
+  ~MetricsExporter();
+
+  MetricsExporter(const MetricsExporter &other) = delete;
+  MetricsExporter &operator=(const MetricsExporter &other) = delete;
+
+  /**
+   * @brief Bind the socket, replacing a stale one, and start serving.
+   *
+   * @return false (see get_error()) if the socket cannot be bound.
+   */
+  bool Start();
+
+  /**
+   * @brief Stop serving and remove the socket.
+   */
+  void Stop();
+
+  /**
+   * @brief Publish the metrics of `arena`, if kSamplePeriod has passed
+   * since the last sample. Only the thread that steps `arena` may call it.
+   */
+  void Sample(const Arena &arena);
+
+  /**
+   * @brief Publish the metrics of `arena` now.
+   */
+  void ForceSample(const Arena &arena);
+
+  const std::string &get_error() const { return error_; }
+  uint64_t get_n_requests() const { return n_requests_; }
+
+ private:
+  void ServeLoop();
+  void Serve(int client);
+
+  std::string socket_path_;
+  std::string error_{};
+  int listen_fd_{-1};
+  std::thread server_{};
+  std::atomic<bool> stop_{false};
+  std::atomic<uint64_t> n_requests_{0};
+
+  // The sampler writes, the server reads.
+  TripleBuffer<arena_metrics> samples_{};
+
+  // Sampler state: when it last sampled, and the totals the rates are
+  // measured from.
+  std::chrono::steady_clock::time_point last_sample_{};
+  std::chrono::steady_clock::time_point rate_start_{};
+  uint64_t rate_collisions_{0};
+  uint64_t rate_meals_{0};
+  double collisions_per_second_{0.0};
+  double meals_per_second_{0.0};
+};
+
+/*******************************************************************************
+ * Non-Member Functions
+ ******************************************************************************/
+/**
+ * @brief Copy the metrics of `arena` into `metrics`. The rates are left
+ * alone.
+ */
+void CaptureMetrics(const Arena &arena, arena_metrics *metrics);
+
+/**
+ * @brief `metrics` in the Prometheus text exposition format.
+ */
+std::string FormatMetrics(const arena_metrics &metrics);
+
+NAMESPACE_END(csci3081);
+
+#endif  // SRC_METRICS_EXPORTER_H_
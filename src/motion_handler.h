@@ -11,6 +11,7 @@
  * Includes
  ******************************************************************************/
 #include "src/common.h"
+#include "src/entity_state.h"
 #include "src/params.h"
 #include "src/wheel_velocity.h"
 #include "src/sensor_touch.h"
@@ -134,6 +135,26 @@ class MotionHandler {
 
   ArenaMobileEntity * get_entity() { return entity_; }
 
+  /**
+   * @brief Copy the velocity and its limits into `state`.
+   */
+  void SaveState(entity_state *state) const {
+    state->velocity_left = velocity_.left;
+    state->velocity_right = velocity_.right;
+    state->max_speed = max_speed_;
+    state->max_angle = max_angle_;
+    state->speed_delta = speed_delta_;
+    state->angle_delta = angle_delta_;
+  }
+
+  void LoadState(const entity_state &state) {
+    velocity_ = WheelVelocity(state.velocity_left, state.velocity_right);
+    max_speed_ = state.max_speed;
+    max_angle_ = state.max_angle;
+    speed_delta_ = state.speed_delta;
+    angle_delta_ = state.angle_delta;
+  }
+
   double clamp_vel(double vel);
 
  private:
@@ -0,0 +1,128 @@
+/**
+ * @file object_pool.cc
+ *
+ * @copyright 2018 3081 Staff, All rights reserved.
+ */
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <algorithm>
+#include <new>
+
+#include "src/object_pool.h"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+NAMESPACE_BEGIN(csci3081);
+
+/*******************************************************************************
+ * Non-Member Functions
+ ******************************************************************************/
+// The registry of pools. Pools are function-local statics of the classes
+// that use them, so the registry must be too, to exist before the first one.
+static std::mutex &RegistryMutex() {
+  static std::mutex mutex;
+  return mutex;
+}
+
+static std::vector<const ObjectPool *> &Registry() {
+  static std::vector<const ObjectPool *> pools;
+  return pools;
+}
+
+std::vector<pool_stats> GetPoolStats() {
+  std::lock_guard<std::mutex> lock(RegistryMutex());
+  std::vector<pool_stats> stats;
+  for (auto pool : Registry()) {
+    stats.push_back(pool->get_stats());
+  }
+  return stats;
+}
+
+/*******************************************************************************
+ * Constructors/Destructor
+ ******************************************************************************/
+ObjectPool::ObjectPool(const std::string &name, size_t object_size,
+                       size_t slab_objects)
+    : name_(name),
+      object_size_(object_size),
+      slot_size_(0),
+      slab_objects_(std::max<size_t>(slab_objects, 1)) {
+  const size_t align = alignof(std::max_align_t);
+  slot_size_ = std::max(object_size_, sizeof(FreeSlot));
+  slot_size_ = (slot_size_ + align - 1) / align * align;
+  std::lock_guard<std::mutex> lock(RegistryMutex());
+  Registry().push_back(this);
+}
+
+ObjectPool::~ObjectPool() {
+  {
+    std::lock_guard<std::mutex> lock(RegistryMutex());
+    auto &pools = Registry();
+    pools.erase(std::remove(pools.begin(), pools.end(), this), pools.end());
+  }
+  if (n_live_ == 0) {
+    for (auto slab : slabs_) {
+      ::operator delete(slab);
+    }
+  }
+}
+
+/*******************************************************************************
+ * Member Functions
+ ******************************************************************************/
+void *ObjectPool::Allocate(size_t size) {
+  if (size != object_size_) {
+    return ::operator new(size);
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (free_list_ == nullptr) {
+    AddSlab();
+  }
+  FreeSlot *slot = free_list_;
+  free_list_ = slot->next;
+  ++n_live_;
+  return slot;
+}
+
+void ObjectPool::Free(void *object, size_t size) {
+  if (object == nullptr) {
+    return;
+  }
+  if (size != object_size_) {
+    ::operator delete(object);
+    return;
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto *slot = static_cast<FreeSlot *>(object);
+  slot->next = free_list_;
+  free_list_ = slot;
+  --n_live_;
+}
+
+pool_stats ObjectPool::get_stats() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  pool_stats stats;
+  stats.name = name_;
+  stats.object_size = object_size_;
+  stats.n_live = n_live_;
+  stats.n_live_bytes = n_live_ * object_size_;
+  stats.n_reserved_bytes = slabs_.size() * slab_objects_ * slot_size_;
+  return stats;
+}
+
+void ObjectPool::AddSlab() {
+  auto *slab = static_cast<char *>(::operator new(slab_objects_ * slot_size_));
+  slabs_.push_back(slab);
+  // Thread the new slots onto the free list so they are handed out in
+  // address order.
+  for (size_t k = slab_objects_; k > 0; --k) {
+    auto *slot = reinterpret_cast<FreeSlot *>(slab + (k - 1) * slot_size_);
+    slot->next = free_list_;
+    free_list_ = slot;
+  }
+}
+
+NAMESPACE_END(csci3081);
@@ -0,0 +1,143 @@
+/**
+ * @file object_pool.h
+ *
+ * @copyright 2018 3081 Staff, All rights reserved.
+ */
+
+#ifndef SRC_OBJECT_POOL_H_
+#define SRC_OBJECT_POOL_H_
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <cstddef>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "src/common.h"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+NAMESPACE_BEGIN(csci3081);
+
+/*******************************************************************************
+ * Structure Definitions
+ ******************************************************************************/
+/**
+ * @brief Memory accounting for one ObjectPool.
+ */
+struct pool_stats {
+  std::string name{};
+  size_t object_size{0};
+  // Objects currently allocated from the pool, and their bytes.
+  size_t n_live{0};
+  size_t n_live_bytes{0};
+  // Bytes held by the pool's slabs, live or free. Slabs are kept for reuse,
+  // so this only grows when more objects are live at once than ever before.
+  size_t n_reserved_bytes{0};
+};
+
+/*******************************************************************************
+ * Class Definitions
+ ******************************************************************************/
+/**
+ * @brief A free-list allocator for objects of one size.
+ *
+ * Memory is taken from the heap in slabs of many objects and never returned
+ * while the program runs: freed objects go on a free list and are handed
+ * out again, so building and tearing down Arenas over and over reuses the
+ * same memory.
+ *
+ * A class opts in by deriving from PooledObject. Requests of a different
+ * size, such as from a subclass, go to the global heap instead. A pool may
+ * be used from several threads at once.
+ *
+ * Every pool registers itself on construction, so GetPoolStats() can report
+ * on all of them.
+ */
+class ObjectPool {
+ public:
+  /**
+   * @param[in] name The name the pool reports its stats under.
+   * @param[in] object_size The size of the objects it hands out.
+   * @param[in] slab_objects The # of objects to reserve at a time.
+   */
+  ObjectPool(const std::string &name, size_t object_size,
+             size_t slab_objects = 64);
+
+  /**
+   * @brief Releases the slabs, unless objects are still live (as can happen
+   * at program exit), in which case they are left to the operating system.
+   */
+  ~ObjectPool();
+
+  ObjectPool(const ObjectPool &other) = delete;
+  ObjectPool &operator=(const ObjectPool &other) = delete;
+
+  void *Allocate(size_t size);
+
+  /**
+   * @brief Return memory from Allocate(). `size` must be the size it was
+   * allocated with.
+   */
+  void Free(void *object, size_t size);
+
+  pool_stats get_stats() const;
+
+ private:
+  struct FreeSlot {
+    FreeSlot *next;
+  };
+
+  void AddSlab();
+
+  mutable std::mutex mutex_{};
+  std::string name_;
+  size_t object_size_;
+  // object_size_ rounded up so that every slot is suitably aligned.
+  size_t slot_size_;
+  size_t slab_objects_;
+  std::vector<char *> slabs_{};
+  FreeSlot *free_list_{nullptr};
+  size_t n_live_{0};
+};
+
+/**
+ * @brief Base for classes whose objects come from a pool shared by every
+ * Arena, so that rebuilding an Arena reuses their memory.
+ *
+ * `T` derives from PooledObject<T> and defines `static const char
+ * kPoolName[]`, the name its pool reports its stats under.
+ */
+template <class T>
+class PooledObject {
+ public:
+  static void *operator new(size_t size) { return Pool().Allocate(size); }
+  static void operator delete(void *object, size_t size) {
+    Pool().Free(object, size);
+  }
+
+ protected:
+  PooledObject() = default;
+  ~PooledObject() = default;
+
+ private:
+  static ObjectPool &Pool() {
+    static ObjectPool pool(T::kPoolName, sizeof(T));
+    return pool;
+  }
+};
+
+/*******************************************************************************
+ * Non-Member Functions
+ ******************************************************************************/
+/**
+ * @brief The stats of every pool created so far, in creation order.
+ */
+std::vector<pool_stats> GetPoolStats();
+
+NAMESPACE_END(csci3081);
+
+#endif  // SRC_OBJECT_POOL_H_
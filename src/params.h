@@ -51,6 +51,17 @@
 // advance_speed
 #define SPEED 2
 
+// simulated time
+#define TIMESTEP_SECONDS 0.05
+// the most timesteps the viewer runs per frame (see StepAccumulator)
+#define MAX_STEPS_PER_FRAME 200
+// the most commands that can wait for the Arena at once
+#define COMMAND_QUEUE_CAPACITY 256
+// the # of recent steps (and frames) the profiler averages over
+#define PROFILER_WINDOW 120
+// the viewer logs steps slower than this with their phase breakdown
+#define STEP_BUDGET_SECONDS 0.016
+
 // entity
 #define DEFAULT_POSE \
   { 200, 200, 0}
@@ -77,6 +88,12 @@
 #define ROBOT_MAX_SPEED 10
 #define ROBOT_MAX_ANGLE 360
 
+// robot timers, in simulated seconds
+#define ROBOT_RETREAT_TIME 2.0
+#define ROBOT_HUNGRY_TIME 30.0
+#define ROBOT_VERY_HUNGRY_TIME 120.0
+#define ROBOT_STARVE_TIME 150.0
+
 // food
 #define N_FOODS 5
 #define FOOD_RADIUS 20
@@ -94,6 +111,7 @@
 #define LIGHT_MAX_RADIUS 50
 #define LIGHT_COLOR \
   { 255, 255, 255 }
+#define LIGHT_RETREAT_TIME 0.2
 
 
 // sensor
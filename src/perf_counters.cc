@@ -0,0 +1,148 @@
+/**
+ * @file perf_counters.cc
+ *
+ * @copyright 2018 3081 Staff, All rights reserved.
+ */
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <cerrno>
+#include <cstring>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include "src/perf_counters.h"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+NAMESPACE_BEGIN(csci3081);
+
+/*******************************************************************************
+ * Constants
+ ******************************************************************************/
+static const char *const kEventNames[kNumPerfEvents] = {
+  "cycles", "instructions", "l1d-misses", "llc-misses", "branch-misses"
+};
+
+/*******************************************************************************
+ * Non-Member Functions
+ ******************************************************************************/
+#if defined(__linux__)
+static perf_event_attr EventAttr(PerfEvent event) {
+  perf_event_attr attr;
+  memset(&attr, 0, sizeof(attr));
+  attr.size = sizeof(attr);
+  attr.type = PERF_TYPE_HARDWARE;
+  switch (event) {
+    case (kPerfCycles):
+      attr.config = PERF_COUNT_HW_CPU_CYCLES;
+      break;
+    case (kPerfInstructions):
+      attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+      break;
+    case (kPerfL1dMisses):
+      attr.type = PERF_TYPE_HW_CACHE;
+      attr.config = PERF_COUNT_HW_CACHE_L1D |
+                    (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                    (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+      break;
+    case (kPerfLlcMisses):
+      attr.config = PERF_COUNT_HW_CACHE_MISSES;
+      break;
+    default:
+      attr.config = PERF_COUNT_HW_BRANCH_MISSES;
+      break;
+  }
+  attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED |
+                     PERF_FORMAT_TOTAL_TIME_RUNNING;
+  // Unprivileged users may only count their own user-space work.
+  attr.exclude_kernel = 1;
+  attr.exclude_hv = 1;
+  return attr;
+}
+#endif
+
+/*******************************************************************************
+ * Constructors/Destructor
+ ******************************************************************************/
+PerfCounters::PerfCounters() {
+#if defined(__linux__)
+  for (int event = 0; event < kNumPerfEvents; ++event) {
+    perf_event_attr attr = EventAttr(static_cast<PerfEvent>(event));
+    // This thread, on any CPU.
+    long fd = syscall(SYS_perf_event_open, &attr, 0, -1, leader_, 0);
+    if (fd < 0) {
+      if (error_.empty()) {
+        error_ = std::string(kEventNames[event]) + ": " + strerror(errno);
+      }
+      continue;
+    }
+    fds_[event] = static_cast<int>(fd);
+    slot_[event] = n_open_++;
+    if (leader_ < 0) {
+      leader_ = fds_[event];
+    }
+  }
+  if (leader_ >= 0) {
+    error_.clear();
+  }
+#else
+  error_ = "not supported on this platform";
+#endif
+}
+
+PerfCounters::~PerfCounters() {
+#if defined(__linux__)
+  for (int fd : fds_) {
+    if (fd >= 0) {
+      close(fd);
+    }
+  }
+#endif
+}
+
+/*******************************************************************************
+ * Member Functions
+ ******************************************************************************/
+bool PerfCounters::Read(uint64_t values[kNumPerfEvents]) const {
+  for (int event = 0; event < kNumPerfEvents; ++event) {
+    values[event] = 0;
+  }
+#if defined(__linux__)
+  if (leader_ < 0) {
+    return false;
+  }
+  // nr, time enabled, time running, then one value per open event.
+  uint64_t buffer[3 + kNumPerfEvents];
+  ssize_t n_bytes = read(leader_, buffer, sizeof(buffer));
+  if (n_bytes < static_cast<ssize_t>(3 * sizeof(uint64_t))) {
+    return false;
+  }
+  uint64_t enabled = buffer[1];
+  uint64_t running = buffer[2];
+  if (running == 0) {
+    return true;
+  }
+  double scale = static_cast<double>(enabled) / running;
+  for (int event = 0; event < kNumPerfEvents; ++event) {
+    if (slot_[event] >= 0) {
+      values[event] = static_cast<uint64_t>(buffer[3 + slot_[event]] * scale);
+    }
+  }
+  return true;
+#else
+  return false;
+#endif
+} /* Read() */
+
+const char *PerfCounters::EventName(PerfEvent event) {
+  return kEventNames[event];
+}
+
+NAMESPACE_END(csci3081);
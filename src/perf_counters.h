@@ -0,0 +1,99 @@
+/**
+ * @file perf_counters.h
+ *
+ * @copyright 2018 3081 Staff, All rights reserved.
+ */
+
+#ifndef SRC_PERF_COUNTERS_H_
+#define SRC_PERF_COUNTERS_H_
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <cstdint>
+#include <string>
+
+#include "src/common.h"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+NAMESPACE_BEGIN(csci3081);
+
+/*******************************************************************************
+ * Type Definitions
+ ******************************************************************************/
+/**
+ * @brief The hardware events PerfCounters counts.
+ */
+enum PerfEvent {
+  kPerfCycles,
+  kPerfInstructions,
+  kPerfL1dMisses,     // L1 data cache read misses.
+  kPerfLlcMisses,     // Last-level cache misses.
+  kPerfBranchMisses,
+  kNumPerfEvents
+};
+
+/*******************************************************************************
+ * Class Definitions
+ ******************************************************************************/
+/**
+ * @brief Linux hardware performance counters for the thread that creates
+ * it, read through perf_event_open(2).
+ *
+ * The events are opened as one group, so they are counted over the same
+ * intervals and read with a single system call. Events the CPU, kernel or
+ * container do not allow are left out; if none can be opened, the counters
+ * are unavailable and Read() returns false. Only user-space work is counted.
+ *
+ * Counts cover the creating thread only: work handed to a ThreadPool's
+ * workers does not show up.
+ */
+class PerfCounters {
+ public:
+  PerfCounters();
+  ~PerfCounters();
+
+  PerfCounters(const PerfCounters &other) = delete;
+  PerfCounters &operator=(const PerfCounters &other) = delete;
+
+  bool is_available() const { return leader_ >= 0; }
+
+  /**
+   * @brief Whether `event` is being counted.
+   */
+  bool is_counted(PerfEvent event) const { return slot_[event] >= 0; }
+
+  /**
+   * @brief Why no event could be opened, if so.
+   */
+  const std::string &get_error() const { return error_; }
+
+  /**
+   * @brief Read the running totals into `values`, one per PerfEvent. Events
+   * that are not counted read 0. If the kernel had to multiplex the group
+   * with other users, the totals are scaled up to the whole time enabled.
+   *
+   * @return false if the counters are unavailable or could not be read.
+   */
+  bool Read(uint64_t values[kNumPerfEvents]) const;
+
+  /**
+   * @brief The name of an event, for reports.
+   */
+  static const char *EventName(PerfEvent event);
+
+ private:
+  // The group leader's file descriptor, or -1.
+  int leader_{-1};
+  int fds_[kNumPerfEvents]{-1, -1, -1, -1, -1};
+  // Each event's position in the group's read format, or -1.
+  int slot_[kNumPerfEvents]{-1, -1, -1, -1, -1};
+  int n_open_{0};
+  std::string error_{};
+};
+
+NAMESPACE_END(csci3081);
+
+#endif  // SRC_PERF_COUNTERS_H_
@@ -0,0 +1,69 @@
+/**
+ * @file rng.h
+ *
+ * @copyright 2018 3081 Staff, All rights reserved.
+ */
+
+#ifndef SRC_RNG_H_
+#define SRC_RNG_H_
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <cstdint>
+
+#include "src/common.h"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+NAMESPACE_BEGIN(csci3081);
+
+/*******************************************************************************
+ * Class Definitions
+ ******************************************************************************/
+/**
+ * @brief The random number generator of one Arena (SplitMix64).
+ *
+ * Every random placement and size in an Arena is drawn from its own Rng
+ * instead of from the process-wide random(), so Arenas stepped on different
+ * threads do not disturb each other and a given seed always builds the same
+ * world. The whole state is one integer, which makes it cheap to save and
+ * restore.
+ */
+class Rng {
+ public:
+  explicit Rng(uint64_t seed = 0) : state_(seed) {}
+
+  /**
+   * @brief Restart the sequence from `seed`.
+   */
+  void Seed(uint64_t seed) { state_ = seed; }
+
+  /**
+   * @brief The next 64 random bits.
+   */
+  uint64_t Next() {
+    uint64_t z = (state_ += 0x9e3779b97f4a7c15ULL);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+  }
+
+  /**
+   * @brief A random integer in [0, n). `n` must be positive.
+   */
+  int UniformInt(int n) {
+    return static_cast<int>(Next() % static_cast<uint64_t>(n));
+  }
+
+  uint64_t get_state() const { return state_; }
+  void set_state(uint64_t state) { state_ = state; }
+
+ private:
+  uint64_t state_;
+};
+
+NAMESPACE_END(csci3081);
+
+#endif  // SRC_RNG_H_
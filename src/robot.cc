@@ -7,9 +7,10 @@
 /*******************************************************************************
  * Includes
  ******************************************************************************/
-#include <ctime>
 #include <cmath>
 
+#include "src/sim_clock.h"
+
 #include "src/robot.h"
 #include "src/params.h"
 
@@ -18,6 +19,11 @@
  ******************************************************************************/
 NAMESPACE_BEGIN(csci3081);
 
+/*******************************************************************************
+ * Constants
+ ******************************************************************************/
+const char Robot::kPoolName[] = "Robot";
+
 /*******************************************************************************
  * Constructors/Destructor
  ******************************************************************************/
@@ -25,6 +31,7 @@ Robot::Robot() :
     sensors_(),
     motion_handler_(this),
     motion_behavior_(this) {
+  sensors_.reserve(4);
   sensors_.push_back(new Sensor(LEFT, kLight));
   sensors_.push_back(new Sensor(RIGHT, kLight));
   sensors_.push_back(new Sensor(LEFT, kFood));
@@ -32,14 +39,21 @@ Robot::Robot() :
   for (auto &sensor : sensors_) {
     sensor->set_pose(sensor->CalcPose(ROBOT_INIT_POS, ROBOT_RADIUS));
   }
-  set_collision_time(std::clock());
-  set_food_time(std::clock());
+  set_collision_time(get_sim_time());
+  set_food_time(get_sim_time());
   set_type(kRobot);
   set_color(ROBOT_COLOR);
   set_pose(ROBOT_INIT_POS);
   set_radius(ROBOT_RADIUS);
   motion_handler_.Advance();
 }
+
+Robot::~Robot() {
+  for (auto &sensor : sensors_) {
+    delete sensor;
+  }
+}
+
 /*******************************************************************************
  * Member Functions
  ******************************************************************************/
@@ -60,24 +74,22 @@ void Robot::TimestepUpdate(unsigned int dt) {
 
   if (get_march_direction() == true) {
     motion_handler_.Retreat();
-    std::clock_t collision_end = std::clock();
-    double collision_elapsed_time = static_cast<double>
-      (collision_end - get_collision_time()) / CLOCKS_PER_SEC;
-    if (collision_elapsed_time >= 2) {
+    uint64_t collision_elapsed = get_sim_time() - get_collision_time();
+    if (collision_elapsed >= SimClock::ToTicks(ROBOT_RETREAT_TIME)) {
       set_march_direction(false);
       motion_handler_.Advance();
     }
   }
 
   if (food_exists_) {
-  std::clock_t food_end = std::clock();
-  double food_elapsed_time = static_cast<double>
-    (food_end - get_food_time()) / CLOCKS_PER_SEC;
-  if (food_elapsed_time >= 30 && food_elapsed_time < 120) {
+  uint64_t food_elapsed = get_sim_time() - get_food_time();
+  if (food_elapsed >= SimClock::ToTicks(ROBOT_HUNGRY_TIME) &&
+      food_elapsed < SimClock::ToTicks(ROBOT_VERY_HUNGRY_TIME)) {
     set_hunger(1);
-  } else if (food_elapsed_time >= 120 && food_elapsed_time < 150) {
+  } else if (food_elapsed >= SimClock::ToTicks(ROBOT_VERY_HUNGRY_TIME) &&
+             food_elapsed < SimClock::ToTicks(ROBOT_STARVE_TIME)) {
     set_hunger(2);
-  } else if (food_elapsed_time >= 150) {
+  } else if (food_elapsed >= SimClock::ToTicks(ROBOT_STARVE_TIME)) {
     has_starved(true);
   }
   int max_impulse_l = 0;
@@ -141,36 +153,67 @@ void Robot::TimestepUpdate(unsigned int dt) {
 } /* TimestepUpdate() */
 
 void Robot::Reset() {
-  set_collision_time(std::clock());
-  set_food_time(std::clock());
+  set_collision_time(get_sim_time());
+  set_food_time(get_sim_time());
   set_color(ROBOT_COLOR);
   set_pose(SetPoseRandomly());
-  thread_local unsigned int seed = time(NULL);
-  set_radius(ROBOT_RADIUS+(rand_r(&seed) % ROBOT_RADIUS));
+  set_radius(ROBOT_RADIUS + RandomInt(ROBOT_RADIUS));
   motion_handler_.set_max_speed(ROBOT_MAX_SPEED);
   motion_handler_.set_max_angle(ROBOT_MAX_ANGLE);
   sensor_touch_->Reset();
   motion_handler_.Advance();
+  set_march_direction(false);
+  set_hunger(0);
   has_starved(false);
+  food_count_ = 0;
   for (auto &sensor : sensors_) {
     sensor->set_pose(sensor->CalcPose(get_pose(), get_radius()));
+    sensor->set_impulse(0.0);
   }
 } /* Reset() */
 
+void Robot::SaveState(entity_state *state) const {
+  ArenaMobileEntity::SaveState(state);
+  motion_handler_.SaveState(state);
+  state->timer = collision_start_;
+  state->food_timer = food_start_;
+  state->hunger = hunger_;
+  state->food_count = food_count_;
+  state->f_behavior = f_behavior_;
+  state->l_behavior = l_behavior_;
+  state->retreating = retreating_;
+  state->starved = starved_;
+  state->food_exists = food_exists_;
+}
+
+void Robot::LoadState(const entity_state &state) {
+  ArenaMobileEntity::LoadState(state);
+  motion_handler_.LoadState(state);
+  collision_start_ = state.timer;
+  food_start_ = state.food_timer;
+  hunger_ = state.hunger;
+  food_count_ = state.food_count;
+  f_behavior_ = state.f_behavior;
+  l_behavior_ = state.l_behavior;
+  retreating_ = state.retreating != 0;
+  starved_ = state.starved != 0;
+  food_exists_ = state.food_exists != 0;
+}
+
 void Robot::HandleCollision(EntityType object_type, ArenaEntity * object) {
   if (object_type == kFood) {
+    ++food_count_;
     set_hunger(0);
-    set_food_time(std::clock());
+    set_food_time(get_sim_time());
   } else {
     sensor_touch_->HandleCollision(object_type, object);
     set_march_direction(true);
-    set_collision_time(std::clock());
+    set_collision_time(get_sim_time());
   }
 }
 
 Pose Robot::SetPoseRandomly() {
-  return {static_cast<double>((30 + (random() % 19) * 50)),
-      static_cast<double>((30 + (random() % 14) * 50))};
+  return RandomGridPose();
 }
 
 NAMESPACE_END(csci3081);
@@ -10,8 +10,9 @@
 /*******************************************************************************
  * Includes
  ******************************************************************************/
+#include <cstddef>
+#include <cstdint>
 #include <string>
-#include <ctime>
 #include <vector>
 
 #include "src/arena_mobile_entity.h"
@@ -19,6 +20,7 @@
 #include "src/motion_handler.h"
 #include "src/motion_behavior_differential.h"
 #include "src/entity_type.h"
+#include "src/object_pool.h"
 #include "src/sensor.h"
 
 /*******************************************************************************
@@ -51,7 +53,7 @@ class LightSensor;
  * The heading is modified after a collision to move the robot away from the
  * other object.
  */
-class Robot : public ArenaMobileEntity {
+class Robot : public ArenaMobileEntity, public PooledObject<Robot> {
  public:
   /**
    * @brief Constructor using initialization values from params.h.
@@ -62,12 +64,26 @@ class Robot : public ArenaMobileEntity {
   Robot(const Robot& other) = delete;
   Robot& operator=(const Robot& other) = delete;
 
+  /**
+   * @brief Robot's destructor. A Robot owns its sensors.
+   */
+  ~Robot() override;
+
+  static const char kPoolName[];
+
   /**
    * @brief Reset the Robot to a newly constructed state (needed for reset
    * button to work in GUI).
    */
   void Reset() override;
 
+  /**
+   * @brief The Robot's timers, hunger, behaviors and motion, on top of the
+   * base state. Its sensors are saved by the Arena.
+   */
+  void SaveState(entity_state *state) const override;
+  void LoadState(const entity_state &state) override;
+
   /**
    * @brief Update the Robot's position and velocity after the specified
    * duration has passed.
@@ -100,13 +116,20 @@ class Robot : public ArenaMobileEntity {
 
   void set_f_behavior(int behavior) { f_behavior_ = behavior; }
 
-  std::clock_t get_collision_time() { return collision_start_; }
+  /**
+   * @brief The simulated time (in timesteps) of the last collision, which
+   * started the current retreat.
+   */
+  uint64_t get_collision_time() { return collision_start_; }
 
-  std::clock_t get_food_time() { return food_start_; }
+  /**
+   * @brief The simulated time (in timesteps) the robot last ate.
+   */
+  uint64_t get_food_time() { return food_start_; }
 
-  void set_collision_time(std::clock_t time) { collision_start_ = time; }
+  void set_collision_time(uint64_t time) { collision_start_ = time; }
 
-  void set_food_time(std::clock_t time) { food_start_ = time; }
+  void set_food_time(uint64_t time) { food_start_ = time; }
 
   bool get_march_direction() { return retreating_; }
 
@@ -124,9 +147,15 @@ class Robot : public ArenaMobileEntity {
 
   bool is_starved() const { return starved_; }
 
+  /**
+   * @brief The # of times the robot has eaten since it was created or last
+   * reset.
+   */
+  int get_food_count() const { return food_count_; }
+
   bool food_exists_{true};
 
-  std::vector<Sensor *> get_sensors() { return sensors_; }
+  const std::vector<Sensor *> &get_sensors() const { return sensors_; }
 
  private:
   int hunger_{0};
@@ -135,13 +164,14 @@ class Robot : public ArenaMobileEntity {
   MotionHandler motion_handler_;
   // Calculates changes in pose foodd on elapsed time and wheel velocities.
   MotionBehaviorDifferential motion_behavior_;
-  // Start time (for retreating)
-  std::clock_t collision_start_ = std::clock();
-  std::clock_t food_start_ = std::clock();
+  // Start times, in simulated timesteps (for retreating and hunger)
+  uint64_t collision_start_{0};
+  uint64_t food_start_{0};
   int f_behavior_{AGGRESSION};
   int l_behavior_{FEAR};
   bool retreating_{false};
   bool starved_{false};
+  int food_count_{0};
 };
 
 NAMESPACE_END(csci3081);
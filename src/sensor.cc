@@ -18,6 +18,11 @@
  ******************************************************************************/
 NAMESPACE_BEGIN(csci3081);
 
+/*******************************************************************************
+ * Constants
+ ******************************************************************************/
+const char Sensor::kPoolName[] = "Sensor";
+
 /*******************************************************************************
  * Constructors/Destructor
  ******************************************************************************/
@@ -33,7 +38,7 @@ Sensor::Sensor(int side, EntityType type):
 /*******************************************************************************
  * Member Functions
  ******************************************************************************/
-void Sensor::ReceiveInfo(std::vector<ArenaEntity*> entities) {
+void Sensor::ReceiveInfo(const std::vector<ArenaEntity*> &entities) {
   double impulse = 0.0;
   for (auto &ent : entities) {
     if (ent->get_type() == get_receiver_type()) {
@@ -48,6 +53,37 @@ void Sensor::ReceiveInfo(std::vector<ArenaEntity*> entities) {
   set_impulse(impulse);
 }
 
+void Sensor::ReceiveInfo(const EntityStore &store) {
+  EntityRange range = store.range(get_receiver_type());
+  const double *x = store.x();
+  const double *y = store.y();
+  const double *intensity = store.intensity();
+  double impulse = 0.0;
+  for (size_t i = range.begin; i < range.end; ++i) {
+    impulse += (intensity[i]
+    / (std::pow(1.08,
+          Distance(get_pose().x, get_pose().y, x[i], y[i]))));
+  }
+  set_impulse(impulse);
+}
+
+void Sensor::ReceiveInfo(const EntityStore &store, const EmitterGrid &grid,
+                         double cutoff) {
+  const double *x = store.x();
+  const double *y = store.y();
+  const double *intensity = store.intensity();
+  double sensor_x = get_pose().x;
+  double sensor_y = get_pose().y;
+  double impulse = 0.0;
+  grid.ForEachWithin(sensor_x, sensor_y, cutoff, [&](size_t i) {
+      double distance = Distance(sensor_x, sensor_y, x[i], y[i]);
+      if (distance <= cutoff) {
+        impulse += intensity[i] / std::pow(1.08, distance);
+      }
+    });
+  set_impulse(impulse);
+}
+
 double Sensor::Distance(double x1, double y1, double x2, double y2) {
   return std::sqrt(std::pow(x2 - x1, 2.0) + std::pow(y2 - y1, 2.0));
 }
@@ -11,14 +11,18 @@
  * Includes
  ******************************************************************************/
 #include <algorithm>
+#include <cstddef>
 #include <vector>
 
 #include "src/entity_type.h"
 #include "src/common.h"
+#include "src/object_pool.h"
 #include "src/params.h"
 #include "src/pose.h"
 #include "src/rgb_color.h"
 #include "src/arena_entity.h"
+#include "src/emitter_grid.h"
+#include "src/entity_store.h"
 
 /*******************************************************************************
  * Namespaces
@@ -32,7 +36,7 @@ NAMESPACE_BEGIN(csci3081);
  * @brief Sensors are essentially mobile entities but without touch sensors.
  *
  */
-class Sensor {
+class Sensor : public PooledObject<Sensor> {
  public:
   /**
    * @brief Sensor's constructor.
@@ -42,9 +46,27 @@ class Sensor {
 
   virtual ~Sensor() = default;
 
+  static const char kPoolName[];
+
   virtual void Reset() {}
 
-  void ReceiveInfo(std::vector<ArenaEntity*> entities);
+  void ReceiveInfo(const std::vector<ArenaEntity*> &entities);
+
+  /**
+   * @brief Sum the impulse from the entities of the receiver type, reading
+   * only that type's range of the store's arrays.
+   *
+   * Gives the same result as ReceiveInfo() on the equivalent entities.
+   */
+  void ReceiveInfo(const EntityStore &store);
+
+  /**
+   * @brief Sum the impulse from the emitters within `cutoff` of the sensor,
+   * found through `grid` (built over the receiver type's range of `store`).
+   * Emitters further away are ignored.
+   */
+  void ReceiveInfo(const EntityStore &store, const EmitterGrid &grid,
+                   double cutoff);
 
   Pose CalcPose(Pose pose, int radius);
 
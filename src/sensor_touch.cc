@@ -16,6 +16,11 @@
  ******************************************************************************/
 NAMESPACE_BEGIN(csci3081);
 
+/*******************************************************************************
+ * Constants
+ ******************************************************************************/
+const char SensorTouch::kPoolName[] = "SensorTouch";
+
 /*******************************************************************************
  * Member Functions
  ******************************************************************************/
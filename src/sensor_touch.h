@@ -10,11 +10,13 @@
 /*******************************************************************************
  * Includes
  ******************************************************************************/
+#include <cstddef>
 #include <utility>
 #include <vector>
 #include <iostream>
 
 #include "src/common.h"
+#include "src/object_pool.h"
 #include "src/pose.h"
 #include "src/entity_type.h"
 #include "src/arena_entity.h"
@@ -37,13 +39,15 @@ NAMESPACE_BEGIN(csci3081);
  *
  * SensorTouch can be observed for collision events.
  */
-class SensorTouch {
+class SensorTouch : public PooledObject<SensorTouch> {
  public:
   /**
    * @brief Constructor.
    */
   SensorTouch() : point_of_contact_(0, 0) {}
 
+  static const char kPoolName[];
+
   /**
    * @brief Getter method for the point of contact.
    *
@@ -64,6 +68,7 @@ class SensorTouch {
    * @brief Getter for output, which is true when collision occurs.
    */
   bool get_output() const { return output_; }
+  void set_output(bool output) { output_ = output; }
 
   /**
    * @brief Modify heading to presumably move away from collision.
@@ -0,0 +1,83 @@
+/**
+ * @file sim_clock.h
+ *
+ * @copyright 2018 3081 Staff, All rights reserved.
+ */
+
+#ifndef SRC_SIM_CLOCK_H_
+#define SRC_SIM_CLOCK_H_
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <cmath>
+#include <cstdint>
+
+#include "src/common.h"
+#include "src/params.h"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+NAMESPACE_BEGIN(csci3081);
+
+/*******************************************************************************
+ * Class Definitions
+ ******************************************************************************/
+/**
+ * @brief The simulated time of an Arena, counted in timesteps.
+ *
+ * Every timestep stands for TIMESTEP_SECONDS of simulated time, no matter how
+ * long it took to compute. Timers in the entities (retreating, hunger) are
+ * measured against this clock, so a run behaves the same whether it is
+ * stepped in real time by the viewer or as fast as possible by arenasim.
+ */
+class SimClock {
+ public:
+  SimClock() = default;
+
+  /**
+   * @brief Move the clock forward.
+   *
+   * @param[in] steps The # of timesteps that have elapsed.
+   */
+  void Advance(unsigned int steps = 1) { ticks_ += steps; }
+
+  /**
+   * @brief Set the clock back to the start of the simulation.
+   */
+  void Reset() { ticks_ = 0; }
+
+  /**
+   * @brief The # of timesteps since the start of the simulation.
+   */
+  uint64_t get_ticks() const { return ticks_; }
+
+  void set_ticks(uint64_t ticks) { ticks_ = ticks; }
+
+  /**
+   * @brief The simulated time since the start of the simulation.
+   */
+  double get_seconds() const { return ToSeconds(ticks_); }
+
+  /**
+   * @brief Convert a simulated duration to the nearest # of timesteps.
+   */
+  static uint64_t ToTicks(double seconds) {
+    return static_cast<uint64_t>(std::llround(seconds / TIMESTEP_SECONDS));
+  }
+
+  /**
+   * @brief Convert a # of timesteps to a simulated duration.
+   */
+  static double ToSeconds(uint64_t ticks) {
+    return static_cast<double>(ticks) * TIMESTEP_SECONDS;
+  }
+
+ private:
+  uint64_t ticks_{0};
+};
+
+NAMESPACE_END(csci3081);
+
+#endif  // SRC_SIM_CLOCK_H_
@@ -0,0 +1,109 @@
+/**
+ * @file sim_thread.cc
+ *
+ * @copyright 2018 3081 Staff, All rights reserved.
+ */
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <chrono>
+
+#include "src/sim_thread.h"
+#include "src/tracer.h"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+NAMESPACE_BEGIN(csci3081);
+
+/*******************************************************************************
+ * Constants
+ ******************************************************************************/
+// How long the thread sleeps between batches of steps, unless running at
+// StepAccumulator::kMaxTimeScale.
+static const std::chrono::milliseconds kWakePeriod(2);
+
+/*******************************************************************************
+ * Constructors/Destructor
+ ******************************************************************************/
+SimulationThread::SimulationThread(Arena *arena, SnapshotBuffer *snapshots)
+    : arena_(arena), snapshots_(snapshots) {}
+
+SimulationThread::~SimulationThread() { Stop(); }
+
+/*******************************************************************************
+ * Member Functions
+ ******************************************************************************/
+void SimulationThread::Start() {
+  if (thread_.joinable()) {
+    return;
+  }
+  stop_ = false;
+  thread_ = std::thread(&SimulationThread::Loop, this);
+}
+
+void SimulationThread::Stop() {
+  stop_ = true;
+  if (thread_.joinable()) {
+    thread_.join();
+  }
+}
+
+void SimulationThread::SetTimeScale(double scale) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  accumulator_.set_time_scale(scale);
+}
+
+Arena *SimulationThread::ReplaceArena(Arena *arena) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  Arena *old = arena_;
+  arena_ = arena;
+  accumulator_.Reset();
+  changed_ = true;
+  return old;
+}
+
+double SimulationThread::WallSeconds() {
+  return std::chrono::duration<double>(
+    std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void SimulationThread::Loop() {
+  Tracer::SetThreadName("simulation");
+  double last_wake = WallSeconds();
+  while (!stop_) {
+    bool flat_out = false;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      double now = WallSeconds();
+      if (arena_->ApplyCommands() > 0) {
+        changed_ = true;
+      }
+      if (running_ && arena_->get_game_status() == PLAYING) {
+        ScopedTrace trace("step batch", "simulation");
+        if (arena_->StepN(accumulator_.AddFrame(now - last_wake)) > 0) {
+          changed_ = true;
+        }
+        flat_out =
+          !(accumulator_.get_time_scale() > StepAccumulator::kMaxTimeScale);
+      } else {
+        accumulator_.Reset();
+      }
+      last_wake = now;
+      if (changed_) {
+        ScopedTrace trace("snapshot", "simulation");
+        CaptureSnapshot(*arena_, WallSeconds(), snapshots_->get_back());
+        snapshots_->Publish();
+        changed_ = false;
+      }
+    }
+    if (flat_out) {
+      std::this_thread::yield();
+    } else {
+      std::this_thread::sleep_for(kWakePeriod);
+    }
+  }
+} /* Loop() */
+
+NAMESPACE_END(csci3081);
@@ -0,0 +1,122 @@
+/**
+ * @file sim_thread.h
+ *
+ * @copyright 2018 3081 Staff, All rights reserved.
+ */
+
+#ifndef SRC_SIM_THREAD_H_
+#define SRC_SIM_THREAD_H_
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <atomic>
+#include <mutex>
+#include <thread>
+
+#include "src/arena.h"
+#include "src/arena_snapshot.h"
+#include "src/common.h"
+#include "src/step_accumulator.h"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+NAMESPACE_BEGIN(csci3081);
+
+/*******************************************************************************
+ * Class Definitions
+ ******************************************************************************/
+/**
+ * @brief Steps an Arena on a thread of its own, so that the viewer's frame
+ * rate and the simulation's step rate do not hold each other back.
+ *
+ * While running, the thread wakes every couple of milliseconds and steps
+ * the Arena as many timesteps as the wall-clock time since its last wake-up
+ * is worth at the current time scale (see StepAccumulator). After any
+ * change it publishes a snapshot for the viewer to draw.
+ *
+ * Commands posted to the Arena (Arena::PostCommand()) are applied each time
+ * the thread wakes, so they take effect even while paused. Anything else
+ * that touches the Arena goes through EditArena() or ReplaceArena(), which
+ * wait for the current batch of steps to finish.
+ */
+class SimulationThread {
+ public:
+  /**
+   * @param[in] arena The Arena to step. It stays owned by the caller.
+   * @param[in] snapshots Where to publish snapshots.
+   */
+  SimulationThread(Arena *arena, SnapshotBuffer *snapshots);
+
+  /**
+   * @brief Stops the thread, if it was started.
+   */
+  ~SimulationThread();
+
+  SimulationThread(const SimulationThread &other) = delete;
+  SimulationThread &operator=(const SimulationThread &other) = delete;
+
+  /**
+   * @brief Start the thread. It publishes a first snapshot right away, but
+   * does not step until set_running(true).
+   */
+  void Start();
+
+  /**
+   * @brief Stop the thread and wait for it to finish.
+   */
+  void Stop();
+
+  /**
+   * @brief Step (true) or hold (false) the Arena, i.e. play and pause.
+   */
+  void set_running(bool running) { running_ = running; }
+  bool is_running() const { return running_; }
+
+  /**
+   * @brief See StepAccumulator::set_time_scale().
+   */
+  void SetTimeScale(double scale);
+
+  /**
+   * @brief Run `edit(arena)` between two batches of steps, and publish the
+   * result.
+   */
+  template <typename Edit>
+  void EditArena(Edit edit) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    edit(arena_);
+    changed_ = true;
+  }
+
+  /**
+   * @brief Step `arena` from now on instead.
+   *
+   * @return The Arena that was being stepped, for the caller to delete.
+   */
+  Arena *ReplaceArena(Arena *arena);
+
+  /**
+   * @brief The clock that snapshots are stamped with, in seconds.
+   */
+  static double WallSeconds();
+
+ private:
+  void Loop();
+
+  Arena *arena_;
+  SnapshotBuffer *snapshots_;
+  StepAccumulator accumulator_{};
+  // Guards arena_, accumulator_ and changed_.
+  std::mutex mutex_{};
+  // Whether there is anything new to publish.
+  bool changed_{true};
+  std::atomic<bool> running_{false};
+  std::atomic<bool> stop_{false};
+  std::thread thread_{};
+};
+
+NAMESPACE_END(csci3081);
+
+#endif  // SRC_SIM_THREAD_H_
@@ -0,0 +1,117 @@
+/**
+ * @file spsc_queue.h
+ *
+ * @copyright 2018 3081 Staff, All rights reserved.
+ */
+
+#ifndef SRC_SPSC_QUEUE_H_
+#define SRC_SPSC_QUEUE_H_
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+#include "src/common.h"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+NAMESPACE_BEGIN(csci3081);
+
+/*******************************************************************************
+ * Class Definitions
+ ******************************************************************************/
+/**
+ * @brief A bounded queue for one producer thread and one consumer thread
+ * that never locks or blocks.
+ *
+ * The items live in a ring buffer. The producer only writes the tail index
+ * and the consumer only writes the head index, each with release ordering,
+ * so an item is fully written before the other side can see it. When the
+ * queue is full TryPush() fails instead of waiting.
+ *
+ * Pushing and popping do not allocate; the ring is allocated once, up
+ * front.
+ */
+template <typename T>
+class SpscQueue {
+ public:
+  /**
+   * @param[in] capacity The most items the queue can hold. Rounded up to a
+   * power of two.
+   */
+  explicit SpscQueue(size_t capacity) : slots_(), mask_(0) {
+    size_t size = 2;
+    while (size < capacity) {
+      size *= 2;
+    }
+    slots_.resize(size);
+    mask_ = size - 1;
+  }
+
+  SpscQueue(const SpscQueue &other) = delete;
+  SpscQueue &operator=(const SpscQueue &other) = delete;
+
+  /**
+   * @brief Add an item. Producer only.
+   *
+   * @return false, without adding it, if the queue is full.
+   */
+  bool TryPush(const T &item) {
+    size_t tail = tail_.load(std::memory_order_relaxed);
+    if (tail - head_.load(std::memory_order_acquire) > mask_) {
+      return false;
+    }
+    slots_[tail & mask_] = item;
+    tail_.store(tail + 1, std::memory_order_release);
+    return true;
+  }
+
+  /**
+   * @brief Take the oldest item. Consumer only.
+   *
+   * @return false if the queue is empty.
+   */
+  bool TryPop(T *item) {
+    size_t head = head_.load(std::memory_order_relaxed);
+    if (head == tail_.load(std::memory_order_acquire)) {
+      return false;
+    }
+    *item = slots_[head & mask_];
+    head_.store(head + 1, std::memory_order_release);
+    return true;
+  }
+
+  /**
+   * @brief Whether there is anything to pop. Exact for the consumer; the
+   * producer may see a stale answer.
+   */
+  bool empty() const {
+    return head_.load(std::memory_order_acquire) ==
+        tail_.load(std::memory_order_acquire);
+  }
+
+  size_t get_capacity() const { return mask_ + 1; }
+
+ private:
+  // Keeps the indices written by different threads on different cache
+  // lines.
+  static const size_t kCacheLine = 64;
+
+  std::vector<T> slots_;
+  size_t mask_;
+  char pad0_[kCacheLine]{};
+  // The next item to pop. Written by the consumer.
+  std::atomic<size_t> head_{0};
+  char pad1_[kCacheLine]{};
+  // The next slot to push into. Written by the producer.
+  std::atomic<size_t> tail_{0};
+  char pad2_[kCacheLine]{};
+};
+
+NAMESPACE_END(csci3081);
+
+#endif  // SRC_SPSC_QUEUE_H_
@@ -0,0 +1,120 @@
+/**
+ * @file step_accumulator.h
+ *
+ * @copyright 2018 3081 Staff, All rights reserved.
+ */
+
+#ifndef SRC_STEP_ACCUMULATOR_H_
+#define SRC_STEP_ACCUMULATOR_H_
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+#include "src/common.h"
+#include "src/params.h"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+NAMESPACE_BEGIN(csci3081);
+
+/*******************************************************************************
+ * Class Definitions
+ ******************************************************************************/
+/**
+ * @brief Turns the wall-clock time between frames into a whole # of fixed
+ * timesteps to run.
+ *
+ * Each frame adds its duration, times the time scale, to a backlog of
+ * simulated time, and every whole TIMESTEP_SECONDS in the backlog becomes a
+ * step. The fraction left over carries into the next frame, so the simulated
+ * speed does not depend on the frame rate.
+ *
+ * At most `max_steps` steps are run per frame. A backlog beyond that is
+ * worked off over the following frames, but only up to one frame's budget:
+ * the rest is dropped (and counted), so that a long stall cannot leave the
+ * simulation chasing the clock for ever.
+ *
+ * A time scale of kMaxTimeScale runs the whole budget on every frame.
+ */
+class StepAccumulator {
+ public:
+  /**
+   * @brief The time scale that runs as many steps as the budget allows.
+   */
+  static constexpr double kMaxTimeScale = 0.0;
+
+  /**
+   * @param[in] max_steps The most steps to run in one frame.
+   */
+  explicit StepAccumulator(unsigned int max_steps = MAX_STEPS_PER_FRAME)
+      : max_steps_(std::max(max_steps, 1u)) {}
+
+  /**
+   * @brief Account for a frame of `frame_seconds` of wall-clock time.
+   *
+   * @return The # of timesteps to run for it.
+   */
+  unsigned int AddFrame(double frame_seconds) {
+    if (!(frame_seconds > 0)) {
+      return 0;
+    }
+    if (!(time_scale_ > kMaxTimeScale)) {
+      backlog_ = 0.0;
+      return max_steps_;
+    }
+    backlog_ += frame_seconds * time_scale_;
+    // The tolerance keeps e.g. 0.1 / 0.05 from rounding down to 1.
+    double owed = std::floor(backlog_ / TIMESTEP_SECONDS + 1e-9);
+    unsigned int steps = static_cast<unsigned int>(
+      std::min(owed, static_cast<double>(max_steps_)));
+    backlog_ = std::max(backlog_ - steps * TIMESTEP_SECONDS, 0.0);
+    if (owed - steps > max_steps_) {
+      dropped_steps_ += static_cast<uint64_t>(owed) - steps - max_steps_;
+      backlog_ = max_steps_ * TIMESTEP_SECONDS;
+    }
+    return steps;
+  }
+
+  /**
+   * @brief Forget the backlog, e.g. when the simulation is paused or
+   * rebuilt.
+   */
+  void Reset() { backlog_ = 0.0; }
+
+  /**
+   * @brief Simulated seconds per wall-clock second, or kMaxTimeScale.
+   * Negative values are treated as kMaxTimeScale.
+   */
+  void set_time_scale(double scale) {
+    time_scale_ = (scale > kMaxTimeScale) ? scale : kMaxTimeScale;
+    backlog_ = 0.0;
+  }
+  double get_time_scale() const { return time_scale_; }
+
+  unsigned int get_max_steps() const { return max_steps_; }
+
+  /**
+   * @brief The simulated time owed but not yet run, in seconds.
+   */
+  double get_backlog() const { return backlog_; }
+
+  /**
+   * @brief The # of steps given up because the budget could not keep up.
+   */
+  uint64_t get_dropped_steps() const { return dropped_steps_; }
+
+ private:
+  unsigned int max_steps_;
+  double time_scale_{1.0};
+  double backlog_{0.0};
+  uint64_t dropped_steps_{0};
+};
+
+NAMESPACE_END(csci3081);
+
+#endif  // SRC_STEP_ACCUMULATOR_H_
@@ -0,0 +1,195 @@
+/**
+ * @file step_profiler.cc
+ *
+ * @copyright 2018 3081 Staff, All rights reserved.
+ */
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <algorithm>
+#include <iostream>
+
+#include "src/step_profiler.h"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+NAMESPACE_BEGIN(csci3081);
+
+/*******************************************************************************
+ * Constants
+ ******************************************************************************/
+static const char *const kPhaseNames[kNumStepPhases] = {
+  "commands", "behavior", "starvation", "timestep", "sensing", "collisions"
+};
+// The watchdog logs at most one over-budget step per this many seconds.
+static const double kReportInterval = 1.0;
+
+const size_t RollingWindow::kCapacity;
+
+/*******************************************************************************
+ * Member Functions
+ ******************************************************************************/
+void RollingWindow::Add(double value) {
+  values_[next_] = value;
+  next_ = (next_ + 1) % kCapacity;
+  n_ = (n_ < kCapacity) ? n_ + 1 : kCapacity;
+}
+
+double RollingWindow::get_mean() const {
+  if (n_ == 0) {
+    return 0.0;
+  }
+  double sum = 0.0;
+  for (size_t i = 0; i < n_; ++i) {
+    sum += values_[i];
+  }
+  return sum / n_;
+}
+
+double RollingWindow::get_max() const {
+  if (n_ == 0) {
+    return 0.0;
+  }
+  return *std::max_element(values_, values_ + n_);
+}
+
+double RollingWindow::get_oldest() const {
+  if (n_ == 0) {
+    return 0.0;
+  }
+  return values_[(next_ + kCapacity - n_) % kCapacity];
+}
+
+double RollingWindow::get_newest() const {
+  if (n_ == 0) {
+    return 0.0;
+  }
+  return values_[(next_ + kCapacity - 1) % kCapacity];
+}
+
+void StepProfiler::EndStep(double seconds, double end_seconds) {
+  for (int phase = 0; phase < kNumStepPhases; ++phase) {
+    phases_[phase].Add(current_[phase]);
+  }
+  steps_.Add(seconds);
+  step_ends_.Add(end_seconds);
+  histogram_.Record(seconds);
+  ++n_steps_;
+  if (counting_) {
+    ++n_counted_steps_;
+  }
+  if (budget_ > 0 && seconds > budget_) {
+    ReportOverBudget(seconds, end_seconds);
+  }
+  for (int phase = 0; phase < kNumStepPhases; ++phase) {
+    current_[phase] = 0.0;
+  }
+}
+
+void StepProfiler::ReportOverBudget(double seconds, double end_seconds) {
+  ++n_over_budget_;
+  ++n_unreported_;
+  if (n_over_budget_ > 1 && end_seconds - last_report_ < kReportInterval) {
+    return;
+  }
+  std::cerr << "step " << n_steps_ << " took " << seconds * 1000.0
+            << " ms, over the " << budget_ * 1000.0 << " ms budget:";
+  for (int phase = 0; phase < kNumStepPhases; ++phase) {
+    std::cerr << " " << kPhaseNames[phase] << " "
+              << current_[phase] * 1000.0;
+  }
+  std::cerr << " ms";
+  if (n_unreported_ > 1) {
+    std::cerr << " (" << n_unreported_ - 1 << " more since the last report)";
+  }
+  std::cerr << std::endl;
+  n_unreported_ = 0;
+  last_report_ = end_seconds;
+}
+
+void StepProfiler::Reset() {
+  for (int phase = 0; phase < kNumStepPhases; ++phase) {
+    phases_[phase].Clear();
+    current_[phase] = 0.0;
+  }
+  steps_.Clear();
+  step_ends_.Clear();
+  histogram_.Reset();
+  n_steps_ = 0;
+  n_over_budget_ = 0;
+  n_unreported_ = 0;
+  for (auto &counts : phase_counts_) {
+    for (auto &count : counts) {
+      count = 0;
+    }
+  }
+  n_counted_steps_ = 0;
+}
+
+bool StepProfiler::EnableCounters() {
+  if (counters_ == nullptr) {
+    counters_ = new PerfCounters();
+  }
+  counting_ = counters_->is_available();
+  return counting_;
+}
+
+void StepProfiler::CountPhase(StepPhase phase) {
+  uint64_t end[kNumPerfEvents];
+  counters_->Read(end);
+  for (int event = 0; event < kNumPerfEvents; ++event) {
+    // Scaling for multiplexing can make a reading run slightly backwards.
+    if (end[event] > phase_start_[event]) {
+      phase_counts_[phase][event] += end[event] - phase_start_[event];
+    }
+  }
+}
+
+step_counters StepProfiler::GetCounters() const {
+  step_counters counters;
+  if (counters_ == nullptr) {
+    counters.error = "not enabled";
+    return counters;
+  }
+  counters.available = counting_;
+  counters.error = counters_->get_error();
+  for (int event = 0; event < kNumPerfEvents; ++event) {
+    counters.counted[event] =
+      counters_->is_counted(static_cast<PerfEvent>(event));
+  }
+  for (int phase = 0; phase < kNumStepPhases; ++phase) {
+    for (int event = 0; event < kNumPerfEvents; ++event) {
+      counters.phase_counts[phase][event] = phase_counts_[phase][event];
+    }
+  }
+  counters.n_steps = n_counted_steps_;
+  return counters;
+}
+
+step_stats StepProfiler::GetStats() const {
+  step_stats stats;
+  for (int phase = 0; phase < kNumStepPhases; ++phase) {
+    stats.phase_mean_ms[phase] = phases_[phase].get_mean() * 1000.0;
+    stats.phase_max_ms[phase] = phases_[phase].get_max() * 1000.0;
+  }
+  stats.step_mean_ms = steps_.get_mean() * 1000.0;
+  stats.step_max_ms = steps_.get_max() * 1000.0;
+  double span = step_ends_.get_newest() - step_ends_.get_oldest();
+  if (step_ends_.get_n() > 1 && span > 0) {
+    stats.steps_per_second = (step_ends_.get_n() - 1) / span;
+  }
+  stats.n_steps = n_steps_;
+  stats.step_p50_ms = histogram_.ValueAtPercentile(50.0) * 1000.0;
+  stats.step_p99_ms = histogram_.ValueAtPercentile(99.0) * 1000.0;
+  stats.step_p999_ms = histogram_.ValueAtPercentile(99.9) * 1000.0;
+  stats.n_over_budget = n_over_budget_;
+  return stats;
+}
+
+const char *StepProfiler::PhaseName(StepPhase phase) {
+  return (phase >= 0 && phase < kNumStepPhases) ? kPhaseNames[phase] : "";
+}
+
+NAMESPACE_END(csci3081);
@@ -0,0 +1,281 @@
+/**
+ * @file step_profiler.h
+ *
+ * @copyright 2018 3081 Staff, All rights reserved.
+ */
+
+#ifndef SRC_STEP_PROFILER_H_
+#define SRC_STEP_PROFILER_H_
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "src/common.h"
+#include "src/latency_histogram.h"
+#include "src/params.h"
+#include "src/perf_counters.h"
+#include "src/tracer.h"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+NAMESPACE_BEGIN(csci3081);
+
+/*******************************************************************************
+ * Type Definitions
+ ******************************************************************************/
+/**
+ * @brief The phases of Arena::UpdateEntitiesTimestep(), in order.
+ */
+enum StepPhase {
+  kPhaseCommands,    // Applying queued commands.
+  kPhaseBehavior,    // Assigning fear/exploration to the robots.
+  kPhaseStarvation,  // Checking for starved robots.
+  kPhaseTimestep,    // Each entity's TimestepUpdate().
+  kPhaseSensing,     // Gathering emitters and summing sensor impulses.
+  kPhaseCollisions,  // Finding and resolving collisions.
+  kNumStepPhases
+};
+
+/*******************************************************************************
+ * Structure Definitions
+ ******************************************************************************/
+/**
+ * @brief The recent cost of stepping, averaged over the profiler's window.
+ */
+struct step_stats {
+  // Per phase, in milliseconds.
+  double phase_mean_ms[kNumStepPhases]{};
+  double phase_max_ms[kNumStepPhases]{};
+  // The whole step, in milliseconds.
+  double step_mean_ms{0.0};
+  double step_max_ms{0.0};
+  // Steps completed per wall-clock second, idle time included.
+  double steps_per_second{0.0};
+  // Steps profiled since the Arena was built.
+  uint64_t n_steps{0};
+  // Percentiles of every step since the Arena was built, in milliseconds.
+  double step_p50_ms{0.0};
+  double step_p99_ms{0.0};
+  double step_p999_ms{0.0};
+  // Steps that took longer than the budget (see StepProfiler::set_budget()).
+  uint64_t n_over_budget{0};
+};
+
+/**
+ * @brief Hardware event counts per phase, summed over every step since the
+ * counters were enabled (see StepProfiler::EnableCounters()).
+ */
+struct step_counters {
+  bool available{false};
+  // Why the counters are unavailable, if they are.
+  std::string error{};
+  // Which events the CPU lets us count; the others stay 0.
+  bool counted[kNumPerfEvents]{};
+  uint64_t phase_counts[kNumStepPhases][kNumPerfEvents]{};
+  uint64_t n_steps{0};
+};
+
+/*******************************************************************************
+ * Class Definitions
+ ******************************************************************************/
+/**
+ * @brief The last PROFILER_WINDOW values of a measurement, in a ring.
+ *
+ * Adding a value never allocates.
+ */
+class RollingWindow {
+ public:
+  static const size_t kCapacity = PROFILER_WINDOW;
+
+  void Add(double value);
+  void Clear() { n_ = 0; next_ = 0; }
+
+  double get_mean() const;
+  double get_max() const;
+  /**
+   * @brief The oldest value still in the window.
+   */
+  double get_oldest() const;
+  double get_newest() const;
+  size_t get_n() const { return n_; }
+
+ private:
+  double values_[kCapacity]{};
+  size_t next_{0};
+  size_t n_{0};
+};
+
+/**
+ * @brief Times the phases of each Arena step over a rolling window, and
+ * every step in a LatencyHistogram.
+ *
+ * ScopedPhaseTimer and ScopedStepTimer do the timing. A step costs a few
+ * reads of the steady clock and no allocation. Only the thread that steps
+ * the Arena may use it.
+ *
+ * A step that takes longer than the budget is logged to std::cerr with its
+ * phase breakdown, at most once per second; the steps in between are only
+ * counted.
+ *
+ * With EnableCounters(), each phase also reads the hardware performance
+ * counters at its start and end, at the cost of two system calls.
+ */
+class StepProfiler {
+ public:
+  StepProfiler() = default;
+  ~StepProfiler() { delete counters_; }
+
+  StepProfiler(const StepProfiler &other) = delete;
+  StepProfiler &operator=(const StepProfiler &other) = delete;
+
+  /**
+   * @brief Count hardware events per phase from now on. Must be called on
+   * the thread that steps, which is the only thread counted.
+   *
+   * @return false if the counters are unavailable; the profiler then goes
+   * on timing as before.
+   */
+  bool EnableCounters();
+
+  /**
+   * @brief The events counted since EnableCounters() (or Reset()).
+   */
+  step_counters GetCounters() const;
+
+  /**
+   * @brief Log the steps that take longer than `seconds`. 0, the default,
+   * turns the watchdog off.
+   */
+  void set_budget(double seconds) { budget_ = seconds; }
+  double get_budget() const { return budget_; }
+
+  /**
+   * @brief Every step since the Arena was built (or Reset()).
+   */
+  const LatencyHistogram &get_histogram() const { return histogram_; }
+
+  /**
+   * @brief Mark the start of a phase, for the counters.
+   */
+  void BeginPhase() {
+    if (counting_) {
+      counters_->Read(phase_start_);
+    }
+  }
+
+  /**
+   * @brief Add `seconds` to `phase` of the step in progress.
+   */
+  void AddPhase(StepPhase phase, double seconds) {
+    current_[phase] += seconds;
+    if (counting_) {
+      CountPhase(phase);
+    }
+  }
+
+  /**
+   * @brief Close the step in progress, which took `seconds` in all and
+   * ended at `end_seconds` on the steady clock.
+   */
+  void EndStep(double seconds, double end_seconds);
+
+  /**
+   * @brief Forget every step so far.
+   */
+  void Reset();
+
+  step_stats GetStats() const;
+
+  /**
+   * @brief The name of a phase, for reports.
+   */
+  static const char *PhaseName(StepPhase phase);
+
+ private:
+  void ReportOverBudget(double seconds, double end_seconds);
+  void CountPhase(StepPhase phase);
+
+  double current_[kNumStepPhases]{};
+  RollingWindow phases_[kNumStepPhases]{};
+  RollingWindow steps_{};
+  RollingWindow step_ends_{};
+  LatencyHistogram histogram_{};
+  uint64_t n_steps_{0};
+  double budget_{0.0};
+  uint64_t n_over_budget_{0};
+  // Over-budget steps since the last one logged, and when that was.
+  uint64_t n_unreported_{0};
+  double last_report_{0.0};
+  // Null until EnableCounters(); counting_ once they proved available.
+  PerfCounters *counters_{nullptr};
+  bool counting_{false};
+  uint64_t phase_start_[kNumPerfEvents]{};
+  uint64_t phase_counts_[kNumStepPhases][kNumPerfEvents]{};
+  uint64_t n_counted_steps_{0};
+};
+
+/**
+ * @brief Charges the time, and any counted events, from its construction to
+ * its destruction to one phase of a StepProfiler, and to the Tracer when it
+ * is on.
+ */
+class ScopedPhaseTimer {
+ public:
+  ScopedPhaseTimer(StepProfiler *profiler, StepPhase phase)
+      : profiler_(profiler), phase_(phase), start_() {
+    profiler_->BeginPhase();
+    start_ = std::chrono::steady_clock::now();
+  }
+  ~ScopedPhaseTimer() {
+    auto end = std::chrono::steady_clock::now();
+    profiler_->AddPhase(phase_,
+                        std::chrono::duration<double>(end - start_).count());
+    if (Tracer::IsEnabled()) {
+      Tracer::Complete(StepProfiler::PhaseName(phase_), "step", start_, end);
+    }
+  }
+
+  ScopedPhaseTimer(const ScopedPhaseTimer &other) = delete;
+  ScopedPhaseTimer &operator=(const ScopedPhaseTimer &other) = delete;
+
+ private:
+  StepProfiler *profiler_;
+  StepPhase phase_;
+  std::chrono::steady_clock::time_point start_;
+};
+
+/**
+ * @brief Times one whole step, and closes it in the StepProfiler when it is
+ * destroyed.
+ */
+class ScopedStepTimer {
+ public:
+  explicit ScopedStepTimer(StepProfiler *profiler)
+      : profiler_(profiler), start_(std::chrono::steady_clock::now()) {}
+  ~ScopedStepTimer() {
+    auto end = std::chrono::steady_clock::now();
+    profiler_->EndStep(
+      std::chrono::duration<double>(end - start_).count(),
+      std::chrono::duration<double>(end.time_since_epoch()).count());
+    if (Tracer::IsEnabled()) {
+      Tracer::Complete("step", "step", start_, end);
+    }
+  }
+
+  ScopedStepTimer(const ScopedStepTimer &other) = delete;
+  ScopedStepTimer &operator=(const ScopedStepTimer &other) = delete;
+
+ private:
+  StepProfiler *profiler_;
+  std::chrono::steady_clock::time_point start_;
+};
+
+NAMESPACE_END(csci3081);
+
+#endif  // SRC_STEP_PROFILER_H_
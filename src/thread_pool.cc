@@ -0,0 +1,98 @@
+/**
+ * @file thread_pool.cc
+ *
+ * @copyright 2018 3081 Staff, All rights reserved.
+ */
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <algorithm>
+
+#include "src/thread_pool.h"
+#include "src/tracer.h"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+NAMESPACE_BEGIN(csci3081);
+
+/*******************************************************************************
+ * Constructors/Destructor
+ ******************************************************************************/
+ThreadPool::ThreadPool(int n_threads)
+    : n_threads_(std::max(n_threads, 1)) {
+  // Chunk 0 always runs on the calling thread.
+  for (int chunk = 1; chunk < n_threads_; ++chunk) {
+    workers_.emplace_back(&ThreadPool::WorkerLoop, this, chunk);
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  work_ready_.notify_all();
+  for (auto &worker : workers_) {
+    worker.join();
+  }
+}
+
+/*******************************************************************************
+ * Member Functions
+ ******************************************************************************/
+void ThreadPool::Run(size_t n_items, RangeTask task) {
+  if (workers_.empty() || n_items < 2) {
+    task.invoke(task.body, 0, n_items);
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    task_ = task;
+    n_items_ = n_items;
+    pending_ = static_cast<int>(workers_.size());
+    ++generation_;
+  }
+  work_ready_.notify_all();
+  RunChunk(0);
+
+  std::unique_lock<std::mutex> lock(mutex_);
+  work_done_.wait(lock, [this] { return pending_ == 0; });
+  task_ = {nullptr, nullptr};
+} /* Run() */
+
+void ThreadPool::WorkerLoop(int chunk) {
+  Tracer::SetThreadName("pool worker");
+  uint64_t seen = 0;
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      work_ready_.wait(lock, [&] { return stop_ || generation_ != seen; });
+      if (stop_) {
+        return;
+      }
+      seen = generation_;
+    }
+    RunChunk(chunk);
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      --pending_;
+    }
+    work_done_.notify_one();
+  }
+} /* WorkerLoop() */
+
+void ThreadPool::RunChunk(int chunk) {
+  // Chunk k is [n * k / T, n * (k + 1) / T), which covers [0, n) exactly.
+  size_t n_chunks = static_cast<size_t>(n_threads_);
+  size_t k = static_cast<size_t>(chunk);
+  size_t begin = n_items_ * k / n_chunks;
+  size_t end = n_items_ * (k + 1) / n_chunks;
+  if (begin < end) {
+    ScopedTrace trace("chunk", "pool");
+    task_.invoke(task_.body, begin, end);
+  }
+}
+
+NAMESPACE_END(csci3081);
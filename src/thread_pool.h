@@ -0,0 +1,100 @@
+/**
+ * @file thread_pool.h
+ *
+ * @copyright 2018 3081 Staff, All rights reserved.
+ */
+
+#ifndef SRC_THREAD_POOL_H_
+#define SRC_THREAD_POOL_H_
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "src/common.h"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+NAMESPACE_BEGIN(csci3081);
+
+/*******************************************************************************
+ * Class Definitions
+ ******************************************************************************/
+/**
+ * @brief A fixed set of worker threads that run the phases of a timestep.
+ *
+ * The calling thread counts as one of the threads: a pool of n threads
+ * starts n - 1 workers, and a pool of 1 thread runs everything inline.
+ *
+ * ParallelFor() always cuts [0, n) into the same contiguous chunks for a
+ * given thread count, and returns only once every chunk is done. As long as
+ * the loop body for item i only writes state that belongs to item i, the
+ * result does not depend on the thread count or on scheduling.
+ *
+ * The loop body is passed by reference and never copied, so running a phase
+ * does not allocate.
+ */
+class ThreadPool {
+ public:
+  /**
+   * @param[in] n_threads The # of threads, including the caller. Values
+   * below 1 are treated as 1.
+   */
+  explicit ThreadPool(int n_threads);
+  ~ThreadPool();
+
+  ThreadPool(const ThreadPool &other) = delete;
+  ThreadPool &operator=(const ThreadPool &other) = delete;
+
+  /**
+   * @brief Run `body(begin, end)` over [0, n_items), split across the
+   * threads.
+   *
+   * Blocks until every chunk has been run. Must not be called from inside a
+   * loop body.
+   */
+  template <typename Body>
+  void ParallelFor(size_t n_items, const Body &body) {
+    Run(n_items, {&body, [](const void *b, size_t begin, size_t end) {
+        (*static_cast<const Body *>(b))(begin, end);
+      }});
+  }
+
+  int get_n_threads() const { return n_threads_; }
+
+ private:
+  // A type-erased reference to a loop body.
+  struct RangeTask {
+    const void *body;
+    void (*invoke)(const void *body, size_t begin, size_t end);
+  };
+
+  void Run(size_t n_items, RangeTask task);
+  void WorkerLoop(int chunk);
+  void RunChunk(int chunk);
+
+  int n_threads_;
+  std::vector<std::thread> workers_{};
+  std::mutex mutex_{};
+  std::condition_variable work_ready_{};
+  std::condition_variable work_done_{};
+  // The current job. Only valid while pending_ > 0.
+  RangeTask task_{nullptr, nullptr};
+  size_t n_items_{0};
+  // Bumped once per job so that workers can tell a new job from a spurious
+  // wakeup.
+  uint64_t generation_{0};
+  int pending_{0};
+  bool stop_{false};
+};
+
+NAMESPACE_END(csci3081);
+
+#endif  // SRC_THREAD_POOL_H_
@@ -0,0 +1,218 @@
+/**
+ * @file tracer.cc
+ *
+ * @copyright 2018 3081 Staff, All rights reserved.
+ */
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <condition_variable>
+#include <cstdio>
+#include <fstream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "src/tracer.h"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+NAMESPACE_BEGIN(csci3081);
+
+/*******************************************************************************
+ * Constants
+ ******************************************************************************/
+// How often the writer wakes to drain the recorded spans.
+static const std::chrono::milliseconds kWritePeriod(100);
+
+// The size of the output stream's buffer.
+static const size_t kWriteBufferBytes = 1 << 16;
+
+/*******************************************************************************
+ * Structure Definitions
+ ******************************************************************************/
+/* A recorded span, or (for 'M') the name of a thread. */
+struct trace_event {
+  char phase;
+  const char *name;
+  const char *category;
+  Tracer::Clock::time_point start;
+  Tracer::Clock::time_point end;
+  uint32_t tid;
+};
+
+/* What the Tracer knows about one thread. */
+struct trace_thread {
+  // Small ids read better in the viewers than native thread ids. 0 until the
+  // thread first records a span.
+  uint32_t id{0};
+  const char *name{nullptr};
+  // The trace the thread's name was last written to.
+  uint64_t named_in{0};
+};
+
+struct trace_state {
+  std::mutex control{};  // Serializes Start() and Stop().
+  std::mutex mutex{};    // Guards everything below.
+  std::condition_variable wake{};
+  bool running{false};
+  bool stop_writer{false};
+  // Bumped by each Start(), so every trace gets the thread names again.
+  uint64_t generation{0};
+  uint32_t n_threads{0};
+  uint64_t n_events{0};
+  std::vector<trace_event> pending{};
+  Tracer::Clock::time_point origin{};
+  std::ofstream out{};
+  std::vector<char> buffer{};
+  std::thread writer{};
+};
+
+/*******************************************************************************
+ * Global Variables
+ ******************************************************************************/
+std::atomic<bool> Tracer::enabled_{false};
+
+/*******************************************************************************
+ * Non-Member Functions
+ ******************************************************************************/
+static trace_state &State() {
+  static trace_state state;
+  return state;
+}
+
+static trace_thread &ThisThread() {
+  static thread_local trace_thread thread;
+  return thread;
+}
+
+static double Microseconds(Tracer::Clock::duration duration) {
+  return std::chrono::duration<double, std::micro>(duration).count();
+}
+
+static void WriteEvent(const trace_event &event,
+                       Tracer::Clock::time_point origin, std::ostream *out) {
+  char line[256];
+  if (event.phase == 'M') {
+    snprintf(line, sizeof(line),
+             ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,"
+             "\"tid\":%u,\"args\":{\"name\":\"%s\"}}",
+             event.tid, event.name);
+  } else {
+    snprintf(line, sizeof(line),
+             ",\n{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\",\"ts\":%.3f,"
+             "\"dur\":%.3f,\"pid\":1,\"tid\":%u}",
+             event.name, event.category, Microseconds(event.start - origin),
+             Microseconds(event.end - event.start), event.tid);
+  }
+  *out << line;
+}
+
+/* Drains the recorded spans to the file every kWritePeriod, and once more
+ * when the trace stops.
+ */
+static void WriterLoop() {
+  trace_state &state = State();
+  std::vector<trace_event> batch;
+  std::unique_lock<std::mutex> lock(state.mutex);
+  while (true) {
+    state.wake.wait_for(lock, kWritePeriod,
+                        [&state] { return state.stop_writer; });
+    bool done = state.stop_writer;
+    batch.swap(state.pending);
+    lock.unlock();
+    for (auto &event : batch) {
+      WriteEvent(event, state.origin, &state.out);
+    }
+    batch.clear();
+    lock.lock();
+    if (done) {
+      return;
+    }
+  }
+} /* WriterLoop() */
+
+/*******************************************************************************
+ * Member Functions
+ ******************************************************************************/
+bool Tracer::Start(const std::string &path) {
+  trace_state &state = State();
+  std::lock_guard<std::mutex> control(state.control);
+  if (state.running) {
+    return false;
+  }
+  state.buffer.resize(kWriteBufferBytes);
+  state.out.rdbuf()->pubsetbuf(state.buffer.data(), state.buffer.size());
+  state.out.open(path);
+  if (!state.out) {
+    state.out.clear();
+    return false;
+  }
+  // The process metadata opens the array, so every event after it can be
+  // written with a leading comma.
+  state.out << "{\"traceEvents\":[\n{\"name\":\"process_name\",\"ph\":\"M\","
+            << "\"pid\":1,\"args\":{\"name\":\"arena\"}}";
+  {
+    std::lock_guard<std::mutex> lock(state.mutex);
+    state.running = true;
+    state.stop_writer = false;
+    ++state.generation;
+    state.n_events = 0;
+    state.origin = Clock::now();
+  }
+  state.writer = std::thread(WriterLoop);
+  enabled_.store(true, std::memory_order_relaxed);
+  return true;
+} /* Start() */
+
+void Tracer::Stop() {
+  trace_state &state = State();
+  std::lock_guard<std::mutex> control(state.control);
+  if (!state.running) {
+    return;
+  }
+  enabled_.store(false, std::memory_order_relaxed);
+  {
+    std::lock_guard<std::mutex> lock(state.mutex);
+    state.running = false;
+    state.stop_writer = true;
+  }
+  state.wake.notify_all();
+  state.writer.join();
+  state.out << "\n]}\n";
+  state.out.close();
+  state.out.clear();
+} /* Stop() */
+
+void Tracer::Complete(const char *name, const char *category,
+                      Clock::time_point start, Clock::time_point end) {
+  trace_state &state = State();
+  trace_thread &thread = ThisThread();
+  std::lock_guard<std::mutex> lock(state.mutex);
+  if (!state.running) {
+    return;
+  }
+  if (thread.id == 0) {
+    thread.id = ++state.n_threads;
+  }
+  if (thread.name != nullptr && thread.named_in != state.generation) {
+    thread.named_in = state.generation;
+    state.pending.push_back({'M', thread.name, nullptr, start, start,
+                             thread.id});
+  }
+  state.pending.push_back({'X', name, category, start, end, thread.id});
+  ++state.n_events;
+} /* Complete() */
+
+void Tracer::SetThreadName(const char *name) {
+  ThisThread().name = name;
+}
+
+uint64_t Tracer::get_n_events() {
+  std::lock_guard<std::mutex> lock(State().mutex);
+  return State().n_events;
+}
+
+NAMESPACE_END(csci3081);
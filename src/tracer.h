@@ -0,0 +1,111 @@
+/**
+ * @file tracer.h
+ *
+ * @copyright 2018 3081 Staff, All rights reserved.
+ */
+
+#ifndef SRC_TRACER_H_
+#define SRC_TRACER_H_
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+#include "src/common.h"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+NAMESPACE_BEGIN(csci3081);
+
+/*******************************************************************************
+ * Class Definitions
+ ******************************************************************************/
+/**
+ * @brief Records timed spans from any thread to a Chrome trace-event JSON
+ * file, which chrome://tracing and ui.perfetto.dev can open.
+ *
+ * Tracing is off until Start(). While it is off, every hook costs one
+ * relaxed atomic load. While it is on, a span costs a mutex and a push onto
+ * a vector; a background thread formats the spans and writes them through a
+ * buffered stream, so the traced threads never touch the file.
+ *
+ * Span names and categories are not copied: they must be string literals,
+ * or otherwise outlive the trace.
+ */
+class Tracer {
+ public:
+  using Clock = std::chrono::steady_clock;
+
+  /**
+   * @brief Start writing a trace to `path`.
+   *
+   * @return false if a trace is already running or `path` cannot be opened.
+   */
+  static bool Start(const std::string &path);
+
+  /**
+   * @brief Write every span recorded so far, close the trace and the file.
+   * Does nothing if no trace is running.
+   */
+  static void Stop();
+
+  static bool IsEnabled() {
+    return enabled_.load(std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Record a span of the calling thread, from `start` to `end`.
+   */
+  static void Complete(const char *name, const char *category,
+                       Clock::time_point start, Clock::time_point end);
+
+  /**
+   * @brief Name the calling thread in the traces. The name is written
+   * before the thread's first span in each trace.
+   */
+  static void SetThreadName(const char *name);
+
+  /**
+   * @brief The # of spans recorded by the current or last trace.
+   */
+  static uint64_t get_n_events();
+
+ private:
+  static std::atomic<bool> enabled_;
+};
+
+/**
+ * @brief Records the time from its construction to its destruction as a
+ * span, if tracing was on when it was constructed.
+ */
+class ScopedTrace {
+ public:
+  ScopedTrace(const char *name, const char *category)
+      : name_(name), category_(category), start_() {
+    if (Tracer::IsEnabled()) {
+      start_ = Tracer::Clock::now();
+    }
+  }
+  ~ScopedTrace() {
+    if (start_ != Tracer::Clock::time_point()) {
+      Tracer::Complete(name_, category_, start_, Tracer::Clock::now());
+    }
+  }
+
+  ScopedTrace(const ScopedTrace &other) = delete;
+  ScopedTrace &operator=(const ScopedTrace &other) = delete;
+
+ private:
+  const char *name_;
+  const char *category_;
+  Tracer::Clock::time_point start_;
+};
+
+NAMESPACE_END(csci3081);
+
+#endif  // SRC_TRACER_H_
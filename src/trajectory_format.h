@@ -0,0 +1,134 @@
+/**
+ * @file trajectory_format.h
+ *
+ * @copyright 2018 3081 Staff, All rights reserved.
+ *
+ * The layout of a trajectory file, shared by TrajectoryRecorder and
+ * TrajectoryReader. All integers past the fixed-size header are varints
+ * (7 bits a byte, low bits first); signed ones are zigzag-encoded first.
+ *
+ *   header           trajectory_header
+ *   entity table     n_entities x (type, id)
+ *   frames           kind (1 byte), tick, payload size, payload
+ *   index            n_keyframes, then each keyframe's offset minus the
+ *                    previous one's
+ *   trailer          trajectory_trailer
+ *
+ * A frame's payload has, for each entity in table order, its x, y, theta,
+ * left and right wheel velocity, quantised by the scales below and minus
+ * the values in the frame before (in a keyframe, minus 0), then for robots
+ * its hunger flags; then the # of collisions, and each as (self type, self
+ * id, other type, other id). Every kKeyframeInterval-th frame is a
+ * keyframe, so any frame can be decoded from the keyframe before it. The
+ * index and trailer are written when recording ends; a file without them is
+ * still readable by skipping from frame to frame.
+ */
+
+#ifndef SRC_TRAJECTORY_FORMAT_H_
+#define SRC_TRAJECTORY_FORMAT_H_
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <cmath>
+#include <cstdint>
+#include <string>
+
+#include "src/common.h"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+NAMESPACE_BEGIN(csci3081);
+
+/*******************************************************************************
+ * Constants
+ ******************************************************************************/
+const char kTrajectoryMagic[8] = {'A', 'R', 'E', 'N', 'A', 'T', 'R', 'J'};
+const char kTrajectoryIndexMagic[8] = {'T', 'R', 'J', 'I', 'N', 'D', 'E', 'X'};
+const uint32_t kTrajectoryVersion = 1;
+const uint64_t kKeyframeInterval = 64;
+
+// Quanta per unit: 1/16 pixel, 1/100 degree and 1/256 pixel per timestep.
+const double kPositionScale = 16.0;
+const double kAngleScale = 100.0;
+const double kVelocityScale = 256.0;
+
+// The values recorded per entity and frame, in payload order.
+const int kTrajectoryFields = 5;
+
+// The kind byte of a frame.
+const uint8_t kDeltaFrame = 0;
+const uint8_t kKeyFrame = 1;
+
+// Robot hunger flags.
+const uint32_t kHungryFlag = 1;
+const uint32_t kStarvedFlag = 2;
+
+/*******************************************************************************
+ * Structure Definitions
+ ******************************************************************************/
+struct trajectory_header {
+  char magic[8];
+  uint32_t version;
+  uint32_t keyframe_interval;
+  uint64_t n_entities;
+};
+
+struct trajectory_trailer {
+  // Where the index starts.
+  uint64_t index_offset;
+  uint64_t n_frames;
+  char magic[8];
+};
+
+static_assert(sizeof(trajectory_header) == 24, "trajectory_header padding");
+static_assert(sizeof(trajectory_trailer) == 24, "trajectory_trailer padding");
+
+/*******************************************************************************
+ * Non-Member Functions
+ ******************************************************************************/
+inline void PutVarint(uint64_t value, std::string *out) {
+  while (value >= 0x80) {
+    out->push_back(static_cast<char>((value & 0x7f) | 0x80));
+    value >>= 7;
+  }
+  out->push_back(static_cast<char>(value));
+}
+
+/**
+ * @brief Decode a varint at `*in`, which is advanced past it.
+ *
+ * @return false if it runs past `end` or is longer than 64 bits.
+ */
+inline bool GetVarint(const uint8_t **in, const uint8_t *end,
+                      uint64_t *value) {
+  uint64_t result = 0;
+  for (int shift = 0; shift < 64 && *in < end; shift += 7) {
+    uint8_t byte = *(*in)++;
+    result |= static_cast<uint64_t>(byte & 0x7f) << shift;
+    if (!(byte & 0x80)) {
+      *value = result;
+      return true;
+    }
+  }
+  return false;
+}
+
+/* Small magnitudes of either sign become small unsigned numbers. */
+inline uint64_t ZigZag(int64_t value) {
+  return (static_cast<uint64_t>(value) << 1) ^
+         static_cast<uint64_t>(value >> 63);
+}
+
+inline int64_t UnZigZag(uint64_t value) {
+  return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+}
+
+inline int64_t Quantise(double value, double scale) {
+  return std::llround(value * scale);
+}
+
+NAMESPACE_END(csci3081);
+
+#endif  // SRC_TRAJECTORY_FORMAT_H_
@@ -0,0 +1,249 @@
+/**
+ * @file trajectory_reader.cc
+ *
+ * @copyright 2018 3081 Staff, All rights reserved.
+ */
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#include "src/trajectory_reader.h"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+NAMESPACE_BEGIN(csci3081);
+
+/*******************************************************************************
+ * Non-Member Functions
+ ******************************************************************************/
+/* Read a varint from `in`, a byte at a time. */
+static bool ReadVarint(std::istream &in, uint64_t *value) {
+  uint64_t result = 0;
+  for (int shift = 0; shift < 64; shift += 7) {
+    int byte = in.get();
+    if (byte == std::char_traits<char>::eof()) {
+      return false;
+    }
+    result |= static_cast<uint64_t>(byte & 0x7f) << shift;
+    if (!(byte & 0x80)) {
+      *value = result;
+      return true;
+    }
+  }
+  return false;
+}
+
+/*******************************************************************************
+ * Member Functions
+ ******************************************************************************/
+bool TrajectoryReader::Open(const std::string &path) {
+  in_.open(path, std::ios::binary);
+  if (!in_) {
+    error_ = path + ": " + strerror(errno);
+    return false;
+  }
+  trajectory_header header;
+  if (!in_.read(reinterpret_cast<char *>(&header), sizeof(header)) ||
+      memcmp(header.magic, kTrajectoryMagic, sizeof(header.magic)) != 0) {
+    error_ = path + ": not a trajectory file";
+    return false;
+  }
+  if (header.version != kTrajectoryVersion || header.keyframe_interval == 0) {
+    error_ = path + ": trajectory version " + std::to_string(header.version) +
+             ", expected " + std::to_string(kTrajectoryVersion);
+    return false;
+  }
+  keyframe_interval_ = header.keyframe_interval;
+
+  in_.seekg(0, std::ios::end);
+  uint64_t file_size = static_cast<uint64_t>(in_.tellg());
+  in_.seekg(sizeof(header));
+  // Each entity takes at least two bytes of the table.
+  if (header.n_entities > file_size / 2) {
+    error_ = path + ": trajectory is truncated or corrupt";
+    return false;
+  }
+  entities_.resize(header.n_entities);
+  for (auto &entity : entities_) {
+    uint64_t type, id;
+    if (!ReadVarint(in_, &type) || !ReadVarint(in_, &id)) {
+      error_ = path + ": trajectory is truncated or corrupt";
+      return false;
+    }
+    entity.type = static_cast<EntityType>(type);
+    entity.id = static_cast<int>(id);
+  }
+  frames_offset_ = static_cast<uint64_t>(in_.tellg());
+  last_.assign(entities_.size() * kTrajectoryFields, 0);
+
+  if (!ReadIndex(file_size)) {
+    ScanFrames(file_size);
+  }
+  return true;
+} /* Open() */
+
+bool TrajectoryReader::ReadIndex(uint64_t file_size) {
+  if (file_size < frames_offset_ + sizeof(trajectory_trailer)) {
+    return false;
+  }
+  uint64_t trailer_offset = file_size - sizeof(trajectory_trailer);
+  trajectory_trailer trailer;
+  in_.clear();
+  in_.seekg(static_cast<std::streamoff>(trailer_offset));
+  if (!in_.read(reinterpret_cast<char *>(&trailer), sizeof(trailer)) ||
+      memcmp(trailer.magic, kTrajectoryIndexMagic, sizeof(trailer.magic)) !=
+        0 ||
+      trailer.index_offset < frames_offset_ ||
+      trailer.index_offset > trailer_offset) {
+    return false;
+  }
+  in_.seekg(static_cast<std::streamoff>(trailer.index_offset));
+  uint64_t n_keyframes;
+  uint64_t expected =
+    (trailer.n_frames + keyframe_interval_ - 1) / keyframe_interval_;
+  if (!ReadVarint(in_, &n_keyframes) || n_keyframes != expected) {
+    return false;
+  }
+  keyframes_.resize(n_keyframes);
+  uint64_t offset = 0;
+  for (auto &keyframe : keyframes_) {
+    uint64_t delta;
+    if (!ReadVarint(in_, &delta)) {
+      keyframes_.clear();
+      return false;
+    }
+    offset += delta;
+    keyframe = offset;
+  }
+  n_frames_ = trailer.n_frames;
+  return true;
+} /* ReadIndex() */
+
+void TrajectoryReader::ScanFrames(uint64_t file_size) {
+  keyframes_.clear();
+  n_frames_ = 0;
+  recovered_ = true;
+  in_.clear();
+  in_.seekg(static_cast<std::streamoff>(frames_offset_));
+  for (;;) {
+    uint64_t offset = static_cast<uint64_t>(in_.tellg());
+    uint8_t kind;
+    uint64_t tick, size;
+    // A frame cut short by the end of the file is dropped, as is anything
+    // after the last frame that is not one.
+    if (!ReadFrameHeader(&kind, &tick, &size) ||
+        size > file_size - static_cast<uint64_t>(in_.tellg()) ||
+        (kind != kKeyFrame && kind != kDeltaFrame) ||
+        (n_frames_ % keyframe_interval_ == 0) != (kind == kKeyFrame)) {
+      break;
+    }
+    if (kind == kKeyFrame) {
+      keyframes_.push_back(offset);
+    }
+    ++n_frames_;
+    in_.seekg(static_cast<std::streamoff>(size), std::ios::cur);
+  }
+} /* ScanFrames() */
+
+bool TrajectoryReader::ReadFrameHeader(uint8_t *kind, uint64_t *tick,
+                                       uint64_t *size) {
+  int byte = in_.get();
+  if (byte == std::char_traits<char>::eof()) {
+    return false;
+  }
+  *kind = static_cast<uint8_t>(byte);
+  return ReadVarint(in_, tick) && ReadVarint(in_, size);
+}
+
+bool TrajectoryReader::Read(uint64_t first, uint64_t count,
+                            std::vector<trajectory_frame> *frames) {
+  frames->clear();
+  if (first >= n_frames_ || count == 0) {
+    return true;
+  }
+  uint64_t end = first + std::min(count, n_frames_ - first);
+  uint64_t keyframe = first / keyframe_interval_;
+  in_.clear();
+  in_.seekg(static_cast<std::streamoff>(keyframes_[keyframe]));
+  frames->reserve(end - first);
+  trajectory_frame skipped;
+  for (uint64_t index = keyframe * keyframe_interval_; index < end;
+       ++index) {
+    uint8_t kind;
+    uint64_t size;
+    trajectory_frame *frame = &skipped;
+    if (index >= first) {
+      frames->emplace_back();
+      frame = &frames->back();
+    }
+    if (!ReadFrameHeader(&kind, &frame->tick, &size)) {
+      error_ = "trajectory is truncated";
+      return false;
+    }
+    payload_.resize(size);
+    if (!in_.read(reinterpret_cast<char *>(payload_.data()),
+                  static_cast<std::streamsize>(size)) ||
+        !DecodePayload(kind == kKeyFrame, frame)) {
+      error_ = "frame " + std::to_string(index) + " is corrupt";
+      return false;
+    }
+  }
+  return true;
+} /* Read() */
+
+bool TrajectoryReader::DecodePayload(bool key, trajectory_frame *frame) {
+  const uint8_t *in = payload_.data();
+  const uint8_t *end = in + payload_.size();
+  frame->samples.resize(entities_.size());
+  int64_t *last = last_.data();
+  uint64_t value;
+  for (size_t i = 0; i < entities_.size(); ++i) {
+    for (int field = 0; field < kTrajectoryFields; ++field) {
+      if (!GetVarint(&in, end, &value)) {
+        return false;
+      }
+      last[field] = (key ? 0 : last[field]) + UnZigZag(value);
+    }
+    trajectory_sample &sample = frame->samples[i];
+    sample.x = static_cast<double>(last[0]) / kPositionScale;
+    sample.y = static_cast<double>(last[1]) / kPositionScale;
+    sample.theta = static_cast<double>(last[2]) / kAngleScale;
+    sample.velocity_left = static_cast<double>(last[3]) / kVelocityScale;
+    sample.velocity_right = static_cast<double>(last[4]) / kVelocityScale;
+    last += kTrajectoryFields;
+    value = 0;
+    if (entities_[i].type == kRobot && !GetVarint(&in, end, &value)) {
+      return false;
+    }
+    sample.hungry = (value & kHungryFlag) != 0;
+    sample.starved = (value & kStarvedFlag) != 0;
+  }
+
+  uint64_t n_collisions;
+  // Each collision takes at least four bytes.
+  if (!GetVarint(&in, end, &n_collisions) ||
+      n_collisions > static_cast<uint64_t>(end - in) / 4) {
+    return false;
+  }
+  frame->collisions.resize(n_collisions);
+  for (auto &collision : frame->collisions) {
+    uint64_t fields[4];
+    for (auto &field : fields) {
+      if (!GetVarint(&in, end, &field)) {
+        return false;
+      }
+    }
+    collision.self = {static_cast<EntityType>(fields[0]),
+                      static_cast<int>(fields[1])};
+    collision.other = {static_cast<EntityType>(fields[2]),
+                       static_cast<int>(fields[3])};
+  }
+  return in == end;
+} /* DecodePayload() */
+
+NAMESPACE_END(csci3081);
@@ -0,0 +1,131 @@
+/**
+ * @file trajectory_reader.h
+ *
+ * @copyright 2018 3081 Staff, All rights reserved.
+ */
+
+#ifndef SRC_TRAJECTORY_READER_H_
+#define SRC_TRAJECTORY_READER_H_
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "src/common.h"
+#include "src/entity_type.h"
+#include "src/trajectory_format.h"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+NAMESPACE_BEGIN(csci3081);
+
+/*******************************************************************************
+ * Structure Definitions
+ ******************************************************************************/
+/**
+ * @brief A recorded entity, as it is known in the Arena.
+ */
+struct trajectory_entity {
+  EntityType type;
+  int id;
+};
+
+/**
+ * @brief One entity in one frame, to the precision it was recorded with.
+ */
+struct trajectory_sample {
+  double x;
+  double y;
+  double theta;
+  double velocity_left;
+  double velocity_right;
+  // Robots only.
+  bool hungry;
+  bool starved;
+};
+
+struct trajectory_collision {
+  trajectory_entity self;
+  trajectory_entity other;
+};
+
+/**
+ * @brief The state after one step: a sample per entity, in the order of
+ * TrajectoryReader::get_entities(), and the collisions of the step.
+ */
+struct trajectory_frame {
+  uint64_t tick{0};
+  std::vector<trajectory_sample> samples{};
+  std::vector<trajectory_collision> collisions{};
+};
+
+/*******************************************************************************
+ * Class Definitions
+ ******************************************************************************/
+/**
+ * @brief Decodes a file written by TrajectoryRecorder.
+ *
+ * Opening reads the header, the entity table and the keyframe index; Read()
+ * then seeks to the keyframe at or before the first frame wanted and
+ * decodes from there, so only that part of the file is read. If recording
+ * was cut short and there is no index, Open() rebuilds it by hopping from
+ * frame header to frame header.
+ */
+class TrajectoryReader {
+ public:
+  TrajectoryReader() = default;
+
+  TrajectoryReader(const TrajectoryReader &other) = delete;
+  TrajectoryReader &operator=(const TrajectoryReader &other) = delete;
+
+  /**
+   * @return false (see get_error()) if `path` is not a trajectory file.
+   */
+  bool Open(const std::string &path);
+
+  /**
+   * @brief Decode frames [first, first + count), or up to the last one.
+   *
+   * @return false (see get_error()) if the file is corrupt.
+   */
+  bool Read(uint64_t first, uint64_t count,
+            std::vector<trajectory_frame> *frames);
+
+  const std::vector<trajectory_entity> &get_entities() const {
+    return entities_;
+  }
+  uint64_t get_n_frames() const { return n_frames_; }
+  // Whether the index was missing and had to be rebuilt.
+  bool is_recovered() const { return recovered_; }
+  const std::string &get_error() const { return error_; }
+
+ private:
+  bool ReadIndex(uint64_t file_size);
+  void ScanFrames(uint64_t file_size);
+  bool ReadFrameHeader(uint8_t *kind, uint64_t *tick, uint64_t *size);
+  bool DecodePayload(bool key, trajectory_frame *frame);
+
+  std::ifstream in_{};
+  std::string error_{};
+  uint32_t keyframe_interval_{0};
+  std::vector<trajectory_entity> entities_{};
+  // File offsets of the keyframes and of the first frame.
+  std::vector<uint64_t> keyframes_{};
+  uint64_t frames_offset_{0};
+  uint64_t n_frames_{0};
+  bool recovered_{false};
+
+  // Decoding state: the payload being read and the quantised values of the
+  // frame before it.
+  std::vector<uint8_t> payload_{};
+  std::vector<int64_t> last_{};
+};
+
+NAMESPACE_END(csci3081);
+
+#endif  // SRC_TRAJECTORY_READER_H_
@@ -0,0 +1,208 @@
+/**
+ * @file trajectory_recorder.cc
+ *
+ * @copyright 2018 3081 Staff, All rights reserved.
+ */
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <utility>
+
+#include "src/light.h"
+#include "src/robot.h"
+#include "src/tracer.h"
+#include "src/trajectory_recorder.h"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+NAMESPACE_BEGIN(csci3081);
+
+/*******************************************************************************
+ * Constants
+ ******************************************************************************/
+const size_t TrajectoryRecorder::kChunkBytes = 1 << 20;
+const size_t TrajectoryRecorder::kMaxChunks = 8;
+
+/*******************************************************************************
+ * Constructors/Destructor
+ ******************************************************************************/
+TrajectoryRecorder::TrajectoryRecorder(const std::string &path)
+    : path_(path) {}
+
+TrajectoryRecorder::~TrajectoryRecorder() { Close(); }
+
+/*******************************************************************************
+ * Member Functions
+ ******************************************************************************/
+bool TrajectoryRecorder::Open(Arena *arena) {
+  if (open_) {
+    return true;
+  }
+  out_.open(path_, std::ios::binary | std::ios::trunc);
+  if (!out_) {
+    error_ = path_ + ": " + strerror(errno);
+    return false;
+  }
+  entities_ = arena->get_mobile_entities();
+  last_.assign(entities_.size() * kTrajectoryFields, 0);
+  arena->set_record_collisions(true);
+
+  trajectory_header header;
+  memset(&header, 0, sizeof(header));
+  memcpy(header.magic, kTrajectoryMagic, sizeof(header.magic));
+  header.version = kTrajectoryVersion;
+  header.keyframe_interval = kKeyframeInterval;
+  header.n_entities = entities_.size();
+  chunk_.reserve(kChunkBytes + kChunkBytes / 4);
+  chunk_.append(reinterpret_cast<const char *>(&header), sizeof(header));
+  for (auto &ent : entities_) {
+    PutVarint(static_cast<uint64_t>(ent->get_type()), &chunk_);
+    PutVarint(static_cast<uint64_t>(ent->get_id()), &chunk_);
+  }
+
+  open_ = true;
+  writer_ = std::thread(&TrajectoryRecorder::WriterLoop, this);
+  return true;
+} /* Open() */
+
+void TrajectoryRecorder::Record(const Arena &arena) {
+  if (!open_ || !error_.empty()) {
+    return;
+  }
+  auto start = std::chrono::steady_clock::now();
+  if (arena.get_mobile_entities() != entities_) {
+    error_ = "the arena's entities changed; recording stopped";
+    return;
+  }
+  EncodeFrame(arena);
+  if (chunk_.size() >= kChunkBytes) {
+    PushChunk();
+  }
+  record_.Record(std::chrono::duration<double>(
+    std::chrono::steady_clock::now() - start).count());
+} /* Record() */
+
+void TrajectoryRecorder::EncodeFrame(const Arena &arena) {
+  bool key = n_frames_ % kKeyframeInterval == 0;
+  if (key) {
+    keyframes_.push_back(get_n_bytes());
+  }
+  payload_.clear();
+  int64_t *last = last_.data();
+  for (auto &ent : entities_) {
+    const Pose &pose = ent->get_pose();
+    bool robot = ent->get_type() == kRobot;
+    WheelVelocity velocity = robot ?
+      static_cast<Robot *>(ent)->get_motion_handler().get_velocity() :
+      static_cast<Light *>(ent)->get_motion_handler().get_velocity();
+    const int64_t values[kTrajectoryFields] = {
+      Quantise(pose.x, kPositionScale),
+      Quantise(pose.y, kPositionScale),
+      Quantise(pose.theta, kAngleScale),
+      Quantise(velocity.left, kVelocityScale),
+      Quantise(velocity.right, kVelocityScale)};
+    for (int field = 0; field < kTrajectoryFields; ++field) {
+      PutVarint(ZigZag(values[field] - (key ? 0 : last[field])), &payload_);
+      last[field] = values[field];
+    }
+    last += kTrajectoryFields;
+    if (robot) {
+      const Robot *r = static_cast<const Robot *>(ent);
+      PutVarint((r->is_hungry() ? kHungryFlag : 0) |
+                (r->is_starved() ? kStarvedFlag : 0), &payload_);
+    }
+  }
+  const std::vector<collision_event> &events = arena.get_collision_events();
+  PutVarint(events.size(), &payload_);
+  for (auto &event : events) {
+    PutVarint(static_cast<uint64_t>(event.self_type), &payload_);
+    PutVarint(static_cast<uint64_t>(event.self_id), &payload_);
+    PutVarint(static_cast<uint64_t>(event.other_type), &payload_);
+    PutVarint(static_cast<uint64_t>(event.other_id), &payload_);
+  }
+
+  chunk_.push_back(static_cast<char>(key ? kKeyFrame : kDeltaFrame));
+  PutVarint(arena.get_clock().get_ticks(), &chunk_);
+  PutVarint(payload_.size(), &chunk_);
+  chunk_ += payload_;
+  ++n_frames_;
+} /* EncodeFrame() */
+
+void TrajectoryRecorder::PushChunk() {
+  auto start = std::chrono::steady_clock::now();
+  std::unique_lock<std::mutex> lock(mutex_);
+  wake_.wait(lock, [this] {
+    return full_.size() < kMaxChunks || write_failed_;
+  });
+  stall_time_ += std::chrono::duration<double>(
+    std::chrono::steady_clock::now() - start).count();
+  offset_ += chunk_.size();
+  full_.push_back(std::move(chunk_));
+  wake_.notify_all();
+  lock.unlock();
+  chunk_ = std::string();
+  chunk_.reserve(kChunkBytes + kChunkBytes / 4);
+} /* PushChunk() */
+
+bool TrajectoryRecorder::Close() {
+  if (!open_) {
+    return error_.empty();
+  }
+  uint64_t index_offset = get_n_bytes();
+  PutVarint(keyframes_.size(), &chunk_);
+  uint64_t previous = 0;
+  for (uint64_t offset : keyframes_) {
+    PutVarint(offset - previous, &chunk_);
+    previous = offset;
+  }
+  trajectory_trailer trailer;
+  memset(&trailer, 0, sizeof(trailer));
+  trailer.index_offset = index_offset;
+  trailer.n_frames = n_frames_;
+  memcpy(trailer.magic, kTrajectoryIndexMagic, sizeof(trailer.magic));
+  chunk_.append(reinterpret_cast<const char *>(&trailer), sizeof(trailer));
+  PushChunk();
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    closing_ = true;
+  }
+  wake_.notify_all();
+  writer_.join();
+  out_.close();
+  if (write_failed_ || !out_) {
+    error_ = path_ + ": write failed";
+  }
+  open_ = false;
+  return error_.empty();
+} /* Close() */
+
+void TrajectoryRecorder::WriterLoop() {
+  Tracer::SetThreadName("trajectory writer");
+  std::unique_lock<std::mutex> lock(mutex_);
+  for (;;) {
+    wake_.wait(lock, [this] { return !full_.empty() || closing_; });
+    if (full_.empty()) {
+      return;
+    }
+    std::string chunk = std::move(full_.front());
+    full_.pop_front();
+    wake_.notify_all();
+    lock.unlock();
+    bool ok;
+    {
+      ScopedTrace trace("write trajectory", "io");
+      ok = static_cast<bool>(out_.write(chunk.data(),
+        static_cast<std::streamsize>(chunk.size())));
+    }
+    lock.lock();
+    write_failed_ = write_failed_ || !ok;
+  }
+} /* WriterLoop() */
+
+NAMESPACE_END(csci3081);
@@ -0,0 +1,123 @@
+/**
+ * @file trajectory_recorder.h
+ *
+ * @copyright 2018 3081 Staff, All rights reserved.
+ */
+
+#ifndef SRC_TRAJECTORY_RECORDER_H_
+#define SRC_TRAJECTORY_RECORDER_H_
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "src/arena.h"
+#include "src/common.h"
+#include "src/latency_histogram.h"
+#include "src/trajectory_format.h"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+NAMESPACE_BEGIN(csci3081);
+
+/*******************************************************************************
+ * Class Definitions
+ ******************************************************************************/
+/**
+ * @brief Streams the trajectories of an Arena's robots and lights to a
+ * compact binary file (see trajectory_format.h), one frame per step.
+ *
+ * The stepping thread encodes each frame into a chunk in memory; full chunks
+ * go to a background thread that writes them out. At most kMaxChunks wait
+ * for it, so a disk that cannot keep up stalls the steps (get_stall_time())
+ * rather than growing the memory without bound.
+ */
+class TrajectoryRecorder {
+ public:
+  // Chunks are handed to the writer once they are this big.
+  static const size_t kChunkBytes;
+  static const size_t kMaxChunks;
+
+  explicit TrajectoryRecorder(const std::string &path);
+  ~TrajectoryRecorder();
+
+  TrajectoryRecorder(const TrajectoryRecorder &other) = delete;
+  TrajectoryRecorder &operator=(const TrajectoryRecorder &other) = delete;
+
+  /**
+   * @brief Create the file and start recording the mobile entities of
+   * `arena`, which is set to record its collisions.
+   *
+   * @return false (see get_error()) if the file cannot be created.
+   */
+  bool Open(Arena *arena);
+
+  /**
+   * @brief Record the state of `arena` after a step. Only the thread that
+   * steps it may call this, between steps.
+   */
+  void Record(const Arena &arena);
+
+  /**
+   * @brief Write the rest of the frames and the index, and close the file.
+   *
+   * @return false (see get_error()) if anything could not be written.
+   */
+  bool Close();
+
+  const std::string &get_error() const { return error_; }
+  uint64_t get_n_frames() const { return n_frames_; }
+  // Bytes encoded so far, header included.
+  uint64_t get_n_bytes() const { return offset_ + chunk_.size(); }
+  // Seconds Record() has waited for the writer.
+  double get_stall_time() const { return stall_time_; }
+
+  /**
+   * @brief How long Record() took, waits for the writer included.
+   */
+  const LatencyHistogram &get_record_histogram() const { return record_; }
+
+ private:
+  void EncodeFrame(const Arena &arena);
+  void PushChunk();
+  void WriterLoop();
+
+  std::string path_;
+  std::string error_{};
+  bool open_{false};
+
+  // The entities recorded, and their quantised values in the last frame.
+  std::vector<ArenaMobileEntity *> entities_{};
+  std::vector<int64_t> last_{};
+  uint64_t n_frames_{0};
+  // File offsets: of the start of chunk_, and of each keyframe.
+  uint64_t offset_{0};
+  std::vector<uint64_t> keyframes_{};
+  std::string chunk_{};
+  std::string payload_{};
+  double stall_time_{0.0};
+  LatencyHistogram record_{};
+
+  // Shared with the writer.
+  std::mutex mutex_{};
+  std::condition_variable wake_{};
+  std::deque<std::string> full_{};
+  bool closing_{false};
+  bool write_failed_{false};
+  std::ofstream out_{};
+  std::thread writer_{};
+};
+
+NAMESPACE_END(csci3081);
+
+#endif  // SRC_TRAJECTORY_RECORDER_H_
@@ -0,0 +1,104 @@
+/**
+ * @file triple_buffer.h
+ *
+ * @copyright 2018 3081 Staff, All rights reserved.
+ */
+
+#ifndef SRC_TRIPLE_BUFFER_H_
+#define SRC_TRIPLE_BUFFER_H_
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <atomic>
+
+#include "src/common.h"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+NAMESPACE_BEGIN(csci3081);
+
+/*******************************************************************************
+ * Class Definitions
+ ******************************************************************************/
+/**
+ * @brief Hands the newest value of a T from one writer thread to one reader
+ * thread without either one waiting for the other.
+ *
+ * Three values rotate between the writer's back buffer, a shared middle
+ * buffer and the reader's front buffer. Publish() swaps the back buffer
+ * with the middle one, and Acquire() swaps the middle buffer with the front
+ * one if a newer value is there; both are one atomic exchange. The writer
+ * can publish as often as it likes and the reader always gets the newest
+ * complete value. Intermediate ones are simply skipped.
+ *
+ * Neither side allocates: the three values are reused, so a T that owns
+ * storage keeps it from one round to the next.
+ */
+template <typename T>
+class TripleBuffer {
+ public:
+  TripleBuffer() = default;
+
+  TripleBuffer(const TripleBuffer &other) = delete;
+  TripleBuffer &operator=(const TripleBuffer &other) = delete;
+
+  /**
+   * @brief The back buffer, to fill in before Publish(). Writer only.
+   */
+  T *get_back() { return &slots_[back_]; }
+
+  /**
+   * @brief Make the back buffer the newest value. The writer gets a
+   * different back buffer, whose contents are stale. Writer only.
+   */
+  void Publish() {
+    int old = middle_.exchange(back_ | kFresh, std::memory_order_acq_rel);
+    back_ = old & kIndexMask;
+  }
+
+  /**
+   * @brief Whether a value the reader has not taken yet was published. Once
+   * true it stays true until the reader calls Acquire(). Reader only.
+   */
+  bool is_fresh() const {
+    return (middle_.load(std::memory_order_acquire) & kFresh) != 0;
+  }
+
+  /**
+   * @brief Take the newest published value, if there is one the reader has
+   * not seen. The old front buffer goes back to the writer. Reader only.
+   *
+   * @return Whether get_front() changed.
+   */
+  bool Acquire() {
+    if (!is_fresh()) {
+      return false;
+    }
+    int old = middle_.exchange(front_, std::memory_order_acq_rel);
+    front_ = old & kIndexMask;
+    return true;
+  }
+
+  /**
+   * @brief The newest value the reader has acquired. Reader only.
+   */
+  T *get_front() { return &slots_[front_]; }
+  const T &get_front() const { return slots_[front_]; }
+
+ private:
+  // The middle buffer's index, plus kFresh when the reader has not yet
+  // taken it.
+  static const int kIndexMask = 3;
+  static const int kFresh = 4;
+
+  T slots_[3]{};
+  int back_{0};
+  std::atomic<int> middle_{1};
+  int front_{2};
+};
+
+NAMESPACE_END(csci3081);
+
+#endif  // SRC_TRIPLE_BUFFER_H_
@@ -0,0 +1,59 @@
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <gtest/gtest.h>
+#include "src/alloc_counter.h"
+#include "src/arena.h"
+#include "src/arena_params.h"
+
+#ifdef ALLOCATION_TESTS
+
+/*******************************************************************************
+ * Helpers
+ ******************************************************************************/
+/* Heap allocations made by `steps` timesteps of `arena`. */
+static uint64_t AllocationsDuring(csci3081::Arena *arena, int steps) {
+  csci3081::alloc_stats before = csci3081::GetAllocStats();
+  for (int i = 0; i < steps; i++) {
+    arena->UpdateEntitiesTimestep();
+  }
+  return csci3081::GetAllocStats().n_allocations - before.n_allocations;
+}
+
+/*******************************************************************************
+ * Test Cases
+ ******************************************************************************/
+TEST(AllocationTest, CounterSeesAllocations) {
+  ASSERT_TRUE(csci3081::AllocCountingEnabled())
+    << "FAIL: Build the tests with -DARENA_ALLOC_COUNTING";
+  csci3081::alloc_stats before = csci3081::GetAllocStats();
+  int *value = new int(3);
+  csci3081::alloc_stats after = csci3081::GetAllocStats();
+  delete value;
+  EXPECT_EQ(after.n_allocations - before.n_allocations, 1u);
+  EXPECT_GE(after.n_bytes - before.n_bytes, sizeof(int));
+}
+
+TEST(AllocationTest, SteadyStateTimestepDoesNotAllocate) {
+  for (auto type : {csci3081::kBruteForce, csci3081::kSpatialHash,
+                    csci3081::kSortAndSweep}) {
+    for (int n_threads : {1, 3}) {
+      for (double sensing_error : {0.0, 1e-3}) {
+        csci3081::arena_params params;
+        params.broad_phase = type;
+        params.n_threads = n_threads;
+        params.sensing_error = sensing_error;
+        params.n_robots = 30;
+        params.n_lights = 10;
+        csci3081::Arena arena(&params);
+        // Let the scratch buffers reach their working size.
+        AllocationsDuring(&arena, 50);
+        EXPECT_EQ(AllocationsDuring(&arena, 200), 0u)
+          << "FAIL: Timestep allocates with broad phase " << type << ", "
+          << n_threads << " threads, sensing error " << sensing_error;
+      }
+    }
+  }
+}
+
+#endif /* ALLOCATION_TESTS */
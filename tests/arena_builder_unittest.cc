@@ -0,0 +1,72 @@
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <gtest/gtest.h>
+#include <chrono>
+#include <thread>
+#include "src/arena.h"
+#include "src/arena_builder.h"
+#include "src/arena_params.h"
+
+#ifdef ARENA_BUILDER_TESTS
+
+/*******************************************************************************
+ * Non-Member Functions
+ ******************************************************************************/
+static csci3081::Arena *WaitForReady(csci3081::ArenaBuilder *builder) {
+  for (int i = 0; i < 20000; ++i) {
+    csci3081::Arena *arena = builder->TakeReady();
+    if (arena != nullptr) {
+      return arena;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  return nullptr;
+}
+
+/*******************************************************************************
+ * Test Cases
+ ******************************************************************************/
+TEST(ArenaBuilderTest, BuildsRequestedArena) {
+  csci3081::ArenaBuilder builder;
+  csci3081::arena_params params;
+  params.n_robots = 12;
+  params.n_foods = 3;
+  builder.Request(params);
+  csci3081::Arena *arena = WaitForReady(&builder);
+  ASSERT_NE(arena, nullptr) << "FAIL: Build never finished";
+  EXPECT_TRUE(arena->get_params() == params);
+  EXPECT_EQ(arena->get_robots().size(), 12u);
+  EXPECT_EQ(builder.TakeReady(), nullptr);
+  builder.Retire(arena);
+}
+
+TEST(ArenaBuilderTest, NewerRequestSupersedesBuildInFlight) {
+  csci3081::ArenaBuilder builder;
+  csci3081::arena_params big;
+  big.n_robots = 200000;
+  csci3081::arena_params small;
+  small.n_robots = 5;
+  builder.Request(big);
+  builder.Request(small);
+  csci3081::Arena *arena = WaitForReady(&builder);
+  ASSERT_NE(arena, nullptr) << "FAIL: Build never finished";
+  EXPECT_EQ(arena->get_robots().size(), 5u)
+    << "FAIL: Got the superseded Arena";
+  builder.Retire(arena);
+}
+
+TEST(ArenaBuilderTest, CancelDropsRequest) {
+  csci3081::ArenaBuilder builder;
+  csci3081::arena_params params;
+  params.n_robots = 100000;
+  builder.Request(params);
+  builder.Cancel();
+  for (int i = 0; i < 20000 && builder.is_busy(); ++i) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  EXPECT_FALSE(builder.is_busy());
+  EXPECT_EQ(builder.TakeReady(), nullptr);
+}
+
+#endif /* ARENA_BUILDER_TESTS */
@@ -0,0 +1,78 @@
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <set>
+#include "src/arena.h"
+#include "src/arena_params.h"
+#include "src/robot.h"
+
+#ifdef ARENA_CONSTRUCTION_TESTS
+
+/*******************************************************************************
+ * Test Cases
+ ******************************************************************************/
+TEST(ArenaConstructionTest, TypeListsHaveNoDuplicates) {
+  csci3081::arena_params params;
+  params.n_robots = 7;
+  params.n_lights = 4;
+  params.n_foods = 3;
+  params.seed = 11;
+  csci3081::Arena arena(&params);
+  arena.AddRobots(csci3081::kRobot, 2);
+  arena.AddEntity(csci3081::kLight, 1);
+
+  EXPECT_EQ(arena.get_entities().size(), 17u);
+  EXPECT_EQ(arena.get_robots().size(), 9u);
+  EXPECT_EQ(arena.get_mobile_entities().size(), 14u);
+  std::set<const csci3081::ArenaMobileEntity *> mobile(
+    arena.get_mobile_entities().begin(), arena.get_mobile_entities().end());
+  EXPECT_EQ(mobile.size(), arena.get_mobile_entities().size())
+    << "FAIL: Duplicate mobile entities";
+}
+
+TEST(ArenaConstructionTest, EntitiesPartitionedByType) {
+  csci3081::arena_params params;
+  params.n_robots = 5;
+  params.n_lights = 3;
+  params.n_foods = 4;
+  params.seed = 3;
+  csci3081::Arena arena(&params);
+  arena.AddEntity(csci3081::kFood, 2);
+  arena.AddRobots(csci3081::kRobot, 1);
+
+  const csci3081::EntityType order[] = {
+    csci3081::kRobot, csci3081::kLight, csci3081::kFood};
+  size_t next = 0;
+  for (auto &ent : arena.get_entities()) {
+    while (next < 3 && ent->get_type() != order[next]) {
+      ++next;
+    }
+    ASSERT_LT(next, 3u) << "FAIL: Entities out of type order";
+  }
+  EXPECT_EQ(arena.get_entities().front()->get_type(), csci3081::kRobot);
+  EXPECT_EQ(arena.get_entities().back()->get_type(), csci3081::kFood);
+}
+
+TEST(ArenaConstructionTest, PlacementCoversLargerArena) {
+  csci3081::arena_params params;
+  params.n_robots = 0;
+  params.n_lights = 0;
+  params.n_foods = 2000;
+  params.x_dim = 4096;
+  params.y_dim = 3072;
+  params.seed = 5;
+  csci3081::Arena arena(&params);
+  double max_x = 0, max_y = 0;
+  for (auto &ent : arena.get_entities()) {
+    EXPECT_LT(ent->get_pose().x, params.x_dim);
+    EXPECT_LT(ent->get_pose().y, params.y_dim);
+    max_x = std::max(max_x, ent->get_pose().x);
+    max_y = std::max(max_y, ent->get_pose().y);
+  }
+  EXPECT_GT(max_x, ARENA_X_DIM) << "FAIL: Placed as if in the default arena";
+  EXPECT_GT(max_y, ARENA_Y_DIM) << "FAIL: Placed as if in the default arena";
+}
+
+#endif /* ARENA_CONSTRUCTION_TESTS */
@@ -0,0 +1,132 @@
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <gtest/gtest.h>
+#include <chrono>
+#include <thread>
+#include "src/arena.h"
+#include "src/arena_params.h"
+#include "src/arena_snapshot.h"
+#include "src/sim_thread.h"
+
+#ifdef ARENA_SNAPSHOT_TESTS
+
+/*******************************************************************************
+ * Test Cases
+ ******************************************************************************/
+TEST(ArenaSnapshotTest, ReaderGetsNewestPublished) {
+  csci3081::SnapshotBuffer buffer;
+  EXPECT_FALSE(buffer.Acquire());
+
+  buffer.get_back()->ticks = 1;
+  buffer.Publish();
+  ASSERT_TRUE(buffer.Acquire());
+  EXPECT_EQ(buffer.get_latest().ticks, 1u);
+
+  // Frames the reader misses are skipped, not queued.
+  for (uint64_t tick : {2, 3}) {
+    buffer.get_back()->ticks = tick;
+    buffer.Publish();
+  }
+  ASSERT_TRUE(buffer.Acquire());
+  EXPECT_EQ(buffer.get_latest().ticks, 3u);
+  EXPECT_EQ(buffer.get_previous().ticks, 1u);
+  EXPECT_FALSE(buffer.Acquire());
+}
+
+TEST(ArenaSnapshotTest, ConcurrentReaderSeesWholeSnapshots) {
+  csci3081::SnapshotBuffer buffer;
+  const uint64_t n_frames = 20000;
+  std::thread writer([&buffer, n_frames] {
+      for (uint64_t tick = 1; tick <= n_frames; ++tick) {
+        csci3081::arena_snapshot *back = buffer.get_back();
+        back->ticks = tick;
+        back->entities.resize(16);
+        for (auto &entity : back->entities) {
+          entity.x = static_cast<double>(tick);
+        }
+        buffer.Publish();
+      }
+    });
+  uint64_t last = 0;
+  while (last < n_frames) {
+    if (!buffer.Acquire()) {
+      continue;
+    }
+    const csci3081::arena_snapshot &latest = buffer.get_latest();
+    ASSERT_GT(latest.ticks, last);
+    for (auto &entity : latest.entities) {
+      ASSERT_EQ(entity.x, static_cast<double>(latest.ticks))
+        << "FAIL: Read a snapshot while it was being written";
+    }
+    last = latest.ticks;
+  }
+  writer.join();
+}
+
+TEST(ArenaSnapshotTest, Interpolation) {
+  csci3081::arena_snapshot from, to, out;
+  from.ticks = 1;
+  from.wall_seconds = 10.0;
+  from.entities.resize(1);
+  from.entities[0].x = 0.0;
+  from.entities[0].theta = 350.0;
+  to = from;
+  to.ticks = 2;
+  to.wall_seconds = 10.1;
+  to.entities[0].x = 10.0;
+  to.entities[0].theta = 10.0;
+
+  EXPECT_NEAR(csci3081::SnapshotBlend(from, to, 10.15), 0.5, 1e-9);
+  EXPECT_NEAR(csci3081::SnapshotBlend(from, to, 11.0), 1.0, 1e-9);
+  csci3081::InterpolateSnapshots(from, to, 0.5, &out);
+  EXPECT_NEAR(out.entities[0].x, 5.0, 1e-9);
+  EXPECT_NEAR(std::remainder(out.entities[0].theta, 360.0), 0.0, 1e-9)
+    << "FAIL: Headings should turn the short way round";
+
+  // A reset or a rebuilt Arena is not blended.
+  to.ticks = 0;
+  EXPECT_NEAR(csci3081::SnapshotBlend(from, to, 10.15), 1.0, 1e-9);
+  to.entities.resize(2);
+  csci3081::InterpolateSnapshots(from, to, 0.5, &out);
+  EXPECT_NEAR(out.entities[0].x, 10.0, 1e-9);
+}
+
+TEST(ArenaSnapshotTest, SimulationThreadPublishesSteps) {
+  csci3081::arena_params params;
+  params.seed = 11;
+  csci3081::Arena arena(&params);
+  csci3081::SnapshotBuffer buffer;
+  csci3081::SimulationThread sim(&arena, &buffer);
+  sim.SetTimeScale(csci3081::StepAccumulator::kMaxTimeScale);
+  sim.Start();
+
+  // Paused: only the first snapshot, of the Arena as built.
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  ASSERT_TRUE(buffer.Acquire());
+  EXPECT_EQ(buffer.get_latest().ticks, 0u);
+  EXPECT_EQ(buffer.get_latest().entities.size(), arena.get_entities().size());
+  EXPECT_EQ(buffer.get_latest().sensors.size(), arena.get_sensors().size());
+
+  sim.set_running(true);
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+  while (buffer.get_latest().ticks < 100 &&
+         std::chrono::steady_clock::now() < deadline) {
+    buffer.Acquire();
+  }
+  EXPECT_GE(buffer.get_latest().ticks, 100u)
+    << "FAIL: The simulation thread did not step the Arena";
+
+  sim.set_running(false);
+  uint64_t ticks = 0;
+  sim.EditArena([&ticks](csci3081::Arena *edited) {
+      ticks = edited->get_clock().get_ticks();
+    });
+  sim.Stop();
+  buffer.Acquire();
+  EXPECT_EQ(buffer.get_latest().ticks, ticks);
+  EXPECT_EQ(arena.get_clock().get_ticks(), ticks)
+    << "FAIL: The Arena stepped while paused";
+}
+
+#endif /* ARENA_SNAPSHOT_TESTS */
@@ -0,0 +1,124 @@
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <gtest/gtest.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <string>
+
+#include "src/arena.h"
+#include "src/arena_params.h"
+#include "src/background_checkpointer.h"
+#include "src/checkpoint.h"
+
+#ifdef BACKGROUND_CHECKPOINTER_TESTS
+
+/*******************************************************************************
+ * Non-Member Functions
+ ******************************************************************************/
+static csci3081::arena_params TestParams() {
+  csci3081::arena_params params;
+  params.n_robots = 30;
+  params.n_lights = 8;
+  params.n_foods = 10;
+  params.seed = 11;
+  return params;
+}
+
+static std::string TestPath(const char *name) {
+  return "/tmp/background_checkpointer_unittest_" +
+         std::to_string(getpid()) + "_" + name;
+}
+
+static std::string ReadFile(const std::string &path) {
+  std::ifstream in(path, std::ios::binary);
+  return std::string((std::istreambuf_iterator<char>(in)),
+                     std::istreambuf_iterator<char>());
+}
+
+/*******************************************************************************
+ * Test Cases
+ ******************************************************************************/
+TEST(BackgroundCheckpointerTest, ChildSavesTheArenaAsItWasAtFork) {
+  csci3081::arena_params params = TestParams();
+  csci3081::Arena arena(&params);
+  for (int i = 0; i < 50; ++i) {
+    arena.UpdateEntitiesTimestep();
+  }
+  std::string forked = TestPath("forked");
+  std::string direct = TestPath("direct");
+  std::string error;
+  ASSERT_TRUE(csci3081::SaveCheckpoint(arena, direct, &error)) << error;
+
+  csci3081::BackgroundCheckpointer checkpointer(forked, 0);
+  ASSERT_TRUE(checkpointer.Start(arena)) << checkpointer.get_error();
+  // The parent keeps going; the child has its own copy.
+  for (int i = 0; i < 50; ++i) {
+    arena.UpdateEntitiesTimestep();
+  }
+  checkpointer.Wait();
+  EXPECT_FALSE(checkpointer.is_in_flight());
+  EXPECT_EQ(checkpointer.get_n_written(), 1u);
+  EXPECT_EQ(checkpointer.get_n_failed(), 0u);
+  EXPECT_EQ(checkpointer.get_pause_histogram().get_count(), 1u);
+  EXPECT_EQ(checkpointer.get_latency_histogram().get_count(), 1u);
+  EXPECT_GT(checkpointer.get_latency_histogram().get_max(), 0.0);
+  EXPECT_TRUE(ReadFile(forked) == ReadFile(direct));
+  std::remove(forked.c_str());
+  std::remove(direct.c_str());
+}
+
+TEST(BackgroundCheckpointerTest, OneChildInFlight) {
+  csci3081::arena_params params = TestParams();
+  csci3081::Arena arena(&params);
+  std::string path = TestPath("in_flight");
+  csci3081::BackgroundCheckpointer checkpointer(path, 0);
+  ASSERT_TRUE(checkpointer.Start(arena));
+  // Not collected yet, so still in flight whether or not it has finished.
+  EXPECT_FALSE(checkpointer.Start(arena));
+  checkpointer.Wait();
+  EXPECT_TRUE(checkpointer.Start(arena));
+  checkpointer.Wait();
+  EXPECT_EQ(checkpointer.get_n_written(), 2u);
+  std::remove(path.c_str());
+}
+
+TEST(BackgroundCheckpointerTest, CheckpointsEveryInterval) {
+  csci3081::arena_params params = TestParams();
+  csci3081::Arena arena(&params);
+  std::string path = TestPath("interval");
+  csci3081::BackgroundCheckpointer checkpointer(path, 10);
+  for (int i = 0; i < 100; ++i) {
+    arena.UpdateEntitiesTimestep();
+    checkpointer.AfterStep(arena);
+    if (i % 10 == 9) {
+      // Finish each child before the next falls due.
+      checkpointer.Wait();
+    }
+  }
+  EXPECT_EQ(checkpointer.get_n_written(), 10u);
+  EXPECT_EQ(checkpointer.get_n_delayed(), 0u);
+
+  std::string error;
+  csci3081::Arena *restored = csci3081::LoadCheckpoint(path, &error);
+  ASSERT_NE(restored, nullptr) << error;
+  EXPECT_EQ(restored->get_clock().get_ticks(), arena.get_clock().get_ticks());
+  delete restored;
+  std::remove(path.c_str());
+}
+
+TEST(BackgroundCheckpointerTest, ReportsFailedChild) {
+  csci3081::arena_params params = TestParams();
+  csci3081::Arena arena(&params);
+  csci3081::BackgroundCheckpointer checkpointer("/nonexistent/dir/ckp", 0);
+  ASSERT_TRUE(checkpointer.Start(arena));
+  checkpointer.Wait();
+  EXPECT_EQ(checkpointer.get_n_written(), 0u);
+  EXPECT_EQ(checkpointer.get_n_failed(), 1u);
+  EXPECT_FALSE(checkpointer.get_error().empty());
+}
+
+#endif /* BACKGROUND_CHECKPOINTER_TESTS */
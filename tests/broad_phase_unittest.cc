@@ -0,0 +1,223 @@
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <gtest/gtest.h>
+#include <cmath>
+#include <random>
+#include <vector>
+#include "src/arena.h"
+#include "src/arena_params.h"
+#include "src/broad_phase.h"
+#include "src/entity_store.h"
+#include "src/entity_type.h"
+#include "src/food.h"
+#include "src/light.h"
+#include "src/robot.h"
+
+#ifdef BROAD_PHASE_TESTS
+
+
+class BroadPhaseTest : public ::testing::Test {
+
+  protected:
+
+  virtual void SetUp() {
+    std::mt19937 rng(3081);
+    std::uniform_real_distribution<double> x(0.0, 1024.0);
+    std::uniform_real_distribution<double> y(0.0, 768.0);
+    // The store expects robots, then lights, then foods.
+    for (int i = 0; i < 300; i++) {
+      csci3081::ArenaEntity * ent;
+      if (i < 100) {
+        ent = new csci3081::Robot();
+      } else if (i < 200) {
+        ent = new csci3081::Light();
+      } else {
+        ent = new csci3081::Food();
+      }
+      ent->set_position(x(rng), y(rng));
+      ent->set_radius(10 + i % 30);
+      entities.push_back(ent);
+    }
+    store.Build(entities);
+  }
+
+  virtual void TearDown() {
+    for (auto &ent : entities) {
+      delete ent;
+    }
+  }
+
+  /* The pairs that actually touch, filtered from a broad phase's output (or
+   * from every pair when `candidates` is null).
+   */
+  std::vector<std::pair<int, int>> Touching(
+    const std::vector<csci3081::CollisionPair> *candidates) {
+    std::vector<std::pair<int, int>> touching;
+    int n = static_cast<int>(entities.size());
+    for (int i = 0; i < n; i++) {
+      for (int j = i + 1; j < n; j++) {
+        if (candidates) { break; }
+        AddIfTouching(i, j, &touching);
+      }
+    }
+    if (candidates) {
+      for (auto &pair : *candidates) {
+        AddIfTouching(pair.first, pair.second, &touching);
+      }
+    }
+    return touching;
+  }
+
+  void AddIfTouching(int i, int j, std::vector<std::pair<int, int>> *out) {
+    csci3081::ArenaEntity *a = entities[i];
+    csci3081::ArenaEntity *b = entities[j];
+    if (!csci3081::BroadPhase::Interacts(a->get_type(), b->get_type())) {
+      return;
+    }
+    double dx = a->get_pose().x - b->get_pose().x;
+    double dy = a->get_pose().y - b->get_pose().y;
+    if (std::sqrt(dx*dx + dy*dy) <= a->get_radius() + b->get_radius()) {
+      out->push_back({i, j});
+    }
+  }
+
+  std::vector<csci3081::ArenaEntity*> entities;
+  csci3081::EntityStore store;
+};
+
+/*******************************************************************************
+ * Test Cases
+ ******************************************************************************/
+
+TEST_F(BroadPhaseTest, MaskMatchesSkipRules) {
+  using csci3081::BroadPhase;
+  EXPECT_TRUE(BroadPhase::Reacts(csci3081::kRobot, csci3081::kRobot));
+  EXPECT_TRUE(BroadPhase::Reacts(csci3081::kRobot, csci3081::kFood));
+  EXPECT_FALSE(BroadPhase::Reacts(csci3081::kRobot, csci3081::kLight))
+    << "FAIL: Robots should ignore lights";
+  EXPECT_TRUE(BroadPhase::Reacts(csci3081::kLight, csci3081::kLight));
+  EXPECT_FALSE(BroadPhase::Reacts(csci3081::kLight, csci3081::kRobot))
+    << "FAIL: Lights should ignore robots";
+  EXPECT_FALSE(BroadPhase::Reacts(csci3081::kLight, csci3081::kFood))
+    << "FAIL: Lights should ignore food";
+  EXPECT_FALSE(BroadPhase::Reacts(csci3081::kFood, csci3081::kRobot));
+  EXPECT_FALSE(BroadPhase::Interacts(csci3081::kFood, csci3081::kFood));
+  EXPECT_FALSE(BroadPhase::Interacts(csci3081::kLight, csci3081::kFood));
+}
+
+TEST_F(BroadPhaseTest, BruteForceIsNull) {
+  csci3081::BroadPhase * bp =
+    csci3081::BroadPhase::Create(csci3081::kBruteForce);
+  EXPECT_EQ(bp, nullptr)
+    << "FAIL: The brute-force reference should use the Arena's own loop";
+}
+
+TEST_F(BroadPhaseTest, SpatialHashMatchesBruteForce) {
+  csci3081::SpatialHashGrid grid;
+  std::vector<csci3081::CollisionPair> pairs;
+  grid.FindPairs(store, &pairs);
+  EXPECT_EQ(Touching(&pairs), Touching(nullptr))
+    << "FAIL: Spatial hash missed or invented colliding pairs";
+}
+
+TEST_F(BroadPhaseTest, SortAndSweepMatchesBruteForce) {
+  csci3081::SortAndSweep sweep;
+  std::vector<csci3081::CollisionPair> pairs;
+  sweep.FindPairs(store, &pairs);
+  EXPECT_EQ(Touching(&pairs), Touching(nullptr))
+    << "FAIL: Sort-and-sweep missed or invented colliding pairs";
+}
+
+TEST_F(BroadPhaseTest, EachPairReportedOnce) {
+  csci3081::SpatialHashGrid grid;
+  csci3081::SortAndSweep sweep;
+  std::vector<csci3081::CollisionPair> pairs;
+  for (csci3081::BroadPhase * bp :
+         std::vector<csci3081::BroadPhase*>{&grid, &sweep}) {
+    bp->FindPairs(store, &pairs);
+    for (size_t k = 0; k < pairs.size(); k++) {
+      EXPECT_LT(pairs[k].first, pairs[k].second)
+        << "FAIL: Pairs must be stored as (lower, higher) index";
+      if (k > 0) {
+        EXPECT_TRUE(pairs[k - 1].first < pairs[k].first ||
+                    (pairs[k - 1].first == pairs[k].first &&
+                     pairs[k - 1].second < pairs[k].second))
+          << "FAIL: Pairs are unsorted or reported twice";
+      }
+    }
+  }
+}
+
+TEST_F(BroadPhaseTest, StoreRangesFollowTypes) {
+  EXPECT_EQ(store.robots().begin, 0u);
+  EXPECT_EQ(store.robots().size(), 100u);
+  EXPECT_EQ(store.lights().size(), 100u);
+  EXPECT_EQ(store.foods().end, store.size());
+  EXPECT_EQ(store.mobiles().size(), 200u);
+  for (size_t i = 0; i < store.size(); i++) {
+    EXPECT_EQ(store.type()[i], entities[i]->get_type());
+    EXPECT_EQ(store.x()[i], entities[i]->get_pose().x);
+  }
+}
+
+/* Two still robots against the left wall: robot 1 touches the wall and
+ * robot 0 touches robot 1 from the right. Returns their x after one step.
+ */
+static std::pair<double, double> StepAgainstWall(
+    csci3081::BroadPhaseType type) {
+  csci3081::arena_params params;
+  params.n_robots = 2;
+  params.n_lights = 0;
+  params.n_foods = 0;
+  params.broad_phase = type;
+  params.seed = 1;
+  csci3081::Arena arena(&params);
+  const double x[2] = {50.0, 15.0};
+  for (int i = 0; i < 2; i++) {
+    csci3081::entity_state state;
+    arena.get_robots()[i]->SaveState(&state);
+    state.x = x[i];
+    state.y = 300.0;
+    state.theta = 0.0;
+    state.radius = 20.0;
+    state.velocity_left = 0.0;
+    state.velocity_right = 0.0;
+    arena.get_robots()[i]->LoadState(state);
+  }
+  arena.UpdateEntitiesTimestep();
+  return {arena.get_robots()[0]->get_pose().x,
+          arena.get_robots()[1]->get_pose().x};
+}
+
+TEST_F(BroadPhaseTest, WallsResolveBeforePairs) {
+  // The broad phases move every entity off the walls first, then resolve
+  // the pairs: robot 1 goes to x = 25, then robot 0 is pushed out to 65.
+  for (auto type : {csci3081::kSpatialHash, csci3081::kSortAndSweep}) {
+    std::pair<double, double> x = StepAgainstWall(type);
+    EXPECT_NEAR(x.first, 65.0, 1e-9);
+    EXPECT_NEAR(x.second, 25.0, 1e-9);
+  }
+  // The brute-force loop handles each entity's wall and pairs in turn:
+  // robot 0 is pushed to 55, then robot 1 off the wall to 25 and back
+  // out of robot 0 to 15.
+  std::pair<double, double> x = StepAgainstWall(csci3081::kBruteForce);
+  EXPECT_NEAR(x.first, 55.0, 1e-9);
+  EXPECT_NEAR(x.second, 15.0, 1e-9);
+}
+
+TEST_F(BroadPhaseTest, ArenaRunsWithEveryBackend) {
+  for (auto type : {csci3081::kBruteForce, csci3081::kSpatialHash,
+                    csci3081::kSortAndSweep}) {
+    csci3081::arena_params params;
+    params.broad_phase = type;
+    csci3081::Arena arena(&params);
+    EXPECT_EQ(arena.get_broad_phase() == nullptr,
+              type == csci3081::kBruteForce);
+    for (int i = 0; i < 50; i++) {
+      arena.UpdateEntitiesTimestep();
+    }
+  }
+}
+
+#endif /* BROAD_PHASE_TESTS */
@@ -0,0 +1,189 @@
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <gtest/gtest.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "src/arena.h"
+#include "src/arena_params.h"
+#include "src/checkpoint.h"
+#include "src/sensor.h"
+
+#ifdef CHECKPOINT_TESTS
+
+/*******************************************************************************
+ * Non-Member Functions
+ ******************************************************************************/
+static csci3081::arena_params TestParams() {
+  csci3081::arena_params params;
+  params.n_robots = 30;
+  params.n_lights = 8;
+  params.n_foods = 10;
+  params.seed = 7;
+  return params;
+}
+
+static std::string TestPath(const char *name) {
+  return "/tmp/checkpoint_unittest_" + std::to_string(getpid()) + "_" + name;
+}
+
+/* The bytes of every entity and sensor record of `arena`. */
+static std::vector<char> StateBytes(const csci3081::Arena &arena) {
+  std::vector<char> bytes;
+  for (auto &ent : arena.get_entities()) {
+    csci3081::entity_state record;
+    memset(&record, 0, sizeof(record));
+    ent->SaveState(&record);
+    const char *begin = reinterpret_cast<const char *>(&record);
+    bytes.insert(bytes.end(), begin, begin + sizeof(record));
+  }
+  for (auto &sensor : arena.get_sensors()) {
+    double values[4] = {sensor->get_pose().x, sensor->get_pose().y,
+                        sensor->get_pose().theta, sensor->get_impulse()};
+    const char *begin = reinterpret_cast<const char *>(values);
+    bytes.insert(bytes.end(), begin, begin + sizeof(values));
+    bytes.push_back(sensor->is_active() ? 1 : 0);
+  }
+  return bytes;
+}
+
+static void ExpectSameArena(const csci3081::Arena &expected,
+                            const csci3081::Arena &actual) {
+  csci3081::arena_state expected_state, actual_state;
+  expected.SaveState(&expected_state);
+  actual.SaveState(&actual_state);
+  EXPECT_EQ(expected_state.ticks, actual_state.ticks);
+  EXPECT_EQ(expected_state.rng_state, actual_state.rng_state);
+  EXPECT_EQ(expected_state.n_collisions, actual_state.n_collisions);
+  EXPECT_EQ(expected_state.game_status, actual_state.game_status);
+  EXPECT_TRUE(StateBytes(expected) == StateBytes(actual));
+}
+
+/*******************************************************************************
+ * Test Cases
+ ******************************************************************************/
+TEST(CheckpointTest, RestoredRunContinuesIdentically) {
+  csci3081::arena_params params = TestParams();
+  csci3081::Arena arena(&params);
+  arena.set_f_e_ratio(0.4f);
+  for (int i = 0; i < 300; ++i) {
+    arena.UpdateEntitiesTimestep();
+  }
+  std::string path = TestPath("continue");
+  std::string error;
+  ASSERT_TRUE(csci3081::SaveCheckpoint(arena, path, &error)) << error;
+
+  csci3081::Arena *restored = csci3081::LoadCheckpoint(path, &error);
+  ASSERT_NE(restored, nullptr) << error;
+  EXPECT_FLOAT_EQ(restored->get_f_e_ratio(), 0.4f);
+  ExpectSameArena(arena, *restored);
+  for (int i = 0; i < 300; ++i) {
+    arena.UpdateEntitiesTimestep();
+    restored->UpdateEntitiesTimestep();
+  }
+  ExpectSameArena(arena, *restored);
+  delete restored;
+  std::remove(path.c_str());
+}
+
+TEST(CheckpointTest, ThreadCountDoesNotChangeTheRun) {
+  csci3081::arena_params params = TestParams();
+  csci3081::Arena arena(&params);
+  for (int i = 0; i < 100; ++i) {
+    arena.UpdateEntitiesTimestep();
+  }
+  std::string path = TestPath("threads");
+  std::string error;
+  ASSERT_TRUE(csci3081::SaveCheckpoint(arena, path, &error)) << error;
+
+  csci3081::Arena *restored = csci3081::LoadCheckpoint(path, &error, 4);
+  ASSERT_NE(restored, nullptr) << error;
+  EXPECT_EQ(restored->get_n_threads(), 4);
+  for (int i = 0; i < 200; ++i) {
+    arena.UpdateEntitiesTimestep();
+    restored->UpdateEntitiesTimestep();
+  }
+  ExpectSameArena(arena, *restored);
+  delete restored;
+  std::remove(path.c_str());
+}
+
+TEST(CheckpointTest, RestoresIntoExistingArena) {
+  csci3081::arena_params params = TestParams();
+  csci3081::Arena arena(&params);
+  for (int i = 0; i < 150; ++i) {
+    arena.UpdateEntitiesTimestep();
+  }
+  std::string path = TestPath("existing");
+  std::string error;
+  ASSERT_TRUE(csci3081::SaveCheckpoint(arena, path, &error)) << error;
+
+  csci3081::Arena other(&params);
+  ASSERT_TRUE(csci3081::RestoreCheckpoint(path, &other, &error)) << error;
+  ExpectSameArena(arena, other);
+  std::remove(path.c_str());
+}
+
+TEST(CheckpointTest, RejectsMismatchedArena) {
+  csci3081::arena_params params = TestParams();
+  csci3081::Arena arena(&params);
+  std::string path = TestPath("mismatch");
+  std::string error;
+  ASSERT_TRUE(csci3081::SaveCheckpoint(arena, path, &error)) << error;
+
+  params.n_robots = 31;
+  csci3081::Arena other(&params);
+  std::vector<char> before = StateBytes(other);
+  EXPECT_FALSE(csci3081::RestoreCheckpoint(path, &other, &error));
+  EXPECT_FALSE(error.empty());
+  EXPECT_TRUE(before == StateBytes(other));
+  std::remove(path.c_str());
+}
+
+TEST(CheckpointTest, RejectsBadFiles) {
+  csci3081::arena_params params = TestParams();
+  csci3081::Arena arena(&params);
+  std::string path = TestPath("bad");
+  std::string error;
+  ASSERT_TRUE(csci3081::SaveCheckpoint(arena, path, &error)) << error;
+
+  // Truncated by one byte.
+  std::ifstream in(path, std::ios::binary);
+  std::string contents((std::istreambuf_iterator<char>(in)),
+                       std::istreambuf_iterator<char>());
+  in.close();
+  std::ofstream(path, std::ios::binary).write(contents.data(),
+                                              contents.size() - 1);
+  EXPECT_EQ(csci3081::LoadCheckpoint(path, &error), nullptr);
+  EXPECT_NE(error.find("truncated"), std::string::npos);
+
+  // The first robot's record claims to be a food.
+  std::string mistyped = contents;
+  csci3081::entity_state record;
+  char *first = &mistyped[sizeof(csci3081::checkpoint_header)];
+  memcpy(&record, first, sizeof(record));
+  record.type = csci3081::kFood;
+  memcpy(first, &record, sizeof(record));
+  std::ofstream(path, std::ios::binary).write(mistyped.data(),
+                                              mistyped.size());
+  EXPECT_EQ(csci3081::LoadCheckpoint(path, &error), nullptr);
+  EXPECT_NE(error.find("corrupt"), std::string::npos);
+
+  // Bad magic.
+  contents[0] = 'X';
+  std::ofstream(path, std::ios::binary).write(contents.data(),
+                                              contents.size());
+  EXPECT_EQ(csci3081::LoadCheckpoint(path, &error), nullptr);
+  EXPECT_NE(error.find("not a checkpoint"), std::string::npos);
+
+  std::remove(path.c_str());
+  EXPECT_EQ(csci3081::LoadCheckpoint(path, &error), nullptr);
+}
+
+#endif /* CHECKPOINT_TESTS */
@@ -0,0 +1,87 @@
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <gtest/gtest.h>
+#include <vector>
+#include "src/arena.h"
+#include "src/arena_params.h"
+#include "src/ensemble.h"
+
+#ifdef ENSEMBLE_TESTS
+
+
+class EnsembleTest : public ::testing::Test {
+
+  protected:
+
+  virtual void SetUp() {
+    for (int k = 0; k < 6; k++) {
+      csci3081::EnsembleRun run;
+      run.params.n_robots = 4;
+      run.params.n_foods = 2;
+      run.params.seed = 100 + k;
+      run.f_e_ratio = 0.25f * (k % 4);
+      run.max_steps = 800;
+      runs.push_back(run);
+    }
+  }
+
+  std::vector<csci3081::EnsembleRun> runs;
+};
+
+/*******************************************************************************
+ * Test Cases
+ ******************************************************************************/
+
+TEST_F(EnsembleTest, ReseedAndResetIsReproducible) {
+  csci3081::arena_params params;
+  params.seed = 7;
+  csci3081::Arena arena(&params);
+  arena.Reseed(42);
+  arena.Reset();
+  std::vector<csci3081::Pose> first;
+  for (auto &ent : arena.get_entities()) {
+    first.push_back(ent->get_pose());
+  }
+  for (int i = 0; i < 20; i++) {
+    arena.UpdateEntitiesTimestep();
+  }
+  arena.Reseed(42);
+  arena.Reset();
+  std::vector<csci3081::ArenaEntity *> entities = arena.get_entities();
+  for (size_t i = 0; i < entities.size(); i++) {
+    EXPECT_EQ(entities[i]->get_pose().x, first[i].x);
+    EXPECT_EQ(entities[i]->get_pose().y, first[i].y);
+  }
+}
+
+TEST_F(EnsembleTest, OutcomesDoNotDependOnThreads) {
+  csci3081::EnsembleRunner serial(1);
+  csci3081::EnsembleRunner threaded(3);
+  std::vector<csci3081::EnsembleOutcome> expected = serial.Run(runs);
+  std::vector<csci3081::EnsembleOutcome> actual = threaded.Run(runs);
+  ASSERT_EQ(actual.size(), runs.size());
+  for (size_t k = 0; k < runs.size(); k++) {
+    EXPECT_EQ(actual[k].seed, runs[k].params.seed);
+    EXPECT_EQ(actual[k].steps, expected[k].steps)
+      << "FAIL: Run " << k << " depends on the thread it ran on";
+    EXPECT_EQ(actual[k].lost, expected[k].lost);
+    EXPECT_EQ(actual[k].n_starved, expected[k].n_starved);
+    EXPECT_EQ(actual[k].n_food_collisions, expected[k].n_food_collisions);
+    EXPECT_LE(actual[k].steps, runs[k].max_steps);
+  }
+}
+
+TEST_F(EnsembleTest, ArenasAreReused) {
+  csci3081::EnsembleRunner runner(2);
+  runner.Run(runs);
+  runner.Run(runs);
+  EXPECT_LE(runner.get_n_arenas_built(), 2)
+    << "FAIL: Runs with the same layout should reset, not rebuild";
+
+  runs[0].params.n_robots = 5;
+  runner.Run({runs[0]});
+  EXPECT_LE(runner.get_n_arenas_built(), 3);
+}
+
+#endif /* ENSEMBLE_TESTS */
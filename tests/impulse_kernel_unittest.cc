@@ -0,0 +1,112 @@
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <gtest/gtest.h>
+#include <cmath>
+#include <random>
+#include <vector>
+#include "src/entity_store.h"
+#include "src/impulse_kernel.h"
+#include "src/light.h"
+#include "src/sensor.h"
+
+#ifdef IMPULSE_KERNEL_TESTS
+
+
+class ImpulseKernelTest : public ::testing::Test {
+
+  protected:
+
+  virtual void SetUp() {
+    std::mt19937 rng(3081);
+    std::uniform_real_distribution<double> x(0.0, 1024.0);
+    std::uniform_real_distribution<double> y(0.0, 768.0);
+    std::uniform_real_distribution<double> intensity(0.0, 1200.0);
+    // Not a multiple of any vector width or of the block size.
+    for (int i = 0; i < 1031; i++) {
+      emitter_x.push_back(x(rng));
+      emitter_y.push_back(y(rng));
+      emitter_intensity.push_back(intensity(rng));
+    }
+    for (int i = 0; i < 37; i++) {
+      sensor_x.push_back(x(rng));
+      sensor_y.push_back(y(rng));
+    }
+    // A sensor on top of an emitter, and one far outside the arena.
+    sensor_x.push_back(emitter_x[5]);
+    sensor_y.push_back(emitter_y[5]);
+    sensor_x.push_back(-20000.0);
+    sensor_y.push_back(0.0);
+  }
+
+  std::vector<double> Run(csci3081::ImpulseKernelIsa isa) {
+    std::vector<double> impulse(sensor_x.size(), -1.0);
+    csci3081::ComputeImpulses(sensor_x.data(), sensor_y.data(),
+                              sensor_x.size(), emitter_x.data(),
+                              emitter_y.data(), emitter_intensity.data(),
+                              emitter_x.size(), impulse.data(), isa);
+    return impulse;
+  }
+
+  std::vector<double> emitter_x;
+  std::vector<double> emitter_y;
+  std::vector<double> emitter_intensity;
+  std::vector<double> sensor_x;
+  std::vector<double> sensor_y;
+};
+
+/*******************************************************************************
+ * Test Cases
+ ******************************************************************************/
+
+TEST_F(ImpulseKernelTest, ScalarMatchesReceiveInfo) {
+  std::vector<csci3081::ArenaEntity *> lights;
+  for (size_t i = 0; i < emitter_x.size(); i++) {
+    csci3081::Light *light = new csci3081::Light();
+    light->set_position(emitter_x[i], emitter_y[i]);
+    light->set_intensity(emitter_intensity[i]);
+    lights.push_back(light);
+  }
+  csci3081::EntityStore store;
+  store.Build(lights);
+  csci3081::Sensor sensor(LEFT, csci3081::kLight);
+  std::vector<double> impulse = Run(csci3081::kScalarKernel);
+  for (size_t s = 0; s < sensor_x.size(); s++) {
+    sensor.set_pose({sensor_x[s], sensor_y[s]});
+    sensor.ReceiveInfo(store);
+    EXPECT_EQ(impulse[s], sensor.get_impulse());
+  }
+  for (auto &light : lights) {
+    delete light;
+  }
+}
+
+TEST_F(ImpulseKernelTest, VectorKernelsMatchScalar) {
+  std::vector<double> expected = Run(csci3081::kScalarKernel);
+  for (auto isa : {csci3081::kSse2Kernel, csci3081::kAvx2Kernel,
+                   csci3081::kBestKernel}) {
+    std::vector<double> actual = Run(isa);
+    for (size_t s = 0; s < expected.size(); s++) {
+      EXPECT_NEAR(actual[s], expected[s], 1e-12 * expected[s] + 1e-300)
+        << "FAIL: Kernel " << csci3081::ResolveImpulseKernel(isa)
+        << " is off for sensor " << s;
+    }
+  }
+}
+
+TEST_F(ImpulseKernelTest, SplittingSensorsDoesNotChangeResults) {
+  std::vector<double> whole = Run(csci3081::kBestKernel);
+  std::vector<double> split(sensor_x.size());
+  size_t half = sensor_x.size() / 2;
+  csci3081::ComputeImpulses(sensor_x.data(), sensor_y.data(), half,
+                            emitter_x.data(), emitter_y.data(),
+                            emitter_intensity.data(), emitter_x.size(),
+                            split.data());
+  csci3081::ComputeImpulses(sensor_x.data() + half, sensor_y.data() + half,
+                            sensor_x.size() - half, emitter_x.data(),
+                            emitter_y.data(), emitter_intensity.data(),
+                            emitter_x.size(), split.data() + half);
+  EXPECT_EQ(split, whole);
+}
+
+#endif /* IMPULSE_KERNEL_TESTS */
@@ -0,0 +1,59 @@
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <gtest/gtest.h>
+#include "src/latency_histogram.h"
+#include "src/step_profiler.h"
+
+#ifdef LATENCY_HISTOGRAM_TESTS
+
+/*******************************************************************************
+ * Test Cases
+ ******************************************************************************/
+TEST(LatencyHistogramTest, PercentilesWithinOnePercent) {
+  csci3081::LatencyHistogram histogram;
+  // 1 us to 10 ms in 1 us steps.
+  for (int us = 1; us <= 10000; ++us) {
+    histogram.Record(us * 1e-6);
+  }
+  EXPECT_EQ(histogram.get_count(), 10000u);
+  EXPECT_NEAR(histogram.get_min(), 1e-6, 1e-12);
+  EXPECT_NEAR(histogram.get_max(), 10e-3, 1e-12);
+  EXPECT_NEAR(histogram.get_mean(), 5.0005e-3, 1e-9);
+  const double percentiles[] = {50.0, 90.0, 99.0, 99.9};
+  for (double p : percentiles) {
+    double exact = p / 100.0 * 10e-3;
+    EXPECT_NEAR(histogram.ValueAtPercentile(p), exact, exact * 0.01)
+      << "FAIL: p" << p;
+  }
+  EXPECT_DOUBLE_EQ(histogram.ValueAtPercentile(100.0), histogram.get_max());
+}
+
+TEST(LatencyHistogramTest, SpikeShowsInTail) {
+  csci3081::LatencyHistogram histogram;
+  for (int i = 0; i < 999; ++i) {
+    histogram.Record(2e-3);
+  }
+  histogram.Record(0.5);
+  EXPECT_NEAR(histogram.ValueAtPercentile(50.0), 2e-3, 2e-5);
+  EXPECT_NEAR(histogram.ValueAtPercentile(99.0), 2e-3, 2e-5);
+  EXPECT_NEAR(histogram.ValueAtPercentile(99.99), 0.5, 0.005);
+  histogram.Reset();
+  EXPECT_EQ(histogram.get_count(), 0u);
+  EXPECT_DOUBLE_EQ(histogram.ValueAtPercentile(99.0), 0.0);
+}
+
+TEST(LatencyHistogramTest, WatchdogCountsStepsOverBudget) {
+  csci3081::StepProfiler profiler;
+  profiler.set_budget(0.016);
+  profiler.AddPhase(csci3081::kPhaseCollisions, 0.020);
+  profiler.EndStep(0.021, 1.0);
+  profiler.EndStep(0.004, 1.1);
+  profiler.EndStep(0.030, 1.2);
+  csci3081::step_stats stats = profiler.GetStats();
+  EXPECT_EQ(stats.n_over_budget, 2u);
+  EXPECT_EQ(profiler.get_histogram().get_count(), 3u);
+  EXPECT_NEAR(stats.step_p50_ms, 21.0, 0.21);
+}
+
+#endif /* LATENCY_HISTOGRAM_TESTS */
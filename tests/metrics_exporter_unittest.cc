@@ -0,0 +1,111 @@
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <gtest/gtest.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <cstring>
+#include <string>
+
+#include "src/arena.h"
+#include "src/arena_params.h"
+#include "src/metrics_exporter.h"
+
+#ifdef METRICS_EXPORTER_TESTS
+
+/*******************************************************************************
+ * Non-Member Functions
+ ******************************************************************************/
+/* Connect to the exporter at `path`, send `request` and read to EOF. */
+static std::string Scrape(const std::string &path,
+                          const std::string &request) {
+  int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+  sockaddr_un address;
+  memset(&address, 0, sizeof(address));
+  address.sun_family = AF_UNIX;
+  memcpy(address.sun_path, path.c_str(), path.size());
+  if (connect(fd, reinterpret_cast<sockaddr *>(&address),
+              sizeof(address)) < 0) {
+    close(fd);
+    return "";
+  }
+  if (!request.empty()) {
+    EXPECT_GT(send(fd, request.data(), request.size(), 0), 0);
+  }
+  std::string response;
+  char buffer[4096];
+  ssize_t n;
+  while ((n = recv(fd, buffer, sizeof(buffer), 0)) > 0) {
+    response.append(buffer, static_cast<size_t>(n));
+  }
+  close(fd);
+  return response;
+}
+
+/*******************************************************************************
+ * Test Cases
+ ******************************************************************************/
+TEST(MetricsExporterTest, CapturesArena) {
+  csci3081::arena_params params;
+  params.n_robots = 40;
+  params.n_foods = 20;
+  csci3081::Arena arena(&params);
+  for (int i = 0; i < 200; ++i) {
+    arena.UpdateEntitiesTimestep();
+  }
+  csci3081::arena_metrics metrics;
+  csci3081::CaptureMetrics(arena, &metrics);
+  EXPECT_EQ(metrics.n_steps, 200u);
+  EXPECT_EQ(metrics.n_robots, 40u);
+  EXPECT_EQ(metrics.n_lights, params.n_lights);
+  EXPECT_EQ(metrics.n_foods, 20u);
+  EXPECT_GT(metrics.n_collisions, 0u) << "FAIL: 60 entities never touched";
+  EXPECT_GT(metrics.step_p99, 0.0);
+
+  std::string text = csci3081::FormatMetrics(metrics);
+  EXPECT_NE(text.find("# TYPE arena_steps_total counter\n"
+                      "arena_steps_total 200\n"), std::string::npos);
+  EXPECT_NE(text.find("arena_entities{type=\"robot\"} 40\n"),
+            std::string::npos);
+  EXPECT_NE(text.find("arena_step_seconds{quantile=\"0.99\"} "),
+            std::string::npos);
+
+  arena.Reset();
+  EXPECT_EQ(arena.get_n_collisions(), 0u);
+}
+
+TEST(MetricsExporterTest, ServesLatestSample) {
+  std::string path = testing::TempDir() + "metrics_exporter_unittest.sock";
+  csci3081::MetricsExporter exporter(path);
+  ASSERT_TRUE(exporter.Start()) << exporter.get_error();
+
+  csci3081::arena_params params;
+  csci3081::Arena arena(&params);
+  for (int i = 0; i < 10; ++i) {
+    arena.UpdateEntitiesTimestep();
+  }
+  exporter.ForceSample(arena);
+  std::string bare = Scrape(path, "");
+  EXPECT_NE(bare.find("arena_steps_total 10\n"), std::string::npos) << bare;
+
+  arena.UpdateEntitiesTimestep();
+  exporter.ForceSample(arena);
+  std::string http = Scrape(path, "GET /metrics HTTP/1.1\r\n\r\n");
+  EXPECT_EQ(http.compare(0, 15, "HTTP/1.0 200 OK"), 0) << http;
+  EXPECT_NE(http.find("\r\n\r\n# HELP"), std::string::npos);
+  EXPECT_NE(http.find("arena_steps_total 11\n"), std::string::npos);
+  EXPECT_EQ(exporter.get_n_requests(), 2u);
+
+  exporter.Stop();
+  EXPECT_NE(access(path.c_str(), F_OK), 0) << "FAIL: socket left behind";
+}
+
+TEST(MetricsExporterTest, BadPathFails) {
+  csci3081::MetricsExporter exporter("/nonexistent-dir/metrics.sock");
+  EXPECT_FALSE(exporter.Start());
+  EXPECT_FALSE(exporter.get_error().empty());
+}
+
+#endif /* METRICS_EXPORTER_TESTS */
@@ -0,0 +1,85 @@
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <gtest/gtest.h>
+#include <map>
+#include <string>
+#include "src/arena.h"
+#include "src/arena_params.h"
+#include "src/object_pool.h"
+
+#ifdef OBJECT_POOL_TESTS
+
+/*******************************************************************************
+ * Helpers
+ ******************************************************************************/
+static std::map<std::string, csci3081::pool_stats> StatsByName() {
+  std::map<std::string, csci3081::pool_stats> stats;
+  for (auto &pool : csci3081::GetPoolStats()) {
+    stats[pool.name] = pool;
+  }
+  return stats;
+}
+
+/*******************************************************************************
+ * Test Cases
+ ******************************************************************************/
+TEST(ObjectPoolTest, FreedObjectsAreReused) {
+  csci3081::ObjectPool pool("Test", 24, 4);
+  void *first = pool.Allocate(24);
+  EXPECT_EQ(pool.get_stats().n_live, 1u);
+  pool.Free(first, 24);
+  EXPECT_EQ(pool.get_stats().n_live, 0u);
+  EXPECT_EQ(pool.Allocate(24), first)
+    << "FAIL: A freed object should be handed out again";
+  pool.Free(first, 24);
+}
+
+TEST(ObjectPoolTest, RebuildingArenasDoesNotGrowMemory) {
+  csci3081::arena_params small;
+  small.n_robots = 5;
+  small.n_lights = 3;
+  small.n_foods = 2;
+  csci3081::arena_params large = small;
+  large.n_robots = 10;
+  large.n_lights = 6;
+  large.n_foods = 4;
+
+  // Build the largest Arena once, so every pool has grown as far as it will.
+  delete new csci3081::Arena(&large);
+  auto baseline = StatsByName();
+  for (auto name : {"Robot", "Light", "Food", "Sensor", "SensorTouch"}) {
+    ASSERT_EQ(baseline.count(name), 1u) << "FAIL: No pool for " << name;
+  }
+
+  // Alternate sizes like the viewer's sliders do through ChangeArena(), and
+  // Reset each Arena a few times along the way.
+  for (int cycle = 0; cycle < 10; ++cycle) {
+    auto *arena = new csci3081::Arena(cycle % 2 ? &large : &small);
+    for (int reset = 0; reset < 3; ++reset) {
+      arena->Reset();
+      arena->UpdateEntitiesTimestep();
+    }
+    auto live = StatsByName();
+    EXPECT_EQ(live["Robot"].n_live - baseline["Robot"].n_live,
+              static_cast<size_t>(arena->get_params().n_robots));
+    // Four sensors per robot, a touch sensor per robot and light.
+    EXPECT_EQ(live["Sensor"].n_live - baseline["Sensor"].n_live,
+              4u * arena->get_params().n_robots);
+    EXPECT_EQ(live["SensorTouch"].n_live - baseline["SensorTouch"].n_live,
+              static_cast<size_t>(arena->get_params().n_robots +
+                                  arena->get_params().n_lights));
+    delete arena;
+  }
+
+  auto after = StatsByName();
+  for (auto &pool : baseline) {
+    EXPECT_EQ(after[pool.first].n_live, pool.second.n_live)
+      << "FAIL: " << pool.first << " objects leaked";
+    EXPECT_EQ(after[pool.first].n_reserved_bytes,
+              pool.second.n_reserved_bytes)
+      << "FAIL: The " << pool.first << " pool grew";
+  }
+}
+
+#endif /* OBJECT_POOL_TESTS */
@@ -0,0 +1,70 @@
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <gtest/gtest.h>
+#include "src/arena.h"
+#include "src/arena_params.h"
+#include "src/perf_counters.h"
+#include "src/step_profiler.h"
+
+#ifdef PERF_COUNTERS_TESTS
+
+/*******************************************************************************
+ * Test Cases
+ ******************************************************************************/
+// Counters are often unavailable (containers, VMs, perf_event_paranoid), so
+// each test checks the clean fallback when they are.
+TEST(PerfCountersTest, CountsOrFallsBack) {
+  csci3081::PerfCounters counters;
+  uint64_t before[csci3081::kNumPerfEvents];
+  uint64_t after[csci3081::kNumPerfEvents];
+  if (!counters.is_available()) {
+    EXPECT_FALSE(counters.get_error().empty());
+    EXPECT_FALSE(counters.Read(before));
+    for (uint64_t value : before) {
+      EXPECT_EQ(value, 0u);
+    }
+    return;
+  }
+  ASSERT_TRUE(counters.Read(before));
+  volatile double sum = 0.0;
+  for (int i = 0; i < 1000000; ++i) {
+    sum = sum + i * 0.5;
+  }
+  ASSERT_TRUE(counters.Read(after));
+  for (int event = 0; event < csci3081::kNumPerfEvents; ++event) {
+    EXPECT_GE(after[event], before[event]) << "FAIL: "
+      << csci3081::PerfCounters::EventName(
+           static_cast<csci3081::PerfEvent>(event));
+  }
+  if (counters.is_counted(csci3081::kPerfInstructions)) {
+    EXPECT_GT(after[csci3081::kPerfInstructions] -
+              before[csci3081::kPerfInstructions], 1000000u);
+  }
+}
+
+TEST(PerfCountersTest, ArenaStepsWithOrWithoutCounters) {
+  csci3081::arena_params params;
+  csci3081::Arena arena(&params);
+  EXPECT_FALSE(arena.GetStepCounters().available);
+  bool available = arena.EnableStepCounters();
+  for (int i = 0; i < 10; ++i) {
+    arena.UpdateEntitiesTimestep();
+  }
+  EXPECT_EQ(arena.GetStepStats().n_steps, 10u);
+  csci3081::step_counters counters = arena.GetStepCounters();
+  EXPECT_EQ(counters.available, available);
+  if (!available) {
+    EXPECT_FALSE(counters.error.empty());
+    EXPECT_EQ(counters.n_steps, 0u);
+    return;
+  }
+  EXPECT_EQ(counters.n_steps, 10u);
+  for (int event = 0; event < csci3081::kNumPerfEvents; ++event) {
+    if (counters.counted[event] && event != csci3081::kPerfLlcMisses) {
+      EXPECT_GT(counters.phase_counts[csci3081::kPhaseSensing][event], 0u);
+    }
+  }
+}
+
+#endif /* PERF_COUNTERS_TESTS */
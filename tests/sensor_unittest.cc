@@ -13,6 +13,8 @@
 #include "src/params.h"
 #include "src/sensor.h"
 #include "src/communication.h"
+#include "src/emitter_grid.h"
+#include "src/entity_store.h"
 
 #ifdef SENSOR_TESTS
 
@@ -257,4 +259,47 @@ TEST_F(SensorTest, TwoLightImpulse) {
   }
 } 
 
+
+TEST_F(SensorTest, CutoffStaysWithinErrorBound) {
+  entities.clear();
+  for (int i = 0; i < 60; i++) {
+    csci3081::Light * light = new csci3081::Light();
+    light->set_position(20.0 * (i % 10), 40.0 * (i / 10));
+    entities.push_back(light);
+  }
+  csci3081::EntityStore store;
+  store.Build(entities);
+  // 60 lights of intensity 1200 beyond `cutoff` add at most this much.
+  double cutoff = 150.0;
+  double bound = 60 * 1200.0 / pow(1.08, cutoff);
+  csci3081::EmitterGrid grid;
+  grid.Build(store, store.lights(), cutoff);
+  for (auto &sensor : sensors) {
+    if (sensor->get_receiver_type() != csci3081::kLight) { continue; }
+    sensor->ReceiveInfo(store);
+    double exact = sensor->get_impulse();
+    sensor->ReceiveInfo(store, grid, cutoff);
+    EXPECT_LE(sensor->get_impulse(), exact);
+    EXPECT_GE(sensor->get_impulse(), exact - bound)
+      << "FAIL: Cut-off dropped more than the error bound";
+  }
+}
+
+TEST_F(SensorTest, ArenaReportsSensingErrorBound) {
+  csci3081::arena_params params;
+  params.x_dim = 4000;
+  params.y_dim = 4000;
+  params.sensing_error = 1e-6;
+  csci3081::Arena arena(&params);
+  arena.UpdateEntitiesTimestep();
+  EXPECT_GT(arena.get_sensing_cutoff(csci3081::kLight), 0.0);
+  EXPECT_LE(arena.get_sensing_error_bound(), 1e-6 * (1 + 1e-9));
+
+  params.sensing_error = 0.0;
+  csci3081::Arena exact(&params);
+  exact.UpdateEntitiesTimestep();
+  EXPECT_EQ(exact.get_sensing_cutoff(csci3081::kLight), 0.0);
+  EXPECT_EQ(exact.get_sensing_error_bound(), 0.0);
+}
+
 #endif /* SENSOR_TESTS */
@@ -0,0 +1,110 @@
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <gtest/gtest.h>
+#include "src/arena.h"
+#include "src/arena_params.h"
+#include "src/light.h"
+#include "src/params.h"
+#include "src/robot.h"
+#include "src/sim_clock.h"
+
+#ifdef SIM_CLOCK_TESTS
+
+
+class SimClockTest : public ::testing::Test {
+
+  protected:
+
+  virtual void SetUp() {
+    robot = new csci3081::Robot();
+    robot->set_clock(&clock);
+    light = new csci3081::Light();
+    light->set_clock(&clock);
+  }
+
+  virtual void TearDown() {
+    delete robot;
+    delete light;
+  }
+
+  /* Advance the clock to `seconds` of simulated time and update the robot at
+   * each timestep.
+   */
+  void RunRobotUntil(double seconds) {
+    while (clock.get_ticks() < csci3081::SimClock::ToTicks(seconds)) {
+      clock.Advance();
+      robot->TimestepUpdate(1);
+    }
+  }
+
+  csci3081::SimClock clock;
+  csci3081::Robot * robot;
+  csci3081::Light * light;
+};
+
+/*******************************************************************************
+ * Test Cases
+ ******************************************************************************/
+
+TEST_F(SimClockTest, TicksToSeconds) {
+  EXPECT_EQ(csci3081::SimClock::ToTicks(1.0),
+            static_cast<uint64_t>(1.0 / TIMESTEP_SECONDS));
+  clock.Advance(20);
+  EXPECT_DOUBLE_EQ(clock.get_seconds(), 20 * TIMESTEP_SECONDS);
+  clock.Reset();
+  EXPECT_EQ(clock.get_ticks(), 0u);
+}
+
+TEST_F(SimClockTest, HungerFollowsSimulatedTime) {
+  RunRobotUntil(ROBOT_HUNGRY_TIME - 1);
+  EXPECT_EQ(robot->is_hungry(), 0)
+    << "FAIL: Robot got hungry before the simulated threshold";
+  RunRobotUntil(ROBOT_HUNGRY_TIME);
+  EXPECT_EQ(robot->is_hungry(), 1)
+    << "FAIL: Robot is not hungry at the simulated threshold";
+  RunRobotUntil(ROBOT_VERY_HUNGRY_TIME);
+  EXPECT_EQ(robot->is_hungry(), 2);
+  EXPECT_FALSE(robot->is_starved());
+  RunRobotUntil(ROBOT_STARVE_TIME);
+  EXPECT_TRUE(robot->is_starved())
+    << "FAIL: Robot did not starve at the simulated threshold";
+}
+
+TEST_F(SimClockTest, EatingRestartsHungerTimer) {
+  RunRobotUntil(ROBOT_HUNGRY_TIME);
+  robot->HandleCollision(csci3081::kFood);
+  EXPECT_EQ(robot->is_hungry(), 0);
+  EXPECT_EQ(robot->get_food_time(), clock.get_ticks());
+}
+
+TEST_F(SimClockTest, LightRetreatLastsFixedSteps) {
+  light->HandleCollision(csci3081::kLight);
+  uint64_t steps = csci3081::SimClock::ToTicks(LIGHT_RETREAT_TIME);
+  for (uint64_t i = 1; i < steps; i++) {
+    clock.Advance();
+    light->TimestepUpdate(1);
+    EXPECT_TRUE(light->get_march_direction())
+      << "FAIL: Light stopped retreating early";
+  }
+  clock.Advance();
+  light->TimestepUpdate(1);
+  EXPECT_FALSE(light->get_march_direction())
+    << "FAIL: Light is still retreating after its retreat time";
+}
+
+TEST_F(SimClockTest, ArenaOwnsClock) {
+  csci3081::arena_params params;
+  csci3081::Arena arena(&params);
+  for (int i = 0; i < 10; i++) {
+    arena.UpdateEntitiesTimestep();
+  }
+  EXPECT_EQ(arena.get_clock().get_ticks(), 10u);
+  for (auto &robot : arena.get_robots()) {
+    EXPECT_EQ(robot->get_clock(), &arena.get_clock());
+  }
+  arena.Reset();
+  EXPECT_EQ(arena.get_clock().get_ticks(), 0u);
+}
+
+#endif /* SIM_CLOCK_TESTS */
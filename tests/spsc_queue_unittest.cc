@@ -0,0 +1,88 @@
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <gtest/gtest.h>
+#include <thread>
+#include "src/arena.h"
+#include "src/arena_params.h"
+#include "src/spsc_queue.h"
+
+#ifdef SPSC_QUEUE_TESTS
+
+/*******************************************************************************
+ * Test Cases
+ ******************************************************************************/
+TEST(SpscQueueTest, FifoAndBounded) {
+  csci3081::SpscQueue<int> queue(3);
+  ASSERT_EQ(queue.get_capacity(), 4u);
+  for (int i = 0; i < 4; ++i) {
+    EXPECT_TRUE(queue.TryPush(i));
+  }
+  EXPECT_FALSE(queue.TryPush(4)) << "FAIL: Pushed onto a full queue";
+  int item = -1;
+  for (int i = 0; i < 4; ++i) {
+    ASSERT_TRUE(queue.TryPop(&item));
+    EXPECT_EQ(item, i);
+  }
+  EXPECT_FALSE(queue.TryPop(&item));
+  EXPECT_TRUE(queue.empty());
+}
+
+TEST(SpscQueueTest, ConcurrentProducerAndConsumer) {
+  csci3081::SpscQueue<int> queue(64);
+  const int n_items = 200000;
+  std::thread producer([&queue, n_items] {
+      for (int i = 0; i < n_items; ++i) {
+        while (!queue.TryPush(i)) {
+          std::this_thread::yield();
+        }
+      }
+    });
+  int expected = 0;
+  while (expected < n_items) {
+    int item;
+    if (queue.TryPop(&item)) {
+      ASSERT_EQ(item, expected) << "FAIL: Items out of order";
+      ++expected;
+    }
+  }
+  producer.join();
+}
+
+TEST(SpscQueueTest, ArenaAppliesCommandBatches) {
+  csci3081::arena_params params;
+  params.seed = 2;
+  csci3081::Arena arena(&params);
+  EXPECT_TRUE(arena.PostCommand(csci3081::kSetLightIntensity, 300.0));
+  EXPECT_TRUE(arena.PostCommand(csci3081::kSetFERatio, 0.5));
+  EXPECT_TRUE(arena.PostCommand(csci3081::kSetLightIntensity, 600.0));
+  EXPECT_TRUE(arena.PostCommand(csci3081::kNoFood));
+  EXPECT_EQ(arena.ApplyCommands(), 4u);
+  EXPECT_EQ(arena.ApplyCommands(), 0u);
+
+  EXPECT_FLOAT_EQ(arena.get_f_e_ratio(), 0.5f);
+  for (auto &ent : arena.get_entities()) {
+    if (ent->get_type() == csci3081::kLight) {
+      EXPECT_EQ(ent->get_intensity(), 600.0)
+        << "FAIL: The last intensity of the batch should win";
+    }
+  }
+  for (auto &robot : arena.get_robots()) {
+    EXPECT_FALSE(robot->food_exists_);
+  }
+
+  // Commands also apply at the start of a timestep.
+  arena.PostCommand(csci3081::kYesFood);
+  arena.UpdateEntitiesTimestep();
+  for (auto &robot : arena.get_robots()) {
+    EXPECT_TRUE(robot->food_exists_);
+  }
+
+  for (int i = 0; i < COMMAND_QUEUE_CAPACITY; ++i) {
+    EXPECT_TRUE(arena.PostCommand(csci3081::kNone));
+  }
+  EXPECT_FALSE(arena.PostCommand(csci3081::kNone))
+    << "FAIL: A full queue should drop commands rather than block";
+}
+
+#endif /* SPSC_QUEUE_TESTS */
@@ -0,0 +1,55 @@
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <gtest/gtest.h>
+#include "src/arena.h"
+#include "src/arena_params.h"
+#include "src/step_accumulator.h"
+
+#ifdef STEP_ACCUMULATOR_TESTS
+
+/*******************************************************************************
+ * Test Cases
+ ******************************************************************************/
+TEST(StepAccumulatorTest, SpeedDoesNotDependOnFrameRate) {
+  // Two simulated seconds at 1x, as 30 fps and as 144 fps frames.
+  for (int fps : {30, 144}) {
+    csci3081::StepAccumulator accumulator;
+    unsigned int steps = 0;
+    for (int frame = 0; frame < 2 * fps; ++frame) {
+      steps += accumulator.AddFrame(1.0 / fps);
+    }
+    EXPECT_EQ(steps, 40u) << "FAIL: Wrong # of steps at " << fps << " fps";
+  }
+}
+
+TEST(StepAccumulatorTest, TimeScaleAndBudget) {
+  csci3081::StepAccumulator accumulator(50);
+  accumulator.set_time_scale(10.0);
+  EXPECT_EQ(accumulator.AddFrame(0.1), 20u);
+
+  // A one second stall at 10x owes 200 steps: one budget now, one more
+  // carried into the next frame, and the rest dropped.
+  EXPECT_EQ(accumulator.AddFrame(1.0), 50u);
+  EXPECT_EQ(accumulator.get_dropped_steps(), 100u);
+  EXPECT_EQ(accumulator.AddFrame(0.0), 0u);
+  EXPECT_EQ(accumulator.AddFrame(0.005), 50u);
+
+  accumulator.set_time_scale(csci3081::StepAccumulator::kMaxTimeScale);
+  EXPECT_EQ(accumulator.AddFrame(0.001), 50u)
+    << "FAIL: Max speed should run the whole budget every frame";
+}
+
+TEST(StepAccumulatorTest, StepNRunsUntilLost) {
+  csci3081::arena_params params;
+  params.seed = 5;
+  csci3081::Arena arena(&params);
+  EXPECT_EQ(arena.StepN(25), 25u);
+  EXPECT_EQ(arena.get_clock().get_ticks(), 25u);
+
+  arena.set_game_status(LOST);
+  EXPECT_EQ(arena.StepN(10), 0u)
+    << "FAIL: StepN should not step a lost game";
+}
+
+#endif /* STEP_ACCUMULATOR_TESTS */
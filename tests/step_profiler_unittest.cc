@@ -0,0 +1,62 @@
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <gtest/gtest.h>
+#include "src/arena.h"
+#include "src/arena_params.h"
+#include "src/step_profiler.h"
+
+#ifdef STEP_PROFILER_TESTS
+
+/*******************************************************************************
+ * Test Cases
+ ******************************************************************************/
+TEST(StepProfilerTest, RollingWindowKeepsNewestValues) {
+  csci3081::RollingWindow window;
+  EXPECT_DOUBLE_EQ(window.get_mean(), 0.0);
+  size_t n_values = csci3081::RollingWindow::kCapacity + 10;
+  for (size_t i = 0; i < n_values; ++i) {
+    window.Add(static_cast<double>(i));
+  }
+  EXPECT_EQ(window.get_n(), csci3081::RollingWindow::kCapacity);
+  EXPECT_DOUBLE_EQ(window.get_oldest(), 10.0);
+  EXPECT_DOUBLE_EQ(window.get_newest(), n_values - 1.0);
+  EXPECT_DOUBLE_EQ(window.get_max(), n_values - 1.0);
+  EXPECT_DOUBLE_EQ(window.get_mean(), (10.0 + n_values - 1.0) / 2);
+}
+
+TEST(StepProfilerTest, PhasesSumToStep) {
+  csci3081::StepProfiler profiler;
+  profiler.AddPhase(csci3081::kPhaseSensing, 0.002);
+  profiler.AddPhase(csci3081::kPhaseSensing, 0.001);
+  profiler.AddPhase(csci3081::kPhaseCollisions, 0.004);
+  profiler.EndStep(0.008, 1.0);
+  profiler.EndStep(0.002, 1.5);
+  csci3081::step_stats stats = profiler.GetStats();
+  EXPECT_EQ(stats.n_steps, 2u);
+  EXPECT_DOUBLE_EQ(stats.phase_max_ms[csci3081::kPhaseSensing], 3.0);
+  EXPECT_DOUBLE_EQ(stats.phase_mean_ms[csci3081::kPhaseSensing], 1.5);
+  EXPECT_DOUBLE_EQ(stats.step_mean_ms, 5.0);
+  EXPECT_DOUBLE_EQ(stats.steps_per_second, 2.0);
+}
+
+TEST(StepProfilerTest, ArenaReportsEachPhase) {
+  csci3081::arena_params params;
+  params.seed = 4;
+  csci3081::Arena arena(&params);
+  for (int i = 0; i < 20; ++i) {
+    arena.UpdateEntitiesTimestep();
+  }
+  csci3081::step_stats stats = arena.GetStepStats();
+  EXPECT_EQ(stats.n_steps, 20u);
+  double phases_ms = 0.0;
+  for (int phase = 0; phase < csci3081::kNumStepPhases; ++phase) {
+    EXPECT_GE(stats.phase_mean_ms[phase], 0.0);
+    phases_ms += stats.phase_mean_ms[phase];
+  }
+  EXPECT_GT(stats.phase_mean_ms[csci3081::kPhaseSensing], 0.0);
+  EXPECT_GT(stats.step_mean_ms, 0.0);
+  EXPECT_LE(phases_ms, stats.step_mean_ms * 1.0001);
+}
+
+#endif /* STEP_PROFILER_TESTS */
@@ -0,0 +1,95 @@
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <gtest/gtest.h>
+#include <atomic>
+#include <vector>
+#include "src/arena.h"
+#include "src/arena_params.h"
+#include "src/thread_pool.h"
+
+#ifdef THREAD_POOL_TESTS
+
+/*******************************************************************************
+ * Helpers
+ ******************************************************************************/
+/* Make `copy` start from exactly the same state as `original`. Only the
+ * poses and radii are random at creation.
+ */
+static void CopyEntities(csci3081::Arena *original, csci3081::Arena *copy) {
+  std::vector<csci3081::ArenaEntity *> from = original->get_entities();
+  std::vector<csci3081::ArenaEntity *> to = copy->get_entities();
+  ASSERT_EQ(from.size(), to.size());
+  for (size_t i = 0; i < from.size(); i++) {
+    ASSERT_EQ(from[i]->get_type(), to[i]->get_type());
+    to[i]->set_pose(from[i]->get_pose());
+    to[i]->set_radius(from[i]->get_radius());
+  }
+}
+
+/*******************************************************************************
+ * Test Cases
+ ******************************************************************************/
+TEST(ThreadPoolTest, ParallelForCoversEveryItemOnce) {
+  for (int n_threads : {1, 2, 3, 8}) {
+    csci3081::ThreadPool pool(n_threads);
+    EXPECT_EQ(pool.get_n_threads(), n_threads);
+    for (size_t n : {0, 1, 7, 1000}) {
+      std::vector<std::atomic<int>> hits(n);
+      pool.ParallelFor(n, [&](size_t begin, size_t end) {
+          for (size_t i = begin; i < end; i++) {
+            hits[i]++;
+          }
+        });
+      for (size_t i = 0; i < n; i++) {
+        EXPECT_EQ(hits[i], 1) << "FAIL: Item " << i << " with "
+                              << n_threads << " threads";
+      }
+    }
+  }
+}
+
+TEST(ThreadPoolTest, NonPositiveCountRunsInline) {
+  csci3081::ThreadPool pool(0);
+  EXPECT_EQ(pool.get_n_threads(), 1);
+}
+
+TEST(ThreadPoolTest, ArenaMatchesSerialForAnyThreadCount) {
+  for (auto type : {csci3081::kBruteForce, csci3081::kSpatialHash}) {
+    csci3081::arena_params params;
+    params.broad_phase = type;
+    params.n_robots = 20;
+    params.n_lights = 8;
+    csci3081::Arena serial(&params);
+    std::vector<csci3081::Arena *> threaded;
+    for (int n_threads : {2, 3, 8}) {
+      params.n_threads = n_threads;
+      threaded.push_back(new csci3081::Arena(&params));
+      CopyEntities(&serial, threaded.back());
+    }
+
+    for (int step = 0; step < 300; step++) {
+      serial.UpdateEntitiesTimestep();
+      for (auto arena : threaded) {
+        arena->UpdateEntitiesTimestep();
+      }
+    }
+
+    std::vector<csci3081::ArenaEntity *> expected = serial.get_entities();
+    for (auto arena : threaded) {
+      std::vector<csci3081::ArenaEntity *> actual = arena->get_entities();
+      for (size_t i = 0; i < expected.size(); i++) {
+        EXPECT_EQ(actual[i]->get_pose().x, expected[i]->get_pose().x)
+          << "FAIL: Entity " << i << " drifted with "
+          << arena->get_n_threads() << " threads";
+        EXPECT_EQ(actual[i]->get_pose().y, expected[i]->get_pose().y);
+        EXPECT_EQ(actual[i]->get_pose().theta,
+                  expected[i]->get_pose().theta);
+      }
+      EXPECT_EQ(arena->get_game_status(), serial.get_game_status());
+      delete arena;
+    }
+  }
+}
+
+#endif /* THREAD_POOL_TESTS */
@@ -0,0 +1,96 @@
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "src/arena.h"
+#include "src/arena_params.h"
+#include "src/tracer.h"
+
+#ifdef TRACER_TESTS
+
+/*******************************************************************************
+ * Non-Member Functions
+ ******************************************************************************/
+static std::vector<std::string> ReadLines(const std::string &path) {
+  std::ifstream in(path);
+  std::vector<std::string> lines;
+  std::string line;
+  while (std::getline(in, line)) {
+    lines.push_back(line);
+  }
+  return lines;
+}
+
+static bool Contains(const std::vector<std::string> &lines,
+                     const std::string &text) {
+  for (auto &line : lines) {
+    if (line.find(text) != std::string::npos) {
+      return true;
+    }
+  }
+  return false;
+}
+
+/*******************************************************************************
+ * Test Cases
+ ******************************************************************************/
+TEST(TracerTest, DisabledRecordsNothing) {
+  ASSERT_FALSE(csci3081::Tracer::IsEnabled());
+  uint64_t before = csci3081::Tracer::get_n_events();
+  {
+    csci3081::ScopedTrace trace("idle", "test");
+  }
+  csci3081::arena_params params;
+  csci3081::Arena arena(&params);
+  arena.UpdateEntitiesTimestep();
+  EXPECT_EQ(csci3081::Tracer::get_n_events(), before);
+}
+
+TEST(TracerTest, WritesStepPhasesAndWorkers) {
+  std::string path = testing::TempDir() + "tracer_unittest.json";
+  ASSERT_TRUE(csci3081::Tracer::Start(path));
+  EXPECT_TRUE(csci3081::Tracer::IsEnabled());
+  EXPECT_FALSE(csci3081::Tracer::Start(path)) << "FAIL: started twice";
+  {
+    csci3081::arena_params params;
+    params.n_threads = 2;
+    csci3081::Arena arena(&params);
+    for (int i = 0; i < 10; ++i) {
+      arena.UpdateEntitiesTimestep();
+    }
+  }
+  csci3081::Tracer::Stop();
+  EXPECT_FALSE(csci3081::Tracer::IsEnabled());
+  // One step and six phases per step, and at least one pool chunk.
+  EXPECT_GT(csci3081::Tracer::get_n_events(), 70u);
+
+  std::vector<std::string> lines = ReadLines(path);
+  ASSERT_GT(lines.size(), 3u);
+  EXPECT_EQ(lines.front(), "{\"traceEvents\":[");
+  EXPECT_EQ(lines.back(), "]}");
+  // One event per line, each but the last followed by a comma.
+  for (size_t i = 1; i + 1 < lines.size(); ++i) {
+    const std::string &line = lines[i];
+    std::string tail = (i + 2 < lines.size()) ? "}," : "}";
+    ASSERT_EQ(line.front(), '{') << "FAIL: line " << i;
+    ASSERT_EQ(line.substr(line.size() - tail.size()), tail)
+      << "FAIL: line " << i;
+  }
+  EXPECT_TRUE(Contains(lines, "\"name\":\"sensing\",\"cat\":\"step\""));
+  EXPECT_TRUE(Contains(lines, "\"name\":\"step\",\"cat\":\"step\""));
+  EXPECT_TRUE(Contains(lines, "\"name\":\"chunk\",\"cat\":\"pool\""));
+  EXPECT_TRUE(Contains(lines, "\"args\":{\"name\":\"pool worker\"}"));
+  std::remove(path.c_str());
+}
+
+TEST(TracerTest, StopWithoutStartIsHarmless) {
+  csci3081::Tracer::Stop();
+  EXPECT_FALSE(csci3081::Tracer::IsEnabled());
+}
+
+#endif /* TRACER_TESTS */
@@ -0,0 +1,212 @@
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <gtest/gtest.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "src/arena.h"
+#include "src/arena_params.h"
+#include "src/light.h"
+#include "src/robot.h"
+#include "src/trajectory_reader.h"
+#include "src/trajectory_recorder.h"
+
+#ifdef TRAJECTORY_TESTS
+
+/*******************************************************************************
+ * Non-Member Functions
+ ******************************************************************************/
+static std::string TestPath(const char *name) {
+  return "/tmp/trajectory_unittest_" + std::to_string(getpid()) + "_" + name;
+}
+
+static double Quantised(double value, double scale) {
+  return static_cast<double>(csci3081::Quantise(value, scale)) / scale;
+}
+
+/* What the reader should return for the current state of `arena`. */
+static csci3081::trajectory_frame Expected(const csci3081::Arena &arena) {
+  csci3081::trajectory_frame frame;
+  frame.tick = arena.get_clock().get_ticks();
+  for (auto &ent : arena.get_mobile_entities()) {
+    csci3081::trajectory_sample sample = {};
+    bool robot = ent->get_type() == csci3081::kRobot;
+    csci3081::WheelVelocity velocity = robot ?
+      static_cast<csci3081::Robot *>(ent)->get_motion_handler().get_velocity() :
+      static_cast<csci3081::Light *>(ent)->get_motion_handler().get_velocity();
+    sample.x = Quantised(ent->get_pose().x, csci3081::kPositionScale);
+    sample.y = Quantised(ent->get_pose().y, csci3081::kPositionScale);
+    sample.theta = Quantised(ent->get_pose().theta, csci3081::kAngleScale);
+    sample.velocity_left = Quantised(velocity.left, csci3081::kVelocityScale);
+    sample.velocity_right = Quantised(velocity.right,
+                                      csci3081::kVelocityScale);
+    if (robot) {
+      auto *r = static_cast<csci3081::Robot *>(ent);
+      sample.hungry = r->is_hungry() != 0;
+      sample.starved = r->is_starved();
+    }
+    frame.samples.push_back(sample);
+  }
+  for (auto &event : arena.get_collision_events()) {
+    frame.collisions.push_back({{event.self_type, event.self_id},
+                                {event.other_type, event.other_id}});
+  }
+  return frame;
+}
+
+static void ExpectSameFrame(const csci3081::trajectory_frame &expected,
+                            const csci3081::trajectory_frame &actual) {
+  EXPECT_EQ(expected.tick, actual.tick);
+  ASSERT_EQ(expected.samples.size(), actual.samples.size());
+  for (size_t i = 0; i < expected.samples.size(); ++i) {
+    const csci3081::trajectory_sample &e = expected.samples[i];
+    const csci3081::trajectory_sample &a = actual.samples[i];
+    EXPECT_DOUBLE_EQ(e.x, a.x);
+    EXPECT_DOUBLE_EQ(e.y, a.y);
+    EXPECT_DOUBLE_EQ(e.theta, a.theta);
+    EXPECT_DOUBLE_EQ(e.velocity_left, a.velocity_left);
+    EXPECT_DOUBLE_EQ(e.velocity_right, a.velocity_right);
+    EXPECT_EQ(e.hungry, a.hungry);
+    EXPECT_EQ(e.starved, a.starved);
+  }
+  ASSERT_EQ(expected.collisions.size(), actual.collisions.size());
+  for (size_t i = 0; i < expected.collisions.size(); ++i) {
+    EXPECT_EQ(expected.collisions[i].self.type,
+              actual.collisions[i].self.type);
+    EXPECT_EQ(expected.collisions[i].self.id, actual.collisions[i].self.id);
+    EXPECT_EQ(expected.collisions[i].other.type,
+              actual.collisions[i].other.type);
+    EXPECT_EQ(expected.collisions[i].other.id,
+              actual.collisions[i].other.id);
+  }
+}
+
+/* Record `n_steps` of a small, crowded arena to `path`. */
+static std::vector<csci3081::trajectory_frame> RecordRun(
+    const std::string &path, int n_steps) {
+  csci3081::arena_params params;
+  params.n_robots = 40;
+  params.n_lights = 6;
+  params.n_foods = 8;
+  params.x_dim = 400;
+  params.y_dim = 300;
+  params.seed = 5;
+  csci3081::Arena arena(&params);
+  csci3081::TrajectoryRecorder recorder(path);
+  EXPECT_TRUE(recorder.Open(&arena)) << recorder.get_error();
+  std::vector<csci3081::trajectory_frame> expected;
+  for (int i = 0; i < n_steps; ++i) {
+    arena.UpdateEntitiesTimestep();
+    recorder.Record(arena);
+    expected.push_back(Expected(arena));
+  }
+  EXPECT_TRUE(recorder.Close()) << recorder.get_error();
+  EXPECT_EQ(recorder.get_n_frames(), static_cast<uint64_t>(n_steps));
+  return expected;
+}
+
+/*******************************************************************************
+ * Test Cases
+ ******************************************************************************/
+TEST(TrajectoryTest, VarintsRoundTrip) {
+  const int64_t values[] = {0, 1, -1, 63, -64, 64, 300, -300,
+                            INT64_MAX, INT64_MIN};
+  std::string bytes;
+  for (int64_t value : values) {
+    csci3081::PutVarint(csci3081::ZigZag(value), &bytes);
+  }
+  EXPECT_EQ(bytes[0], 0);
+  EXPECT_EQ(bytes[1], 2);
+  EXPECT_EQ(bytes[2], 1);
+  const uint8_t *in = reinterpret_cast<const uint8_t *>(bytes.data());
+  const uint8_t *end = in + bytes.size();
+  for (int64_t value : values) {
+    uint64_t encoded;
+    ASSERT_TRUE(csci3081::GetVarint(&in, end, &encoded));
+    EXPECT_EQ(csci3081::UnZigZag(encoded), value);
+  }
+  uint64_t encoded;
+  EXPECT_FALSE(csci3081::GetVarint(&in, end, &encoded));
+}
+
+TEST(TrajectoryTest, ReadsBackRanges) {
+  std::string path = TestPath("ranges");
+  std::vector<csci3081::trajectory_frame> expected = RecordRun(path, 300);
+
+  csci3081::TrajectoryReader reader;
+  ASSERT_TRUE(reader.Open(path)) << reader.get_error();
+  EXPECT_FALSE(reader.is_recovered());
+  EXPECT_EQ(reader.get_n_frames(), 300u);
+  EXPECT_EQ(reader.get_entities().size(), 46u);
+  EXPECT_EQ(reader.get_entities()[0].type, csci3081::kRobot);
+  EXPECT_EQ(reader.get_entities()[45].type, csci3081::kLight);
+
+  size_t n_collisions = 0;
+  std::vector<csci3081::trajectory_frame> frames;
+  ASSERT_TRUE(reader.Read(0, 300, &frames)) << reader.get_error();
+  ASSERT_EQ(frames.size(), 300u);
+  for (size_t i = 0; i < frames.size(); ++i) {
+    ExpectSameFrame(expected[i], frames[i]);
+    n_collisions += frames[i].collisions.size();
+  }
+  EXPECT_GT(n_collisions, 0u);
+
+  // Starting between keyframes, and running past the end.
+  ASSERT_TRUE(reader.Read(130, 20, &frames));
+  ASSERT_EQ(frames.size(), 20u);
+  for (size_t i = 0; i < frames.size(); ++i) {
+    ExpectSameFrame(expected[130 + i], frames[i]);
+  }
+  ASSERT_TRUE(reader.Read(290, 50, &frames));
+  ASSERT_EQ(frames.size(), 10u);
+  ExpectSameFrame(expected[299], frames.back());
+  ASSERT_TRUE(reader.Read(300, 1, &frames));
+  EXPECT_TRUE(frames.empty());
+  std::remove(path.c_str());
+}
+
+TEST(TrajectoryTest, RecoversFileWithoutIndex) {
+  std::string path = TestPath("recover");
+  std::vector<csci3081::trajectory_frame> expected = RecordRun(path, 150);
+
+  // Cut the file in the middle of a frame, as a crash might.
+  std::ifstream in(path, std::ios::binary);
+  std::string contents((std::istreambuf_iterator<char>(in)),
+                       std::istreambuf_iterator<char>());
+  in.close();
+  size_t cut = contents.size() * 3 / 4;
+  std::ofstream(path, std::ios::binary | std::ios::trunc)
+    .write(contents.data(), static_cast<std::streamsize>(cut));
+
+  csci3081::TrajectoryReader reader;
+  ASSERT_TRUE(reader.Open(path)) << reader.get_error();
+  EXPECT_TRUE(reader.is_recovered());
+  EXPECT_GT(reader.get_n_frames(), 100u);
+  EXPECT_LT(reader.get_n_frames(), 150u);
+  std::vector<csci3081::trajectory_frame> frames;
+  uint64_t last = reader.get_n_frames() - 1;
+  ASSERT_TRUE(reader.Read(last, 1, &frames)) << reader.get_error();
+  ASSERT_EQ(frames.size(), 1u);
+  ExpectSameFrame(expected[last], frames[0]);
+  std::remove(path.c_str());
+}
+
+TEST(TrajectoryTest, RejectsOtherFiles) {
+  std::string path = TestPath("other");
+  std::ofstream(path) << "not a trajectory at all, just some text\n";
+  csci3081::TrajectoryReader reader;
+  EXPECT_FALSE(reader.Open(path));
+  EXPECT_NE(reader.get_error().find("not a trajectory"), std::string::npos);
+  std::remove(path.c_str());
+
+  csci3081::TrajectoryReader missing;
+  EXPECT_FALSE(missing.Open(path));
+}
+
+#endif /* TRAJECTORY_TESTS */